@@ -18,9 +18,15 @@
 #include <algorithm>									// find
 #include <cstdio>										// stderr, stdout, perror, fprintf
 #include <cstdlib>										// getenv, exit, mkstemp
+#include <cstring>										// strcpy, strlen
+#include <csignal>										// signal, raise
+#include <climits>										// PATH_MAX
+#include <cstdint>										// int32_t, uint32_t
 using namespace std;
 #include <unistd.h>										// execvp, fork, unlink
-#include <sys/wait.h>									// wait
+#include <sys/wait.h>									// waitpid
+#include <sys/socket.h>									// socket, connect, sendmsg
+#include <sys/un.h>										// sockaddr_un
 #include <fcntl.h>										// creat
 
 
@@ -33,6 +39,7 @@ using namespace std;
 static string compiler_path( CFA_BACKEND_CC );			// C compiler path/name
 static bool CFA_flag = false;							// -CFA flag
 static bool save_temps = false;							// -save-temps flag
+static bool pipe_flag = false;							// -pipe flag
 static string o_file;
 static string bprefix;
 static string lang;										// -x flag
@@ -96,6 +103,8 @@ static void checkEnv2( const char * args[], int & nargs ) { // stage 2
 				CFA_flag = true;
 			} else if ( val == "-save-temps" || val == "--save-temps" ) {
 				save_temps = true;
+			} else if ( val == "-pipe" ) {				// stream cfa-cpp output into gcc
+				pipe_flag = true;
 			} else if ( prefix( val, "-o=" ) ) {		// output file for -CFA
 				o_file = val.substr( 3 );
 			} else if ( prefix( val, "-B=" ) ) {		// location of cfa-cpp
@@ -333,6 +342,121 @@ static void Stage1( const int argc, const char * const argv[] ) {
 } // Stage1
 
 
+// If environment variable CFA_CPP_SERVER names the socket of a running "cfa-cpp --server", have it do the translation
+// and exit with the result, as if cfa-cpp had been run. Returns if there is no server or it rejects the request, and the
+// caller runs cfa-cpp itself. The server half of the protocol is in src/CompilationServer.cpp.
+
+static void cfa_cpp_server( const char * const cargs[] ) {
+	const char * path = getenv( "CFA_CPP_SERVER" );
+	if ( path == nullptr || path[0] == '\0' ) return;
+
+	struct sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if ( strlen( path ) >= sizeof(address.sun_path) ) return;
+	strcpy( address.sun_path, path );
+
+	char cwd[PATH_MAX];
+	if ( getcwd( cwd, sizeof(cwd) ) == nullptr ) return;
+
+	int fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if ( fd == -1 ) return;
+	if ( connect( fd, (struct sockaddr *)&address, sizeof(address) ) == -1 ) { // no server ?
+		close( fd );
+		return;
+	} // if
+
+	// request: size of the rest with the standard streams attached, then working directory and arguments
+	string request( cwd, strlen( cwd ) + 1 );
+	for ( int i = 0; cargs[i] != nullptr; i += 1 ) {
+		request.append( cargs[i], strlen( cargs[i] ) + 1 );
+	} // for
+	uint32_t size = request.size();
+
+	enum { Streams = 3 };
+	const int streams[Streams] = { STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO };
+	union {
+		char buffer[CMSG_SPACE( sizeof(streams) )];
+		struct cmsghdr align;
+	} control;
+	struct iovec data = { &size, sizeof(size) };
+	struct msghdr message = {};
+	message.msg_iov = &data;
+	message.msg_iovlen = 1;
+	message.msg_control = control.buffer;
+	message.msg_controllen = sizeof(control.buffer);
+	struct cmsghdr * header = CMSG_FIRSTHDR( &message );
+	header->cmsg_level = SOL_SOCKET;
+	header->cmsg_type = SCM_RIGHTS;
+	header->cmsg_len = CMSG_LEN( sizeof(streams) );
+	memcpy( CMSG_DATA( header ), streams, sizeof(streams) );
+
+	if ( sendmsg( fd, &message, 0 ) != sizeof(size) || write( fd, request.data(), size ) != (ssize_t)size ) {
+		close( fd );									// nothing translated, run cfa-cpp
+		return;
+	} // if
+
+	// reply: rejected, exited with status, or killed by signal
+	enum { Rejected, Exited, Signalled };
+	int32_t reply[2];
+	size_t got = 0;
+	for ( ssize_t rc; got < sizeof(reply); got += rc ) {
+		rc = read( fd, (char *)reply + got, sizeof(reply) - got );
+		if ( rc <= 0 ) break;
+	} // for
+	close( fd );
+
+	if ( got != sizeof(reply) ) {						// server died while translating
+		cerr << "CC1 Translator error: stage 2, cfa-cpp server " << path << " failed" << endl;
+		exit( EXIT_FAILURE );
+	} // if
+	switch ( reply[0] ) {
+	  case Rejected:
+		return;
+	  case Signalled:
+		signal( reply[1], SIG_DFL );					// die the same way
+		raise( reply[1] );
+		exit( EXIT_FAILURE );
+	  default:
+		exit( reply[1] );
+	} // switch
+} // cfa_cpp_server
+
+
+// Run gcc on the output of cfa-cpp, read from file name input ("-" for standard input). Does not return.
+
+static void cc1_gcc( const char * args[], int nargs, const char * input ) {
+	args[0] = compiler_path.c_str();
+	args[nargs++] = "-S";								// only compile and put assembler output in specified file
+	args[nargs++] = "-x";
+	args[nargs++] = "cpp-output";
+
+	args[nargs++] = input;
+	args[nargs] = nullptr;								// terminate argument list
+
+	#ifdef __DEBUG_H__
+	cerr << "stage2 nargs: " << nargs << endl;
+	for ( int i = 0; args[i] != nullptr; i += 1 ) {
+		cerr << args[i] << " ";
+	} // for
+	cerr << endl;
+	#endif // __DEBUG_H__
+
+	execvp( args[0], (char * const *)args );			// should not return
+	perror( "CC1 Translator error: stage 2 cc1, execvp" );
+	cerr << " invoked " << args[0] << endl;
+	exit( EXIT_FAILURE );								// tell gcc not to go any further
+} // cc1_gcc
+
+
+// Stop a gcc reading from a failed cfa-cpp, so it does not compile a partial program.
+
+static void stop_gcc( pid_t gcc_pid ) {
+	if ( gcc_pid == -1 ) return;						// gcc not started ?
+	kill( gcc_pid, SIGKILL );
+	waitpid( gcc_pid, nullptr, 0 );
+} // stop_gcc
+
+
 static void Stage2( const int argc, const char * const * argv ) {
 	int code;
 	string arg;
@@ -435,9 +559,12 @@ static void Stage2( const int argc, const char * const * argv ) {
 	} // if
 
 	// Create a temporary file, if needed, to store output of the cfa-cpp preprocessor. Cannot be created in forked
-	// process because variables tmpname and tmpfilefd are cloned.
+	// process because variables tmpname and tmpfilefd are cloned. With -pipe, the output goes through a pipe instead,
+	// and gcc runs at the same time as cfa-cpp.
 
 	string cfa_cpp_out;
+	const bool piped = pipe_flag && ! CFA_flag && ! save_temps;
+	int cfa_cpp_pipe[2] = { -1, -1 };
 
 	if ( ! CFA_flag ) {									// run compiler ?
 		if ( save_temps ) {
@@ -453,6 +580,11 @@ static void Stage2( const int argc, const char * const * argv ) {
 				perror( "CC1 Translator error: stage 2, creat" );
 				exit( EXIT_FAILURE );
 			} // if
+		} else if ( piped ) {
+			if ( pipe( cfa_cpp_pipe ) == -1 ) {
+				perror( "CC1 Translator error: stage 2, pipe" );
+				exit( EXIT_FAILURE );
+			} // if
 		} else {
 			tmpfilefd = mkstemps( tmpname, 4 );
 			if ( tmpfilefd == -1 ) {
@@ -469,7 +601,8 @@ static void Stage2( const int argc, const char * const * argv ) {
 	// If -CFA flag specified, run the cfa-cpp preprocessor on the temporary file, and output is written to standard
 	// output.  Otherwise, run the cfa-cpp preprocessor on the temporary file and save the result into the output file.
 
-	if ( fork() == 0 ) {								// child runs CFA preprocessor
+	pid_t cfa_cpp_pid = fork();
+	if ( cfa_cpp_pid == 0 ) {							// child runs CFA preprocessor
 		cargs[0] = ( *new string( bprefix + "cfa-cpp" ) ).c_str();
 		cargs[ncargs++] = cpp_in;
 
@@ -477,6 +610,10 @@ static void Stage2( const int argc, const char * const * argv ) {
 			if ( o_file.size() != 0 ) {					// location for output
 				cargs[ncargs++] = ( *new string( o_file ) ).c_str();
 			} // if
+		} else if ( piped ) {							// output to standard output, which is the pipe
+			dup2( cfa_cpp_pipe[1], STDOUT_FILENO );
+			close( cfa_cpp_pipe[0] );
+			close( cfa_cpp_pipe[1] );
 		} else {
 			cargs[ncargs++] = cfa_cpp_out.c_str();
 		} // if
@@ -492,15 +629,30 @@ static void Stage2( const int argc, const char * const * argv ) {
 		cerr << endl;
 		#endif // __DEBUG_H__
 
+		cfa_cpp_server( cargs );						// return => run cfa-cpp here
 		execvp( cargs[0], (char * const *)cargs );		// should not return
 		perror( "CC1 Translator error: stage 2 cfa-cpp, execvp" );
 		cerr << " invoked " << cargs[0] << endl;
 		exit( EXIT_FAILURE );
 	} // if
 
-	wait( &code );										// wait for child to finish
+	pid_t gcc_pid = -1;
+	if ( piped ) {										// gcc reads the pipe while cfa-cpp writes it
+		gcc_pid = fork();
+		if ( gcc_pid == 0 ) {							// child runs gcc
+			dup2( cfa_cpp_pipe[0], STDIN_FILENO );
+			close( cfa_cpp_pipe[0] );
+			close( cfa_cpp_pipe[1] );
+			cc1_gcc( args, nargs, "-" );
+		} // if
+		close( cfa_cpp_pipe[0] );						// gcc sees end of file when cfa-cpp finishes
+		close( cfa_cpp_pipe[1] );
+	} // if
+
+	waitpid( cfa_cpp_pid, &code, 0 );					// wait for child to finish
 
 	if ( WIFSIGNALED(code) ) {							// child failed ?
+		stop_gcc( gcc_pid );
 		rmtmpfile();									// remove tmpname
 		cerr << "CC1 Translator error: stage 2, child failed " << WTERMSIG(code) << endl;
 		exit( EXIT_FAILURE );
@@ -515,6 +667,7 @@ static void Stage2( const int argc, const char * const * argv ) {
 	#endif // __DEBUG_H__
 
 	if ( WEXITSTATUS(code) ) {							// child error ?
+		stop_gcc( gcc_pid );
 		rmtmpfile();									// remove tmpname
 		exit( WEXITSTATUS( code ) );					// do not continue
 	} // if
@@ -527,30 +680,14 @@ static void Stage2( const int argc, const char * const * argv ) {
 	cerr << " " << cpp_in << endl;
 	#endif // __DEBUG_H__
 
-	if ( fork() == 0 ) {								// child runs gcc
-		args[0] = compiler_path.c_str();
-		args[nargs++] = "-S";							// only compile and put assembler output in specified file
-		args[nargs++] = "-x";
-		args[nargs++] = "cpp-output";
-
-		args[nargs++] = cfa_cpp_out.c_str();
-		args[nargs] = nullptr;							// terminate argument list
-
-		#ifdef __DEBUG_H__
-		cerr << "stage2 nargs: " << nargs << endl;
-		for ( int i = 0; args[i] != nullptr; i += 1 ) {
-			cerr << args[i] << " ";
-		} // for
-		cerr << endl;
-		#endif // __DEBUG_H__
-
-		execvp( args[0], (char * const *)args );		// should not return
-		perror( "CC1 Translator error: stage 2 cc1, execvp" );
-		cerr << " invoked " << args[0] << endl;
-		exit( EXIT_FAILURE );							// tell gcc not to go any further
+	if ( ! piped ) {									// gcc reads the finished file
+		gcc_pid = fork();
+		if ( gcc_pid == 0 ) {							// child runs gcc
+			cc1_gcc( args, nargs, cfa_cpp_out.c_str() );
+		} // if
 	} // if
 
-	wait( &code );										// wait for child to finish
+	waitpid( gcc_pid, &code, 0 );						// wait for child to finish
 	rmtmpfile();										// remove tmpname
 
 	if ( WIFSIGNALED(code) ) {							// child failed ?
@@ -240,6 +240,9 @@ int main( int argc, char * argv[] ) {
 			} else if ( arg == "-save-temps" || arg == "--save-temps" ) {
 				args[nargs++] = argv[i];				// pass flag along
 				Putenv( argv, arg );					// save cfa-cpp output
+			} else if ( arg == "-pipe" ) {
+				args[nargs++] = argv[i];				// pass flag along
+				Putenv( argv, arg );					// stream cfa-cpp output into gcc
 			} else if ( prefix( arg, "-x" ) ) {			// file suffix ?
 				string lang;
 				args[nargs++] = argv[i];				// pass flag along
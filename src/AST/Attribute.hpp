@@ -33,7 +33,7 @@ public:
 	std::vector<ptr<Expr>> params;
 
 	Attribute( const std::string & name = "", std::vector<ptr<Expr>> && params = {})
-		: name( name ), params( params ) {}
+		: Node( NodeKind::Attribute ), name( name ), params( params ) {}
 	virtual ~Attribute() = default;
 
 	bool empty() const { return name.empty(); }
@@ -53,7 +53,7 @@ FunctionDecl::FunctionDecl( const CodeLocation & location, const std::string & n
 	std::vector<ptr<DeclWithType>>&& params, std::vector<ptr<DeclWithType>>&& returns,
 	CompoundStmt * stmts, Storage::Classes storage, Linkage::Spec linkage,
 	std::vector<ptr<Attribute>>&& attrs, Function::Specs fs, ArgumentFlag isVarArgs )
-: DeclWithType( location, name, storage, linkage, std::move(attrs), fs ),
+: DeclWithType( NodeKind::FunctionDecl, location, name, storage, linkage, std::move(attrs), fs ),
 		type_params( std::move( forall) ), assertions( std::move( assertions ) ),
 		params( std::move(params) ), returns( std::move(returns) ),
 		type( nullptr ), stmts( stmts ) {
@@ -78,6 +78,7 @@ FunctionDecl::FunctionDecl( const CodeLocation & location, const std::string & n
 const Type * FunctionDecl::get_type() const { return type.get(); }
 void FunctionDecl::set_type( const Type * t ) {
 	type = strict_dynamic_cast< const FunctionType * >( t );
+	clearMangleCache();
 }
 
 // --- TypeDecl
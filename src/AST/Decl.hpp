@@ -45,9 +45,9 @@ public:
 	UniqueId uniqueId = 0;
 	bool extension = false;
 
-	Decl( const CodeLocation& loc, const std::string& name, Storage::Classes storage,
+	Decl( NodeKind nodeKind, const CodeLocation& loc, const std::string& name, Storage::Classes storage,
 		Linkage::Spec linkage )
-	: ParseNode( loc ), name( name ), storage( storage ), linkage( linkage ) {}
+	: ParseNode( nodeKind, loc ), name( name ), storage( storage ), linkage( linkage ) {}
 
 	/// Ensures this node has a unique ID
 	void fixUniqueId();
@@ -74,13 +74,34 @@ public:
 	bool isTypeFixed = false;
 	bool isHidden = false;
 
-	DeclWithType( const CodeLocation& loc, const std::string& name, Storage::Classes storage,
+	DeclWithType( NodeKind nodeKind, const CodeLocation& loc, const std::string& name, Storage::Classes storage,
 		Linkage::Spec linkage, std::vector<ptr<Attribute>>&& attrs, Function::Specs fs )
-	: Decl( loc, name, storage, linkage ), mangleName(), attributes( std::move(attrs) ),
+	: Decl( nodeKind, loc, name, storage, linkage ), mangleName(), attributes( std::move(attrs) ),
 		funcSpec(fs), asmName() {}
 
 	std::string scopedMangleName() const { return mangleName + "_" + std::to_string(scopeLevel); }
 
+	/// Mangled names kept by Mangle::mangleCached. Not copied by clone, and cleared when the
+	/// declaration is mutated in place or its type is set.
+	struct MangleCache {
+		bool hasFull = false;
+		bool hasNoOverrideable = false;
+		Symbol full;
+		Symbol noOverrideable;
+
+		MangleCache() = default;
+		MangleCache( const MangleCache & ) {}
+		MangleCache & operator=( const MangleCache & ) = delete;
+	};
+	mutable MangleCache mangleCache;
+
+	/// Drop the cached mangled names. Call after changing the name, linkage or type of a node
+	/// that was mutated earlier, which may have been mangled since.
+	void clearMangleCache() const {
+		mangleCache.hasFull = false;
+		mangleCache.hasNoOverrideable = false;
+	}
+
 	/// Get type of this declaration. May be generated by subclass
 	virtual const Type * get_type() const = 0;
 	/// Set type of this declaration. May be verified by subclass
@@ -89,6 +110,7 @@ public:
 	const DeclWithType * accept( Visitor & v ) const override = 0;
 private:
 	DeclWithType * clone() const override = 0;
+	void clearCaches() override { clearMangleCache(); }
 	MUTATE_FRIEND
 };
 
@@ -103,11 +125,11 @@ public:
 		const Init * init = nullptr, Storage::Classes storage = {},
 		Linkage::Spec linkage = Linkage::Cforall, const Expr * bitWd = nullptr,
 		std::vector< ptr<Attribute> > && attrs = {}, Function::Specs fs = {} )
-	: DeclWithType( loc, name, storage, linkage, std::move(attrs), fs ), type( type ),
+	: DeclWithType( NodeKind::ObjectDecl, loc, name, storage, linkage, std::move(attrs), fs ), type( type ),
 	  init( init ), bitfieldWidth( bitWd ) {}
 
 	const Type* get_type() const override { return type; }
-	void set_type( const Type * ty ) override { type = ty; }
+	void set_type( const Type * ty ) override { type = ty; clearMangleCache(); }
 
 	const DeclWithType * accept( Visitor& v ) const override { return v.visit( this ); }
 private:
@@ -162,9 +184,9 @@ public:
 	std::vector<ptr<DeclWithType>> assertions;
 
 	NamedTypeDecl(
-		const CodeLocation & loc, const std::string & name, Storage::Classes storage,
+		NodeKind nodeKind, const CodeLocation & loc, const std::string & name, Storage::Classes storage,
 		const Type * b, Linkage::Spec spec = Linkage::Cforall )
-	: Decl( loc, name, storage, spec ), base( b ), assertions() {}
+	: Decl( nodeKind, loc, name, storage, spec ), base( b ), assertions() {}
 
 	/// Produces a name for the kind of alias
 	virtual const char * typeString() const = 0;
@@ -186,7 +208,7 @@ class TypeDecl final : public NamedTypeDecl {
 	TypeDecl(
 		const CodeLocation & loc, const std::string & name, Storage::Classes storage,
 		const Type * b, TypeDecl::Kind k, bool s, const Type * i = nullptr )
-	: NamedTypeDecl( loc, name, storage, b ), kind( k ), sized( k == TypeDecl::Ttype || s ),
+	: NamedTypeDecl( NodeKind::TypeDecl, loc, name, storage, b ), kind( k ), sized( k == TypeDecl::Ttype || s ),
 	  init( i ) {}
 
 	const char * typeString() const override;
@@ -224,7 +246,7 @@ class TypedefDecl final : public NamedTypeDecl {
 public:
 	TypedefDecl( const CodeLocation& loc, const std::string& name, Storage::Classes storage,
 		Type* b, Linkage::Spec spec = Linkage::Cforall )
-	: NamedTypeDecl( loc, name, storage, b, spec ) {}
+	: NamedTypeDecl( NodeKind::TypedefDecl, loc, name, storage, b, spec ) {}
 
 	const char * typeString() const override { return "typedef"; }
 
@@ -246,9 +268,9 @@ public:
 	bool body = false;
 	readonly<AggregateDecl> parent = {};
 
-	AggregateDecl( const CodeLocation& loc, const std::string& name,
+	AggregateDecl( NodeKind nodeKind, const CodeLocation& loc, const std::string& name,
 		std::vector<ptr<Attribute>>&& attrs = {}, Linkage::Spec linkage = Linkage::Cforall )
-	: Decl( loc, name, Storage::Classes{}, linkage ), members(), params(),
+	: Decl( nodeKind, loc, name, Storage::Classes{}, linkage ), members(), params(),
 	  attributes( std::move(attrs) ) {}
 
 	AggregateDecl* set_body( bool b ) { body = b; return this; }
@@ -269,7 +291,7 @@ public:
 	StructDecl( const CodeLocation& loc, const std::string& name,
 		Aggregate kind = Struct,
 		std::vector<ptr<Attribute>>&& attrs = {}, Linkage::Spec linkage = Linkage::Cforall )
-	: AggregateDecl( loc, name, std::move(attrs), linkage ), kind( kind ) {}
+	: AggregateDecl( NodeKind::StructDecl, loc, name, std::move(attrs), linkage ), kind( kind ) {}
 
 	bool is_coroutine() const { return kind == Coroutine; }
 	bool is_generator() const { return kind == Generator; }
@@ -290,7 +312,7 @@ class UnionDecl final : public AggregateDecl {
 public:
 	UnionDecl( const CodeLocation& loc, const std::string& name,
 		std::vector<ptr<Attribute>>&& attrs = {}, Linkage::Spec linkage = Linkage::Cforall )
-	: AggregateDecl( loc, name, std::move(attrs), linkage ) {}
+	: AggregateDecl( NodeKind::UnionDecl, loc, name, std::move(attrs), linkage ) {}
 
 	const Decl * accept( Visitor& v ) const override { return v.visit( this ); }
 
@@ -319,7 +341,7 @@ public:
 		std::vector<ptr<Attribute>>&& attrs = {}, Linkage::Spec linkage = Linkage::Cforall,
 		Type const * base = nullptr, EnumHiding hide = EnumHiding::Hide,
 		std::unordered_map< std::string, long long > enumValues = std::unordered_map< std::string, long long >() )
-	: AggregateDecl( loc, name, std::move(attrs), linkage ), isCfa(isCfa), base(base), hide(hide), enumValues(enumValues) {}
+	: AggregateDecl( NodeKind::EnumDecl, loc, name, std::move(attrs), linkage ), isCfa(isCfa), base(base), hide(hide), enumValues(enumValues) {}
 
 	/// gets the integer value for this enumerator, returning true iff value found
 	// Maybe it is not used in producing the enum value
@@ -344,7 +366,7 @@ class TraitDecl final : public AggregateDecl {
 public:
 	TraitDecl( const CodeLocation& loc, const std::string& name,
 		std::vector<ptr<Attribute>>&& attrs = {}, Linkage::Spec linkage = Linkage::Cforall )
-	: AggregateDecl( loc, name, std::move(attrs), linkage ) {}
+	: AggregateDecl( NodeKind::TraitDecl, loc, name, std::move(attrs), linkage ) {}
 
 	const Decl * accept( Visitor & v ) const override { return v.visit( this ); }
 
@@ -363,7 +385,7 @@ public:
 	ptr<Stmt> stmt;
 
 	WithStmt( const CodeLocation & loc, std::vector<ptr<Expr>> && exprs, const Stmt * stmt )
-	: Decl(loc, "", Storage::Auto, Linkage::Cforall), exprs(std::move(exprs)), stmt(stmt) {}
+	: Decl(NodeKind::WithStmt, loc, "", Storage::Auto, Linkage::Cforall), exprs(std::move(exprs)), stmt(stmt) {}
 
 	const Decl * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -377,7 +399,7 @@ public:
 	ptr<AsmStmt> stmt;
 
 	AsmDecl( const CodeLocation & loc, AsmStmt * stmt )
-	: Decl( loc, "", {}, Linkage::C ), stmt(stmt) {}
+	: Decl( NodeKind::AsmDecl, loc, "", {}, Linkage::C ), stmt(stmt) {}
 
 	const AsmDecl * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -391,7 +413,7 @@ public:
 	ptr<DirectiveStmt> stmt;
 
 	DirectiveDecl( const CodeLocation & loc, DirectiveStmt * stmt )
-	: Decl( loc, "", {}, Linkage::C ), stmt(stmt) {}
+	: Decl( NodeKind::DirectiveDecl, loc, "", {}, Linkage::C ), stmt(stmt) {}
 
 	const DirectiveDecl * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -406,7 +428,7 @@ public:
 	ptr<ConstantExpr> msg;   // string literal
 
 	StaticAssertDecl( const CodeLocation & loc, const Expr * condition, const ConstantExpr * msg )
-	: Decl( loc, "", {}, Linkage::C ), cond( condition ), msg( msg ) {}
+	: Decl( NodeKind::StaticAssertDecl, loc, "", {}, Linkage::C ), cond( condition ), msg( msg ) {}
 
 	const StaticAssertDecl * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -422,10 +444,10 @@ public:
 	InlineMemberDecl( const CodeLocation & loc, const std::string & name, const Type * type,
 		Storage::Classes storage = {}, Linkage::Spec linkage = Linkage::Cforall,
 		std::vector< ptr<Attribute> > && attrs = {}, Function::Specs fs = {} )
-	: DeclWithType( loc, name, storage, linkage, std::move(attrs), fs ), type( type ) {}
+	: DeclWithType( NodeKind::InlineMemberDecl, loc, name, storage, linkage, std::move(attrs), fs ), type( type ) {}
 
 	const Type * get_type() const override { return type; }
-	void set_type( const Type * ty ) override { type = ty; }
+	void set_type( const Type * ty ) override { type = ty; clearMangleCache(); }
 
 	const DeclWithType * accept( Visitor& v ) const override { return v.visit( this ); }
 private:
@@ -46,8 +46,8 @@ bool Expr::get_lvalue() const {
 // --- ApplicationExpr
 
 ApplicationExpr::ApplicationExpr( const CodeLocation & loc, const Expr * f,
-	std::vector<ptr<Expr>> && as )
-: Expr( loc ), func( f ), args( std::move(as) ) {
+	SmallVector<ptr<Expr>> && as )
+: Expr( NodeKind::ApplicationExpr, loc ), func( f ), args( std::move(as) ) {
 	// ensure that `ApplicationExpr` result type is `FuncExpr`
 	const PointerType * pt = strict_dynamic_cast< const PointerType * >( f->result.get() );
 	const FunctionType * fn = strict_dynamic_cast< const FunctionType * >( pt->base.get() );
@@ -111,10 +111,10 @@ UntypedExpr * UntypedExpr::createCall( const CodeLocation & loc,
 // --- VariableExpr
 
 VariableExpr::VariableExpr( const CodeLocation & loc )
-: Expr( loc ), var( nullptr ) {}
+: Expr( NodeKind::VariableExpr, loc ), var( nullptr ) {}
 
 VariableExpr::VariableExpr( const CodeLocation & loc, const DeclWithType * v )
-: Expr( loc ), var( v ) {
+: Expr( NodeKind::VariableExpr, loc ), var( v ) {
 	assert( var );
 	assert( var->get_type() );
 	result = shallowCopy( var->get_type() );
@@ -174,19 +174,19 @@ namespace {
 }
 
 AddressExpr::AddressExpr( const CodeLocation & loc, const Expr * a ) :
-	Expr( loc, addrExprType( loc, a ) ), arg( a )
+	Expr( NodeKind::AddressExpr, loc, addrExprType( loc, a ) ), arg( a )
 {}
 
 // --- LabelAddressExpr
 
 // label address always has type `void*`
 LabelAddressExpr::LabelAddressExpr( const CodeLocation & loc, Label && a )
-: Expr( loc, new PointerType{ new VoidType{} } ), arg( a ) {}
+: Expr( NodeKind::LabelAddressExpr, loc, new PointerType{ new VoidType{} } ), arg( a ) {}
 
 // --- CastExpr
 
 CastExpr::CastExpr( const CodeLocation & loc, const Expr * a, GeneratedFlag g, CastKind kind )
-: Expr( loc, new VoidType{} ), arg( a ), isGenerated( g ), kind( kind ) {}
+: Expr( NodeKind::CastExpr, loc, new VoidType{} ), arg( a ), isGenerated( g ), kind( kind ) {}
 
 bool CastExpr::get_lvalue() const {
 	// This is actually wrong by C, but it works with our current set-up.
@@ -208,7 +208,7 @@ bool UntypedMemberExpr::get_lvalue() const {
 // --- MemberExpr
 
 MemberExpr::MemberExpr( const CodeLocation & loc, const DeclWithType * mem, const Expr * agg )
-: Expr( loc ), member( mem ), aggregate( agg ) {
+: Expr( NodeKind::MemberExpr, loc ), member( mem ), aggregate( agg ) {
 	assert( member );
 	assert( aggregate );
 	assert( aggregate->result );
@@ -276,25 +276,25 @@ ConstantExpr * ConstantExpr::null( const CodeLocation & loc, const Type * ptrTyp
 // --- SizeofExpr
 
 SizeofExpr::SizeofExpr( const CodeLocation & loc, const Type * t )
-: Expr( loc, new BasicType{ BasicKind::LongUnsignedInt } ), type( t ) {}
+: Expr( NodeKind::SizeofExpr, loc, new BasicType{ BasicKind::LongUnsignedInt } ), type( t ) {}
 
 // --- CountExpr
 
 CountExpr::CountExpr( const CodeLocation & loc, const Expr * e )
-: Expr( loc, new BasicType( BasicKind::LongUnsignedInt) ), expr(e), type( nullptr ) {}
+: Expr( NodeKind::CountExpr, loc, new BasicType( BasicKind::LongUnsignedInt) ), expr(e), type( nullptr ) {}
 
 CountExpr::CountExpr( const CodeLocation & loc, const Type * t )
-: Expr( loc, new BasicType( BasicKind::LongUnsignedInt) ), expr(nullptr), type( t ) {}
+: Expr( NodeKind::CountExpr, loc, new BasicType( BasicKind::LongUnsignedInt) ), expr(nullptr), type( t ) {}
 
 // --- AlignofExpr
 
 AlignofExpr::AlignofExpr( const CodeLocation & loc, const Type * t )
-: Expr( loc, new BasicType{ BasicKind::LongUnsignedInt } ), type( t ) {}
+: Expr( NodeKind::AlignofExpr, loc, new BasicType{ BasicKind::LongUnsignedInt } ), type( t ) {}
 
 // --- OffsetofExpr
 
 OffsetofExpr::OffsetofExpr( const CodeLocation & loc, const Type * ty, const DeclWithType * mem )
-: Expr( loc, new BasicType{ BasicKind::LongUnsignedInt } ), type( ty ), member( mem ) {
+: Expr( NodeKind::OffsetofExpr, loc, new BasicType{ BasicKind::LongUnsignedInt } ), type( ty ), member( mem ) {
 	assert( type );
 	assert( member );
 }
@@ -302,7 +302,7 @@ OffsetofExpr::OffsetofExpr( const CodeLocation & loc, const Type * ty, const Dec
 // --- OffsetPackExpr
 
 OffsetPackExpr::OffsetPackExpr( const CodeLocation & loc, const StructInstType * ty )
-: Expr( loc, new ArrayType{
+: Expr( NodeKind::OffsetPackExpr, loc, new ArrayType{
 	new BasicType{ BasicKind::LongUnsignedInt }, nullptr, FixedLen, DynamicDim }
 ), type( ty ) {
 	assert( type );
@@ -312,7 +312,7 @@ OffsetPackExpr::OffsetPackExpr( const CodeLocation & loc, const StructInstType *
 
 LogicalExpr::LogicalExpr(
 	const CodeLocation & loc, const Expr * a1, const Expr * a2, LogicalFlag ia )
-: Expr( loc, new BasicType{ BasicKind::SignedInt } ), arg1( a1 ), arg2( a2 ), isAnd( ia ) {}
+: Expr( NodeKind::LogicalExpr, loc, new BasicType{ BasicKind::SignedInt } ), arg1( a1 ), arg2( a2 ), isAnd( ia ) {}
 
 // --- CommaExpr
 bool CommaExpr::get_lvalue() const {
@@ -324,7 +324,7 @@ bool CommaExpr::get_lvalue() const {
 // --- ConstructorExpr
 
 ConstructorExpr::ConstructorExpr( const CodeLocation & loc, const Expr * call )
-: Expr( loc ), callExpr( call ) {
+: Expr( NodeKind::ConstructorExpr, loc ), callExpr( call ) {
 	// allow resolver to type a constructor used as an expression if it has the same type as its
 	// first argument
 	assert( callExpr );
@@ -336,7 +336,7 @@ ConstructorExpr::ConstructorExpr( const CodeLocation & loc, const Expr * call )
 // --- CompoundLiteralExpr
 
 CompoundLiteralExpr::CompoundLiteralExpr( const CodeLocation & loc, const Type * t, const Init * i )
-: Expr( loc ), init( i ) {
+: Expr( NodeKind::CompoundLiteralExpr, loc ), init( i ) {
 	assert( t && i );
 	result = t;
 }
@@ -348,12 +348,12 @@ bool CompoundLiteralExpr::get_lvalue() const {
 // --- TupleExpr
 
 TupleExpr::TupleExpr( const CodeLocation & loc, std::vector<ptr<Expr>> && xs )
-: Expr( loc, Tuples::makeTupleType( xs ) ), exprs( xs ) {}
+: Expr( NodeKind::TupleExpr, loc, Tuples::makeTupleType( xs ) ), exprs( xs ) {}
 
 // --- TupleIndexExpr
 
 TupleIndexExpr::TupleIndexExpr( const CodeLocation & loc, const Expr * t, unsigned i )
-: Expr( loc ), tuple( t ), index( i ) {
+: Expr( NodeKind::TupleIndexExpr, loc ), tuple( t ), index( i ) {
 	const TupleType * type = strict_dynamic_cast< const TupleType * >( tuple->result.get() );
 	assertf( type->size() > index, "TupleIndexExpr index out of bounds: tuple size %d, requested "
 		"index %d in expr %s", type->size(), index, toString( tuple ).c_str() );
@@ -370,7 +370,7 @@ bool TupleIndexExpr::get_lvalue() const {
 TupleAssignExpr::TupleAssignExpr(
 	const CodeLocation & loc, std::vector<ptr<Expr>> && assigns,
 	std::vector<ptr<ObjectDecl>> && tempDecls )
-: Expr( loc, Tuples::makeTupleType( assigns ) ), stmtExpr() {
+: Expr( NodeKind::TupleAssignExpr, loc, Tuples::makeTupleType( assigns ) ), stmtExpr() {
 	// convert internally into a StmtExpr which contains the declarations and produces the tuple of
 	// the assignments
 	std::list<ptr<Stmt>> stmts;
@@ -386,7 +386,7 @@ TupleAssignExpr::TupleAssignExpr(
 // --- StmtExpr
 
 StmtExpr::StmtExpr( const CodeLocation & loc, const CompoundStmt * ss )
-: Expr( loc ), stmts( ss ), returnDecls(), dtors() { computeResult(); }
+: Expr( NodeKind::StmtExpr, loc ), stmts( ss ), returnDecls(), dtors() { computeResult(); }
 
 void StmtExpr::computeResult() {
 	assert( stmts );
@@ -409,7 +409,7 @@ void StmtExpr::computeResult() {
 unsigned long long UniqueExpr::nextId = 0;
 
 UniqueExpr::UniqueExpr( const CodeLocation & loc, const Expr * e, unsigned long long i )
-: Expr( loc, e->result ), expr( e ), id( i ) {
+: Expr( NodeKind::UniqueExpr, loc, e->result ), expr( e ), id( i ) {
 	assert( expr );
 	if ( id == -1ull ) {
 		assert( nextId != -1ull );
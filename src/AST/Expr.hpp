@@ -28,6 +28,7 @@
 #include "Decl.hpp"
 #include "ParseNode.hpp"
 #include "Visitor.hpp"
+#include "Common/SmallVector.hpp"
 
 // Must be included in *all* AST classes; should be #undef'd at the end of the file
 #define MUTATE_FRIEND \
@@ -183,8 +184,8 @@ public:
 	InferUnion inferred;
 	bool extension = false;
 
-	Expr( const CodeLocation & loc, const Type * res = nullptr )
-	: ParseNode( loc ), result( res ), env(), inferred() {}
+	Expr( NodeKind nodeKind, const CodeLocation & loc, const Type * res = nullptr )
+	: ParseNode( nodeKind, loc ), result( res ), env(), inferred() {}
 
 	virtual bool get_lvalue() const;
 
@@ -199,9 +200,9 @@ private:
 class ApplicationExpr final : public Expr {
 public:
 	ptr<Expr> func;
-	std::vector<ptr<Expr>> args;
+	SmallVector<ptr<Expr>> args;
 
-	ApplicationExpr( const CodeLocation & loc, const Expr * f, std::vector<ptr<Expr>> && as = {} );
+	ApplicationExpr( const CodeLocation & loc, const Expr * f, SmallVector<ptr<Expr>> && as = {} );
 
 	bool get_lvalue() const final;
 
@@ -218,7 +219,7 @@ public:
 	std::vector<ptr<Expr>> args;
 
 	UntypedExpr( const CodeLocation & loc, const Expr * f, std::vector<ptr<Expr>> && as = {} )
-	: Expr( loc ), func( f ), args( std::move(as) ) {}
+	: Expr( NodeKind::UntypedExpr, loc ), func( f ), args( std::move(as) ) {}
 
 	bool get_lvalue() const final;
 
@@ -242,7 +243,7 @@ class NameExpr final : public Expr {
 public:
 	std::string name;
 
-	NameExpr( const CodeLocation & loc, const std::string & n ) : Expr( loc ), name( n ) {}
+	NameExpr( const CodeLocation & loc, const std::string & n ) : Expr( NodeKind::NameExpr, loc ), name( n ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -258,10 +259,10 @@ public:
 	const std::string name;
 
 	QualifiedNameExpr( const CodeLocation & loc, const Decl * d, const std::string & n )
-	: Expr( loc ), type_decl( d ), type_name(""), name( n ) {}
+	: Expr( NodeKind::QualifiedNameExpr, loc ), type_decl( d ), type_name(""), name( n ) {}
 
 	QualifiedNameExpr( const CodeLocation & loc, const std::string & type_name, const std::string & name)
-	: Expr( loc ), type_name( type_name ), name( name ) {}
+	: Expr( NodeKind::QualifiedNameExpr, loc ), type_name( type_name ), name( name ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -344,7 +345,7 @@ public:
 	CastKind kind = CCast;
 
 	CastExpr( const CodeLocation & loc, const Expr * a, const Type * to,
-		GeneratedFlag g = GeneratedCast, CastKind kind = CCast ) : Expr( loc, to ), arg( a ), isGenerated( g ), kind( kind ) {}
+		GeneratedFlag g = GeneratedCast, CastKind kind = CCast ) : Expr( NodeKind::CastExpr, loc, to ), arg( a ), isGenerated( g ), kind( kind ) {}
 	/// Cast-to-void
 	CastExpr( const CodeLocation & loc, const Expr * a, GeneratedFlag g = GeneratedCast, CastKind kind = CCast );
 
@@ -378,10 +379,10 @@ public:
 
 
 	KeywordCastExpr( const CodeLocation & loc, const Expr * a, ast::AggregateDecl::Aggregate t )
-	: Expr( loc ), arg( a ), target( t ) {}
+	: Expr( NodeKind::KeywordCastExpr, loc ), arg( a ), target( t ) {}
 
 	KeywordCastExpr( const CodeLocation & loc, const Expr * a, ast::AggregateDecl::Aggregate t, const Concrete & ct )
-	: Expr( loc ), arg( a ), target( t ), concrete_target( ct ) {}
+	: Expr( NodeKind::KeywordCastExpr, loc ), arg( a ), target( t ), concrete_target( ct ) {}
 
 	/// Get a name for the target type
 	const char * targetString() const;
@@ -398,7 +399,7 @@ public:
 	ptr<Expr> arg;
 
 	VirtualCastExpr( const CodeLocation & loc, const Expr * a, const Type * to )
-	: Expr( loc, to ), arg( a ) {}
+	: Expr( NodeKind::VirtualCastExpr, loc, to ), arg( a ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -413,7 +414,7 @@ public:
 	ptr<Expr> aggregate;
 
 	UntypedMemberExpr( const CodeLocation & loc, const Expr * mem, const Expr * agg )
-	: Expr( loc ), member( mem ), aggregate( agg ) { assert( aggregate ); }
+	: Expr( NodeKind::UntypedMemberExpr, loc ), member( mem ), aggregate( agg ) { assert( aggregate ); }
 
 	bool get_lvalue() const final;
 
@@ -450,7 +451,7 @@ public:
 	ConstantExpr(
 		const CodeLocation & loc, const Type * ty, const std::string & r,
 			const std::optional<unsigned long long> & i )
-	: Expr( loc, ty ), rep( r ), ival( i ) {}
+	: Expr( NodeKind::ConstantExpr, loc, ty ), rep( r ), ival( i ) {}
 
 	/// Gets the integer value of this constant, if one is appropriate to its type.
 	/// Throws a SemanticError if the type is not appropriate for value-as-integer.
@@ -523,7 +524,7 @@ public:
 	std::string member;
 
 	UntypedOffsetofExpr( const CodeLocation & loc, const Type * ty, const std::string & mem )
-	: Expr( loc ), type( ty ), member( mem ) {}
+	: Expr( NodeKind::UntypedOffsetofExpr, loc ), type( ty ), member( mem ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -584,7 +585,7 @@ public:
 	ptr<Expr> arg3;
 
 	ConditionalExpr( const CodeLocation & loc, const Expr * a1, const Expr * a2, const Expr * a3 )
-	: Expr( loc ), arg1( a1 ), arg2( a2 ), arg3( a3 ) {}
+	: Expr( NodeKind::ConditionalExpr, loc ), arg1( a1 ), arg2( a2 ), arg3( a3 ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -599,7 +600,7 @@ public:
 	ptr<Expr> arg2;
 
 	CommaExpr( const CodeLocation & loc, const Expr * a1, const Expr * a2 )
-	: Expr( loc ), arg1( a1 ), arg2( a2 ) {
+	: Expr( NodeKind::CommaExpr, loc ), arg1( a1 ), arg2( a2 ) {
 		this->result = a2->result;
 	}
 
@@ -616,7 +617,7 @@ class TypeExpr final : public Expr {
 public:
 	ptr<Type> type;
 
-	TypeExpr( const CodeLocation & loc, const Type * t ) : Expr(loc), type(t) {}
+	TypeExpr( const CodeLocation & loc, const Type * t ) : Expr(NodeKind::TypeExpr, loc), type(t) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -630,7 +631,7 @@ public:
 	std::string name;
 
 	DimensionExpr( const CodeLocation & loc, std::string name )
-	: Expr( loc ), name( name ) {}
+	: Expr( NodeKind::DimensionExpr, loc ), name( name ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -647,7 +648,7 @@ public:
 	ptr<Expr> operand;
 
 	AsmExpr( const CodeLocation & loc, const std::string & io, const Expr * con, const Expr * op )
-	: Expr( loc ), inout( io ), constraint( con ), operand( op ) {}
+	: Expr( NodeKind::AsmExpr, loc ), inout( io ), constraint( con ), operand( op ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -662,7 +663,7 @@ public:
 	ptr<ApplicationExpr> callExpr;
 
 	ImplicitCopyCtorExpr( const CodeLocation & loc, const ApplicationExpr * call )
-	: Expr( loc, call->result ), callExpr(call) { assert( call ); assert(call->result); }
+	: Expr( NodeKind::ImplicitCopyCtorExpr, loc, call->result ), callExpr(call) { assert( call ); assert(call->result); }
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -705,7 +706,7 @@ public:
 	ptr<Expr> high;
 
 	RangeExpr( const CodeLocation & loc, const Expr * l, const Expr * h )
-	: Expr( loc ), low( l ), high( h ) {}
+	: Expr( NodeKind::RangeExpr, loc ), low( l ), high( h ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -719,7 +720,7 @@ public:
 	std::vector<ptr<Expr>> exprs;
 
 	UntypedTupleExpr( const CodeLocation & loc, std::vector<ptr<Expr>> && xs )
-	: Expr( loc ), exprs( std::move(xs) ) {}
+	: Expr( NodeKind::UntypedTupleExpr, loc ), exprs( std::move(xs) ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -829,7 +830,7 @@ public:
 	std::deque<InitAlternative> initAlts;
 
 	UntypedInitExpr( const CodeLocation & loc, const Expr * e, std::deque<InitAlternative> && as )
-	: Expr( loc ), expr( e ), initAlts( std::move(as) ) {}
+	: Expr( NodeKind::UntypedInitExpr, loc ), expr( e ), initAlts( std::move(as) ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -844,7 +845,7 @@ public:
 	ptr<Designation> designation;
 
 	InitExpr( const CodeLocation & loc, const Expr * e, const Designation * des )
-	: Expr( loc, e->result ), expr( e ), designation( des ) {}
+	: Expr( NodeKind::InitExpr, loc, e->result ), expr( e ), designation( des ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -860,7 +861,7 @@ public:
 	readonly<Decl> deleteStmt;
 
 	DeletedExpr( const CodeLocation & loc, const Expr * e, const Decl * del )
-	: Expr( loc, e->result ), expr( e ), deleteStmt( del ) { assert( expr->result ); }
+	: Expr( NodeKind::DeletedExpr, loc, e->result ), expr( e ), deleteStmt( del ) { assert( expr->result ); }
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -875,7 +876,7 @@ public:
 	ptr<Expr> expr;
 
 	DefaultArgExpr( const CodeLocation & loc, const Expr * e )
-	: Expr( loc, e->result ), expr( e ) { assert( e->result ); }
+	: Expr( NodeKind::DefaultArgExpr, loc, e->result ), expr( e ) { assert( e->result ); }
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -902,7 +903,7 @@ public:
 	std::vector<Association> associations;
 
 	GenericExpr( const CodeLocation & loc, const Expr * ctrl, std::vector<Association> && assns )
-	: Expr( loc ), control( ctrl ), associations( std::move(assns) ) {}
+	: Expr( NodeKind::GenericExpr, loc ), control( ctrl ), associations( std::move(assns) ) {}
 
 	const Expr * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -41,6 +41,7 @@ class StaticAssertDecl;
 class InlineMemberDecl;
 
 class Stmt;
+class StmtClause;
 class CompoundStmt;
 class ExprStmt;
 class AsmStmt;
@@ -59,6 +60,7 @@ class CatchClause;
 class FinallyClause;
 class SuspendStmt;
 class WhenClause;
+class WaitStmt;
 class WaitForStmt;
 class WaitForClause;
 class WaitUntilStmt;
@@ -154,6 +156,137 @@ typedef unsigned int UniqueId;
 class TranslationUnit;
 class TranslationGlobal;
 
+// Kinds of each node class, for isa and dyn_cast (see NodeKind.hpp).
+#define NODE_KINDS( node_t, first_kind, last_kind ) \
+	template<> struct NodeKindRange<node_t> { \
+		static constexpr NodeKind first = NodeKind::first_kind; \
+		static constexpr NodeKind last = NodeKind::last_kind; \
+	};
+#define NODE_KIND( node_t ) NODE_KINDS( node_t, node_t, node_t )
+
+NODE_KINDS( Node, ObjectDecl, TypeSubstitution )
+NODE_KINDS( ParseNode, ObjectDecl, ConstructorInit )
+NODE_KINDS( Decl, ObjectDecl, StaticAssertDecl )
+NODE_KINDS( DeclWithType, ObjectDecl, InlineMemberDecl )
+NODE_KINDS( NamedTypeDecl, TypeDecl, TypedefDecl )
+NODE_KINDS( AggregateDecl, StructDecl, TraitDecl )
+NODE_KINDS( Stmt, CompoundStmt, CoforStmt )
+NODE_KINDS( WaitStmt, WaitForStmt, WaitUntilStmt )
+NODE_KINDS( StmtClause, CaseClause, WaitForClause )
+NODE_KINDS( WhenClause, WhenClause, WaitForClause )
+NODE_KINDS( Expr, ApplicationExpr, GenericExpr )
+NODE_KINDS( Init, SingleInit, ConstructorInit )
+NODE_KINDS( Type, VoidType, GlobalScopeType )
+NODE_KINDS( BaseInstType, StructInstType, TypeInstType )
+
+NODE_KIND( ObjectDecl )
+NODE_KIND( FunctionDecl )
+NODE_KIND( InlineMemberDecl )
+NODE_KIND( TypeDecl )
+NODE_KIND( TypedefDecl )
+NODE_KIND( StructDecl )
+NODE_KIND( UnionDecl )
+NODE_KIND( EnumDecl )
+NODE_KIND( TraitDecl )
+NODE_KIND( WithStmt )
+NODE_KIND( AsmDecl )
+NODE_KIND( DirectiveDecl )
+NODE_KIND( StaticAssertDecl )
+NODE_KIND( CompoundStmt )
+NODE_KIND( NullStmt )
+NODE_KIND( ExprStmt )
+NODE_KIND( AsmStmt )
+NODE_KIND( DirectiveStmt )
+NODE_KIND( IfStmt )
+NODE_KIND( SwitchStmt )
+NODE_KIND( WhileDoStmt )
+NODE_KIND( ForStmt )
+NODE_KIND( ForeachStmt )
+NODE_KIND( BranchStmt )
+NODE_KIND( ReturnStmt )
+NODE_KIND( ThrowStmt )
+NODE_KIND( TryStmt )
+NODE_KIND( SuspendStmt )
+NODE_KIND( WaitForStmt )
+NODE_KIND( WaitUntilStmt )
+NODE_KIND( DeclStmt )
+NODE_KIND( ImplicitCtorDtorStmt )
+NODE_KIND( MutexStmt )
+NODE_KIND( CorunStmt )
+NODE_KIND( CoforStmt )
+NODE_KIND( CaseClause )
+NODE_KIND( CatchClause )
+NODE_KIND( FinallyClause )
+NODE_KIND( WaitForClause )
+NODE_KIND( ApplicationExpr )
+NODE_KIND( UntypedExpr )
+NODE_KIND( NameExpr )
+NODE_KIND( QualifiedNameExpr )
+NODE_KIND( VariableExpr )
+NODE_KIND( AddressExpr )
+NODE_KIND( LabelAddressExpr )
+NODE_KIND( CastExpr )
+NODE_KIND( KeywordCastExpr )
+NODE_KIND( VirtualCastExpr )
+NODE_KIND( UntypedMemberExpr )
+NODE_KIND( MemberExpr )
+NODE_KIND( ConstantExpr )
+NODE_KIND( SizeofExpr )
+NODE_KIND( CountExpr )
+NODE_KIND( AlignofExpr )
+NODE_KIND( UntypedOffsetofExpr )
+NODE_KIND( OffsetofExpr )
+NODE_KIND( OffsetPackExpr )
+NODE_KIND( LogicalExpr )
+NODE_KIND( ConditionalExpr )
+NODE_KIND( CommaExpr )
+NODE_KIND( TypeExpr )
+NODE_KIND( DimensionExpr )
+NODE_KIND( AsmExpr )
+NODE_KIND( ImplicitCopyCtorExpr )
+NODE_KIND( ConstructorExpr )
+NODE_KIND( CompoundLiteralExpr )
+NODE_KIND( RangeExpr )
+NODE_KIND( UntypedTupleExpr )
+NODE_KIND( TupleExpr )
+NODE_KIND( TupleIndexExpr )
+NODE_KIND( TupleAssignExpr )
+NODE_KIND( StmtExpr )
+NODE_KIND( UniqueExpr )
+NODE_KIND( UntypedInitExpr )
+NODE_KIND( InitExpr )
+NODE_KIND( DeletedExpr )
+NODE_KIND( DefaultArgExpr )
+NODE_KIND( GenericExpr )
+NODE_KIND( Designation )
+NODE_KIND( SingleInit )
+NODE_KIND( ListInit )
+NODE_KIND( ConstructorInit )
+NODE_KIND( VoidType )
+NODE_KIND( BasicType )
+NODE_KIND( PointerType )
+NODE_KIND( ArrayType )
+NODE_KIND( ReferenceType )
+NODE_KIND( QualifiedType )
+NODE_KIND( FunctionType )
+NODE_KIND( StructInstType )
+NODE_KIND( UnionInstType )
+NODE_KIND( EnumInstType )
+NODE_KIND( TraitInstType )
+NODE_KIND( TypeInstType )
+NODE_KIND( TupleType )
+NODE_KIND( TypeofType )
+NODE_KIND( VTableType )
+NODE_KIND( VarArgsType )
+NODE_KIND( ZeroType )
+NODE_KIND( OneType )
+NODE_KIND( GlobalScopeType )
+NODE_KIND( Attribute )
+NODE_KIND( TypeSubstitution )
+
+#undef NODE_KIND
+#undef NODE_KINDS
+
 // For the following types, only use the using type.
 namespace CV {
 	struct qualifier_flags;
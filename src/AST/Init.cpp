@@ -23,7 +23,7 @@ namespace ast {
 
 ListInit::ListInit( const CodeLocation& loc, std::vector<ptr<Init>>&& is,
 	std::vector<ptr<Designation>>&& ds, ConstructFlag mc)
-: Init( loc, mc ), initializers( std::move(is) ), designations( std::move(ds) ) {
+: Init( NodeKind::ListInit, loc, mc ), initializers( std::move(is) ), designations( std::move(ds) ) {
 	// handle common case where ListInit is created without designations by making an
 	// equivalent-length empty list
 	if ( designations.empty() ) {
@@ -40,7 +40,7 @@ public:
 	std::deque<ptr<Expr>> designators;
 
 	Designation( const CodeLocation& loc, std::deque<ptr<Expr>>&& ds = {} )
-	: ParseNode( loc ), designators( std::move(ds) ) {}
+	: ParseNode( NodeKind::Designation, loc ), designators( std::move(ds) ) {}
 
 	const Designation* accept( Visitor& v ) const override { return v.visit( this ); }
 private:
@@ -56,7 +56,7 @@ class Init : public ParseNode {
 public:
 	ConstructFlag maybeConstructed;
 
-	Init( const CodeLocation & loc, ConstructFlag mc ) : ParseNode( loc ), maybeConstructed( mc ) {}
+	Init( NodeKind nodeKind, const CodeLocation & loc, ConstructFlag mc ) : ParseNode( nodeKind, loc ), maybeConstructed( mc ) {}
 
 	const Init * accept( Visitor & v ) const override = 0;
 private:
@@ -71,7 +71,7 @@ public:
 	ptr<Expr> value;
 
 	SingleInit( const CodeLocation & loc, const Expr * val, ConstructFlag mc = NoConstruct )
-	: Init( loc, mc ), value( val ) {}
+	: Init( NodeKind::SingleInit, loc, mc ), value( val ) {}
 
 	const Init * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -118,7 +118,7 @@ public:
 
 	ConstructorInit(
 		const CodeLocation & loc, const Stmt * ctor, const Stmt * dtor, const Init * init )
-	: Init( loc, MaybeConstruct ), ctor( ctor ), dtor( dtor ), init( init ) {}
+	: Init( NodeKind::ConstructorInit, loc, MaybeConstruct ), ctor( ctor ), dtor( dtor ), init( init ) {}
 
 	const Init * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
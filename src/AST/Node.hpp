@@ -8,9 +8,9 @@
 //
 // Author           : Thierry Delisle
 // Created On       : Wed May 8 10:27:04 2019
-// Last Modified By : Andrew Beach
-// Last Modified On : Mon May  9 10:20:00 2022
-// Update Count     : 8
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 18:00:00 2026
+// Update Count     : 9
 //
 
 #pragma once
@@ -18,7 +18,10 @@
 #include <cassert>
 #include <cstddef>     // for nullptr_t
 #include <iosfwd>
+#include <type_traits> // for remove_cv_t
 
+#include "AST/NodeArena.hpp"        // for allocate, release
+#include "AST/NodeKind.hpp"         // for NodeKind, NodeKindRange
 #include "Common/ErrorObjects.hpp"  // for SemanticErrorException
 
 namespace ast {
@@ -31,13 +34,17 @@ class Node {
 public:
 	// override defaults to ensure assignment doesn't
 	// change/share reference counts
-	Node() = default;
-	Node(const Node&) : strong_count(0), weak_count(0) {}
-	Node(Node&&) : strong_count(0), weak_count(0) {}
+	explicit Node( NodeKind kind ) : kind_( kind ) {}
+	Node(const Node& o) : strong_count(0), weak_count(0), kind_(o.kind_) {}
+	Node(Node&& o) : strong_count(0), weak_count(0), kind_(o.kind_) {}
 	Node& operator=(const Node&) = delete;
 	Node& operator=(Node&&) = delete;
 	virtual ~Node() {}
 
+	/// Nodes are allocated through the node arena, see NodeArena.hpp.
+	static void * operator new( std::size_t size ) { return NodeArena::allocate( size ); }
+	static void operator delete( void * node, std::size_t size ) { NodeArena::release( node, size ); }
+
 	virtual const Node * accept( Visitor & v ) const = 0;
 
 	/// Types of node references
@@ -53,10 +60,16 @@ public:
 		return (1 == strong_count || (1 < strong_count && 0 == weak_count));
 	}
 
+	/// The concrete class of this node, see isa and dyn_cast
+	NodeKind kind() const { return kind_; }
+
 private:
 	/// Make a copy of this node; should be overridden in subclass with more precise return type
 	virtual Node * clone() const = 0;
 
+	/// Drop anything computed from the node, called when mutate changes it in place
+	virtual void clearCaches() {}
+
 	/// Must be copied in ALL derived classes
 	template<typename node_t>
 	friend node_t * mutate(const node_t * node);
@@ -66,6 +79,8 @@ private:
 	mutable size_t strong_count = 0;
 	mutable size_t weak_count = 0;
 	mutable bool was_ever_strong = false;
+	/// Passed up by the constructors of each concrete class, and kept by copies
+	const NodeKind kind_;
 
 	void increment(ref_type ref) const {
 		switch (ref) {
@@ -94,7 +109,9 @@ private:
 template<typename node_t>
 node_t * mutate( const node_t * node ) {
 	if (node->strong_count <= 1) {
-		return const_cast<node_t *>(node);
+		node_t * ret = const_cast<node_t *>(node);
+		static_cast<Node *>(ret)->clearCaches();
+		return ret;
 	}
 
 	assertf(
@@ -141,6 +158,20 @@ const node_t * mutate_each( const node_t * node, coll_t super_t::* field, Visito
 
 std::ostream& operator<< ( std::ostream& out, const Node * node );
 
+/// Checks if a (non-null) node is a node_t by its kind, without RTTI.
+template<typename node_t>
+bool isa( const Node * node ) {
+	using Range = NodeKindRange< std::remove_cv_t<node_t> >;
+	return static_cast<unsigned>( node->kind() ) - static_cast<unsigned>( Range::first )
+		<= static_cast<unsigned>( Range::last ) - static_cast<unsigned>( Range::first );
+}
+
+/// Casts a node to node_t if it is one, otherwise returns null; dynamic_cast by kind.
+template<typename node_t>
+const node_t * dyn_cast( const Node * node ) {
+	return ( node && isa<node_t>( node ) ) ? static_cast<const node_t *>( node ) : nullptr;
+}
+
 /// Call a visitor on a possibly-null node
 template<typename node_t>
 auto maybe_accept( const node_t * n, Visitor & v ) -> decltype( n->accept(v) ) {
@@ -249,18 +280,18 @@ public:
 		return ret;
 	}
 
-	/// wrapper for convenient access to dynamic_cast
+	/// wrapper for convenient access to dyn_cast
 	template<typename o_node_t>
-	const o_node_t * as() const { _check(); return dynamic_cast<const o_node_t *>(node); }
+	const o_node_t * as() const { _check(); return dyn_cast<o_node_t>(node); }
 
-	/// Wrapper that makes sure dynamic_cast returns non-null.
+	/// Wrapper that makes sure dyn_cast returns non-null.
 	template<typename o_node_t>
 	const o_node_t * strict_as() const {
 		if (const o_node_t * ret = as<o_node_t>()) return ret;
 		_strict_fail();
 	}
 
-	/// Wrapper that makes sure dynamic_cast does not fail.
+	/// Wrapper that makes sure dyn_cast does not fail.
 	template<typename o_node_t, decltype(nullptr) null>
 	const o_node_t * strict_as() const { return node ? strict_as<o_node_t>() : nullptr; }
 
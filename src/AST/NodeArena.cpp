@@ -0,0 +1,92 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// NodeArena.cpp -- Bulk allocation of AST nodes.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 10:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 10:00:00 2026
+// Update Count     : 0
+//
+
+#include "NodeArena.hpp"
+
+#include <cassert>                      // for assertf
+#include <new>                          // for operator new, operator delete
+
+#include "Common/BlockPool.hpp"         // for BlockPool
+#include "Common/Stats/Counter.hpp"     // for SimpleCounter
+
+namespace ast {
+
+namespace NodeArena {
+
+namespace {
+	auto stats() {
+		using namespace Stats::Counters;
+		static auto group = build<CounterGroup>("Node Arena");
+		static struct {
+			SimpleCounter * fresh;
+			SimpleCounter * reused;
+			SimpleCounter * large;
+		} ret = {
+			.fresh  = build<SimpleCounter>("New Blocks", group),
+			.reused = build<SimpleCounter>("Reused Blocks", group),
+			.large  = build<SimpleCounter>("Large Nodes", group),
+		};
+		return ret;
+	}
+
+	bool active = false;
+	/// Set once any node has been allocated, arena or not.
+	bool started = false;
+
+	thread_local BlockPool pool;
+} // namespace
+
+void enable() {
+	assertf( ! started, "node arena enabled after a node was allocated" );
+	active = true;
+}
+
+bool enabled() {
+	return active;
+}
+
+void * allocate( std::size_t size ) {
+	started = true;
+	if ( ! active ) return ::operator new( size );
+	if ( ! BlockPool::fits( size ) ) {
+		++*stats().large;
+		return ::operator new( size );
+	}
+
+	if ( void * block = pool.reuse( size ) ) {
+		++*stats().reused;
+		return block;
+	}
+	++*stats().fresh;
+	return pool.carve( size );
+}
+
+void release( void * node, std::size_t size ) {
+	if ( ! active || ! BlockPool::fits( size ) ) {
+		::operator delete( node );
+		return;
+	}
+	pool.release( node, size );
+}
+
+} // namespace NodeArena
+
+}
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
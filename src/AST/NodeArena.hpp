@@ -0,0 +1,47 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// NodeArena.hpp -- Bulk allocation of AST nodes.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 10:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 10:00:00 2026
+// Update Count     : 0
+//
+
+#pragma once
+
+#include <cstddef>
+
+namespace ast {
+
+/// Storage for AST nodes. When enabled, nodes are carved out of large chunks
+/// instead of being allocated one by one, and the storage of a released node
+/// is kept for the next node of its size class. Chunks are never returned,
+/// the whole arena goes away with the process.
+namespace NodeArena {
+	/// Allocate nodes from the arena. Must be called before the first node is
+	/// allocated, since nodes from the global heap cannot go back to the arena.
+	void enable();
+
+	/// Are nodes allocated from the arena?
+	bool enabled();
+
+	/// Allocate storage for a node of the given size.
+	void * allocate( std::size_t size );
+
+	/// Release storage from allocate, with the same size.
+	void release( void * node, std::size_t size );
+}
+
+}
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
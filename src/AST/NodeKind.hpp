@@ -0,0 +1,170 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// NodeKind.hpp -- Tags for the concrete classes of AST nodes.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 18:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 18:00:00 2026
+// Update Count     : 0
+//
+
+#pragma once
+
+namespace ast {
+
+/// The concrete class of a node. Listed in a pre-order walk of the class
+/// hierarchy, so the concrete classes derived from any one node class have
+/// a contiguous range of kinds (see NodeKindRange in Fwd.hpp). Keep it that
+/// way when adding a node class.
+enum class NodeKind : unsigned char {
+	// ParseNode
+	//   Decl
+	//     DeclWithType
+	ObjectDecl,
+	FunctionDecl,
+	InlineMemberDecl,
+	//     NamedTypeDecl
+	TypeDecl,
+	TypedefDecl,
+	//     AggregateDecl
+	StructDecl,
+	UnionDecl,
+	EnumDecl,
+	TraitDecl,
+	//     (others)
+	WithStmt,
+	AsmDecl,
+	DirectiveDecl,
+	StaticAssertDecl,
+
+	//   Stmt
+	CompoundStmt,
+	NullStmt,
+	ExprStmt,
+	AsmStmt,
+	DirectiveStmt,
+	IfStmt,
+	SwitchStmt,
+	WhileDoStmt,
+	ForStmt,
+	ForeachStmt,
+	BranchStmt,
+	ReturnStmt,
+	ThrowStmt,
+	TryStmt,
+	SuspendStmt,
+	//     WaitStmt
+	WaitForStmt,
+	WaitUntilStmt,
+	//     (others)
+	DeclStmt,
+	ImplicitCtorDtorStmt,
+	MutexStmt,
+	CorunStmt,
+	CoforStmt,
+
+	//   StmtClause
+	CaseClause,
+	CatchClause,
+	FinallyClause,
+	//     WhenClause
+	WhenClause,
+	WaitForClause,
+
+	//   Expr
+	ApplicationExpr,
+	UntypedExpr,
+	NameExpr,
+	QualifiedNameExpr,
+	VariableExpr,
+	AddressExpr,
+	LabelAddressExpr,
+	CastExpr,
+	KeywordCastExpr,
+	VirtualCastExpr,
+	UntypedMemberExpr,
+	MemberExpr,
+	ConstantExpr,
+	SizeofExpr,
+	CountExpr,
+	AlignofExpr,
+	UntypedOffsetofExpr,
+	OffsetofExpr,
+	OffsetPackExpr,
+	LogicalExpr,
+	ConditionalExpr,
+	CommaExpr,
+	TypeExpr,
+	DimensionExpr,
+	AsmExpr,
+	ImplicitCopyCtorExpr,
+	ConstructorExpr,
+	CompoundLiteralExpr,
+	RangeExpr,
+	UntypedTupleExpr,
+	TupleExpr,
+	TupleIndexExpr,
+	TupleAssignExpr,
+	StmtExpr,
+	UniqueExpr,
+	UntypedInitExpr,
+	InitExpr,
+	DeletedExpr,
+	DefaultArgExpr,
+	GenericExpr,
+
+	//   Designation
+	Designation,
+
+	//   Init
+	SingleInit,
+	ListInit,
+	ConstructorInit,
+
+	// Type
+	VoidType,
+	BasicType,
+	PointerType,
+	ArrayType,
+	ReferenceType,
+	QualifiedType,
+	FunctionType,
+	//   BaseInstType
+	StructInstType,
+	UnionInstType,
+	EnumInstType,
+	TraitInstType,
+	TypeInstType,
+	//   (others)
+	TupleType,
+	TypeofType,
+	VTableType,
+	VarArgsType,
+	ZeroType,
+	OneType,
+	GlobalScopeType,
+
+	// Attribute
+	Attribute,
+
+	// TypeSubstitution
+	TypeSubstitution,
+};
+
+/// The range of kinds [first, last] of the concrete classes derived from (or
+/// equal to) node_t; specialized for each node class in Fwd.hpp.
+template<typename node_t>
+struct NodeKindRange;
+
+}
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
@@ -30,7 +30,7 @@ public:
 	// Escape hatch if needed is to explicitly pass a default-constructed location, but
 	// this should be used sparingly.
 
-	ParseNode( const CodeLocation& loc ) : Node(), location(loc) {}
+	ParseNode( NodeKind kind, const CodeLocation& loc ) : Node( kind ), location(loc) {}
 
 	ParseNode( const ParseNode& o ) = default;
 private:
@@ -19,6 +19,8 @@
 #include <functional>
 #include <list>
 #include <stack>
+#include <tuple>
+#include <type_traits>
 
 #include "AST/Fwd.hpp"
 #include "AST/Node.hpp"
@@ -313,6 +315,19 @@ void accept_all( ast::TranslationUnit &, ast::Pass<core_t> & visitor );
 /// If used the visitor will always clone nodes.
 struct PureVisitor {};
 
+/// If used the visitor skips frozen top-level declarations, see isFrozen. Only for passes that
+/// work on statements and what is in them; it cannot be used with the symbol table.
+struct SkipFrozenDecls {};
+
+/// A builtin declaration without a body or initializer is frozen: the prelude is mostly these and
+/// they have no statements, so passes that only change statements leave them as they are.
+inline bool isFrozen( const Decl * decl ) {
+	if ( !decl->linkage.is_builtin ) return false;
+	if ( auto func = dynamic_cast< const FunctionDecl * >( decl ) ) return !func->stmts;
+	if ( auto obj = dynamic_cast< const ObjectDecl * >( decl ) ) return !obj->init;
+	return false;
+}
+
 /// Keep track of the nearest parent node's location field.
 struct WithCodeLocation {
 	const CodeLocation * location = nullptr;
@@ -359,6 +374,8 @@ class WithGuards {
 	template< typename core_t >
 	friend auto __pass::make_value_guard( core_t & core, int )
 		-> decltype( __pass::value_guard( core.at_cleanup ) );
+	template< typename... cores_t >
+	friend class Fused;
 public:
 
 	/// When this node is finished being visited, restore the value of a variable
@@ -427,6 +444,118 @@ struct WithConstTranslationUnit {
 	}
 };
 
+namespace __pass::fused {
+	/// The value guards of a fused core, which its cores' guards are added to.
+	struct Guards {
+		at_cleanup_t at_cleanup;
+	};
+}
+
+/// Run several pass cores in one traversal. Pass<Fused<A, B>> calls the
+/// previsit of A and then of B on each node, and after the children the
+/// postvisit of A and then of B, each on the node the one before returned.
+/// That only does the same as running Pass<A> and then Pass<B> if B does not
+/// look at anything A changes. Also, B does not visit the declarations and
+/// statements A adds, or a node A replaces with another kind of node.
+/// The cores may use WithGuards, WithCodeLocation, WithDeclsToAdd and
+/// WithStmtsToAdd, but none of the accessories that change the walk.
+/// Frozen declarations are skipped if every core skips them.
+template< typename... cores_t >
+class Fused final :
+		public __pass::fused::accessory<
+			( std::is_base_of<WithGuards, cores_t>::value || ... ), __pass::fused::Guards, 0>,
+		public __pass::fused::accessory<
+			( std::is_base_of<WithCodeLocation, cores_t>::value || ... ), WithCodeLocation, 1>,
+		public __pass::fused::accessory<
+			( __pass::fused::uses_decls_to_add<cores_t>::value || ... ), WithDeclsToAdd, 2>,
+		public __pass::fused::accessory<
+			( __pass::fused::uses_stmts_to_add<cores_t>::value || ... ), WithStmtsToAdd, 3>,
+		public __pass::fused::accessory<
+			( std::is_base_of<SkipFrozenDecls, cores_t>::value && ... ), SkipFrozenDecls, 4> {
+	static_assert( ( __pass::fused::shares_walk<cores_t> && ... ),
+		"Fused cores may not use accessories that change the walk." );
+	static_assert( ( ( !__pass::fused::uses_decls_to_add<cores_t>::value
+		|| std::is_base_of<WithDeclsToAdd, cores_t>::value ) && ... ),
+		"Fused cores add declarations with WithDeclsToAdd." );
+	static_assert( ( ( !__pass::fused::uses_stmts_to_add<cores_t>::value
+		|| std::is_base_of<WithStmtsToAdd, cores_t>::value ) && ... ),
+		"Fused cores add statements with WithStmtsToAdd." );
+public:
+	/// Forward one argument to the constructor of each core, or none.
+	template< typename... Args >
+	Fused( Args &&... args ) : cores( std::forward<Args>( args )... ) {
+		std::apply( [this]( auto &... core ) { ( addGuards( core ), ... ); }, cores );
+	}
+
+	Fused( const Fused & ) = delete;
+	Fused & operator=( const Fused & ) = delete;
+
+	std::tuple< cores_t... > cores;
+
+	template< typename node_t >
+	auto previsit( const node_t * node ) -> typename std::enable_if<
+			( __pass::fused::has_previsit<cores_t, node_t>::value || ... ), const node_t * >::type {
+		std::apply( [this, &node]( auto &... core ) {
+			( call( core, [&core, &node]() { __pass::previsit( core, node, 0 ); } ), ... );
+		}, cores );
+		return node;
+	}
+
+	template< typename node_t >
+	auto postvisit( const node_t * node ) -> typename std::enable_if<
+			( __pass::fused::has_postvisit<cores_t, node_t>::value || ... ),
+			decltype( node->accept( *(Visitor*)nullptr ) ) >::type {
+		decltype( node->accept( *(Visitor*)nullptr ) ) result = node;
+		std::apply( [this, &node, &result]( auto &... core ) {
+			( call( core, [&core, &node, &result]() {
+				// The cores after one that changes the kind of node skip it.
+				if ( !node ) return;
+				result = __pass::postvisit( core, node, 0 );
+				if ( result != node ) node = dynamic_cast< const node_t * >( result );
+			} ), ... );
+		}, cores );
+		return result;
+	}
+
+private:
+	template< typename core_t >
+	void addGuards( core_t & core ) {
+		if constexpr ( std::is_base_of<WithGuards, core_t>::value ) {
+			core.at_cleanup = [this]( __pass::cleanup_func_t func, void * val ) {
+				this->at_cleanup( std::move( func ), val );
+			};
+		}
+	}
+
+	/// Call into a core, with the location it would have and taking what
+	/// it adds, even if the call throws.
+	template< typename core_t, typename func_t >
+	void call( core_t & core, func_t && func ) {
+		if constexpr ( std::is_base_of<WithCodeLocation, core_t>::value ) {
+			core.location = this->location;
+		}
+		try {
+			func();
+		} catch ( ... ) {
+			takeAdded( core );
+			throw;
+		}
+		takeAdded( core );
+	}
+
+	template< typename core_t >
+	void takeAdded( core_t & core ) {
+		if constexpr ( std::is_base_of<WithDeclsToAdd, core_t>::value ) {
+			this->declsToAddBefore.splice( this->declsToAddBefore.end(), core.declsToAddBefore );
+			this->declsToAddAfter.splice( this->declsToAddAfter.end(), core.declsToAddAfter );
+		}
+		if constexpr ( std::is_base_of<WithStmtsToAdd, core_t>::value ) {
+			this->stmtsToAddBefore.splice( this->stmtsToAddBefore.end(), core.stmtsToAddBefore );
+			this->stmtsToAddAfter.splice( this->stmtsToAddAfter.end(), core.stmtsToAddAfter );
+		}
+	}
+};
+
 }
 
 #include "Common/Stats.hpp"
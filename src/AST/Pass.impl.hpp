@@ -364,6 +364,10 @@ void ast::Pass< core_t >::maybe_accept_as_compound(
 
 template< typename core_t >
 inline void ast::accept_all( std::list< ast::ptr<ast::Decl> > & decls, ast::Pass< core_t > & visitor ) {
+	constexpr bool skip_frozen = std::is_base_of< SkipFrozenDecls, core_t >::value;
+	static_assert( !skip_frozen || !__pass::fused::uses_symtab< core_t >::value,
+		"A pass that keeps a symbol table must see every declaration." );
+
 	// We are going to aggregate errors for all these statements
 	SemanticErrorException errors;
 
@@ -389,7 +393,7 @@ inline void ast::accept_all( std::list< ast::ptr<ast::Decl> > & decls, ast::Pass
 			// run visitor on declaration
 			ast::ptr<ast::Decl> & node = *i;
 			assert( node );
-			node = node->accept( visitor );
+			if ( !skip_frozen || !isFrozen( node ) ) node = node->accept( visitor );
 		}
 		catch( SemanticErrorException &e ) {
 			if (__pass::on_error (visitor.core, *i, 0))
@@ -21,6 +21,7 @@
 #include "Common/Utility.hpp"
 namespace ast {
 	template<typename core_t> class Pass;
+	template<typename... cores_t> class Fused;
 	class TranslationUnit;
 	struct PureVisitor;
 	template<typename node_t> node_t * deepCopy( const node_t * );
@@ -487,6 +488,57 @@ namespace forall {
 	static inline auto replace( core_t &, long, const ast::TypeInstType *& ) {}
 } // namespace forall
 
+// Fused cores share one walk, so they cannot use the accessories that change
+// how the tree is walked or that Pass keeps a single copy of.
+namespace fused {
+	#define USES_ACCESSORY( name, expr ) \
+	template<typename core_t, typename = void> \
+	struct name : std::false_type {}; \
+	\
+	template<typename core_t> \
+	struct name<core_t, std::void_t<decltype( expr )>> : std::true_type {};
+
+	USES_ACCESSORY( uses_short_circuiting, std::declval<core_t &>().visit_children )
+	USES_ACCESSORY( uses_symtab          , std::declval<core_t &>().symtab )
+	USES_ACCESSORY( uses_visitor         , std::declval<core_t &>().visitor )
+	USES_ACCESSORY( uses_type_subs       , std::declval<core_t &>().typeSubs )
+	USES_ACCESSORY( uses_translation_unit, std::declval<core_t &>().translationUnit )
+	USES_ACCESSORY( uses_scopes          , std::declval<core_t &>().beginScope() )
+	USES_ACCESSORY( uses_forall_subs     , std::declval<core_t &>().subs )
+	USES_ACCESSORY( uses_decls_to_add    , std::declval<core_t &>().declsToAddBefore )
+	USES_ACCESSORY( uses_stmts_to_add    , std::declval<core_t &>().stmtsToAddBefore )
+
+	#undef USES_ACCESSORY
+
+	template<typename core_t>
+	static constexpr bool shares_walk =
+		!uses_short_circuiting<core_t>::value && !uses_symtab<core_t>::value
+		&& !uses_visitor<core_t>::value && !uses_type_subs<core_t>::value
+		&& !uses_translation_unit<core_t>::value && !uses_scopes<core_t>::value
+		&& !uses_forall_subs<core_t>::value && !std::is_base_of<PureVisitor, core_t>::value;
+
+	template<typename core_t, typename node_t, typename = void>
+	struct has_previsit : std::false_type {};
+
+	template<typename core_t, typename node_t>
+	struct has_previsit<core_t, node_t, std::void_t<decltype(
+		std::declval<core_t &>().previsit( std::declval<const node_t *>() ) )>> : std::true_type {};
+
+	template<typename core_t, typename node_t, typename = void>
+	struct has_postvisit : std::false_type {};
+
+	template<typename core_t, typename node_t>
+	struct has_postvisit<core_t, node_t, std::void_t<decltype(
+		std::declval<core_t &>().postvisit( std::declval<const node_t *>() ) )>> : std::true_type {};
+
+	/// Stands in for an accessory none of the fused cores use.
+	template<int tag>
+	struct without {};
+
+	template<bool used, typename accessory_t, int tag>
+	using accessory = typename std::conditional<used, accessory_t, without<tag>>::type;
+} // namespace fused
+
 // For passes, usually utility passes, that have a result.
 namespace result {
 	template<typename core_t>
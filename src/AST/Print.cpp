@@ -22,6 +22,7 @@
 #include "Stmt.hpp"
 #include "Type.hpp"
 #include "TypeSubstitution.hpp"
+#include "Vector.hpp"
 #include "CompilationState.hpp"
 #include "Common/Iterate.hpp"
 
@@ -149,7 +150,7 @@ private:
 		--indent;
 	}
 
-	void print( const std::vector<ptr<Attribute>> & attrs ) {
+	void print( const ast::vector<Attribute> & attrs ) {
 		if ( attrs.empty() ) return;
 		os << "with attributes" << endl;
 		++indent;
@@ -157,7 +158,7 @@ private:
 		--indent;
 	}
 
-	void print( const std::vector<ptr<Expr>> & params ) {
+	void print( const ast::vector<Expr> & params ) {
 		if ( params.empty() ) return;
 		os << endl << indent << "... with parameters" << endl;
 		++indent;
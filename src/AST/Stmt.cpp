@@ -68,7 +68,7 @@ CompoundStmt::CompoundStmt( const CompoundStmt& other ) : Stmt(other), kids() {
 
 // --- BranchStmt
 BranchStmt::BranchStmt( const CodeLocation& loc, Kind kind, Label target, const std::vector<Label>&& labels )
-		: Stmt(loc, std::move(labels)), originalTarget(target), target(target), kind(kind) {
+		: Stmt(NodeKind::BranchStmt, loc, std::move(labels)), originalTarget(target), target(target), kind(kind) {
 	// Make sure a syntax error hasn't slipped through.
 	assert( Goto != kind || !target.empty() );
 }
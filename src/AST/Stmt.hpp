@@ -38,8 +38,8 @@ class Stmt : public ParseNode {
   public:
 	std::vector<Label> labels;
 
-	Stmt( const CodeLocation & loc, const std::vector<Label> && labels = {} )
-		: ParseNode(loc), labels(std::move(labels)) {}
+	Stmt( NodeKind nodeKind, const CodeLocation & loc, const std::vector<Label> && labels = {} )
+		: ParseNode(nodeKind, loc), labels(std::move(labels)) {}
 
 	Stmt(const Stmt & o) : ParseNode(o), labels(o.labels) {}
 
@@ -57,8 +57,8 @@ class StmtClause : public ParseNode {
 	// (and should) be folded into the approprate parent node, but if they
 	// cannot be, they are sub-types of this type, for organization.
 
-	StmtClause( const CodeLocation & loc )
-		: ParseNode(loc) {}
+	StmtClause( NodeKind nodeKind, const CodeLocation & loc )
+		: ParseNode(nodeKind, loc) {}
 
   private:
 	StmtClause * clone() const override = 0;
@@ -71,7 +71,7 @@ class CompoundStmt final : public Stmt {
 	std::list<ptr<Stmt>> kids;
 
 	CompoundStmt(const CodeLocation & loc, const std::list<ptr<Stmt>> && ks = {}, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), kids(std::move(ks)) {}
+		: Stmt(NodeKind::CompoundStmt, loc, std::move(labels)), kids(std::move(ks)) {}
 
 	CompoundStmt( const CompoundStmt & o );
 	CompoundStmt( CompoundStmt && o ) = default;
@@ -89,7 +89,7 @@ class CompoundStmt final : public Stmt {
 class NullStmt final : public Stmt {
   public:
 	NullStmt( const CodeLocation & loc, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)) {}
+		: Stmt(NodeKind::NullStmt, loc, std::move(labels)) {}
 
 	const NullStmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -103,7 +103,7 @@ class ExprStmt final : public Stmt {
 	ptr<Expr> expr;
 
 	ExprStmt( const CodeLocation & loc, const Expr* e, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), expr(e) {}
+		: Stmt(NodeKind::ExprStmt, loc, std::move(labels)), expr(e) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -124,7 +124,7 @@ class AsmStmt final : public Stmt {
 			 const std::vector<ptr<Expr>> && output, const std::vector<ptr<Expr>> && input,
 			 const std::vector<ptr<ConstantExpr>> && clobber, const std::vector<Label> && gotoLabels,
 			 const std::vector<Label> && labels = {})
-		: Stmt(loc, std::move(labels)), isVolatile(isVolatile), instruction(instruction),
+		: Stmt(NodeKind::AsmStmt, loc, std::move(labels)), isVolatile(isVolatile), instruction(instruction),
 		  output(std::move(output)), input(std::move(input)), clobber(std::move(clobber)),
 		  gotoLabels(std::move(gotoLabels)) {}
 
@@ -141,7 +141,7 @@ class DirectiveStmt final : public Stmt {
 
 	DirectiveStmt( const CodeLocation & loc, const std::string & directive,
 				   std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), directive(directive) {}
+		: Stmt(NodeKind::DirectiveStmt, loc, std::move(labels)), directive(directive) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -160,7 +160,7 @@ class IfStmt final : public Stmt {
 	IfStmt( const CodeLocation & loc, const Expr * cond, const Stmt * then,
 			const Stmt * else_ = nullptr, const std::vector<ptr<Stmt>> && inits = {},
 			const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), cond(cond), then(then), else_(else_),
+		: Stmt(NodeKind::IfStmt, loc, std::move(labels)), cond(cond), then(then), else_(else_),
 		  inits(std::move(inits)) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
@@ -178,7 +178,7 @@ class SwitchStmt final : public Stmt {
 	SwitchStmt( const CodeLocation & loc, const Expr * cond,
 				const std::vector<ptr<CaseClause>> && cases,
 				const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), cond(cond), cases(std::move(cases)) {}
+		: Stmt(NodeKind::SwitchStmt, loc, std::move(labels)), cond(cond), cases(std::move(cases)) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -194,7 +194,7 @@ class CaseClause final : public StmtClause {
 	std::vector<ptr<Stmt>> stmts;
 
 	CaseClause( const CodeLocation & loc, const Expr * cond, const std::vector<ptr<Stmt>> && stmts )
-		: StmtClause(loc), cond(cond), stmts(std::move(stmts)) {}
+		: StmtClause(NodeKind::CaseClause, loc), cond(cond), stmts(std::move(stmts)) {}
 
 	bool isDefault() const { return !cond; }
 
@@ -218,11 +218,11 @@ class WhileDoStmt final : public Stmt {
 
 	WhileDoStmt( const CodeLocation & loc, const Expr * cond, const Stmt * body,
 				 const std::vector<ptr<Stmt>> && inits, WhileDoKind isDoWhile = While, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), cond(cond), body(body), else_(nullptr), inits(std::move(inits)), isDoWhile(isDoWhile) {}
+		: Stmt(NodeKind::WhileDoStmt, loc, std::move(labels)), cond(cond), body(body), else_(nullptr), inits(std::move(inits)), isDoWhile(isDoWhile) {}
 
 	WhileDoStmt( const CodeLocation & loc, const Expr * cond, const Stmt * body, const Stmt * else_,
 				 const std::vector<ptr<Stmt>> && inits, WhileDoKind isDoWhile = While, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), cond(cond), body(body), else_(else_), inits(std::move(inits)), isDoWhile(isDoWhile) {}
+		: Stmt(NodeKind::WhileDoStmt, loc, std::move(labels)), cond(cond), body(body), else_(else_), inits(std::move(inits)), isDoWhile(isDoWhile) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -241,12 +241,12 @@ class ForStmt final : public Stmt {
 
 	ForStmt( const CodeLocation & loc, const std::vector<ptr<Stmt>> && inits, const Expr * cond,
 			 const Expr * inc, const Stmt * body, const std::vector<Label> && label = {} )
-		: Stmt(loc, std::move(label)), inits(std::move(inits)), cond(cond), inc(inc),
+		: Stmt(NodeKind::ForStmt, loc, std::move(label)), inits(std::move(inits)), cond(cond), inc(inc),
 		body(body), else_(nullptr) {}
 
 	ForStmt( const CodeLocation & loc, const std::vector<ptr<Stmt>> && inits, const Expr * cond,
 			 const Expr * inc, const Stmt * body, const Stmt * else_, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), inits(std::move(inits)), cond(cond), inc(inc),
+		: Stmt(NodeKind::ForStmt, loc, std::move(labels)), inits(std::move(inits)), cond(cond), inc(inc),
 		body(body), else_(else_) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
@@ -270,7 +270,7 @@ class ForeachStmt final : public Stmt {
 	ForeachStmt( const CodeLocation & loc, const std::vector<ptr<Stmt>> && inits,
 			const Expr * range_over, RangeDirection isInc, const Stmt * body,
 			const Stmt * else_, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), inits(std::move(inits)), range(range_over),
+		: Stmt(NodeKind::ForeachStmt, loc, std::move(labels)), inits(std::move(inits)), range(range_over),
 		body(body), else_(else_), isIncreasing(isInc) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
@@ -292,7 +292,7 @@ class BranchStmt final : public Stmt {
 
 	BranchStmt( const CodeLocation & loc, Kind kind, Label target, const std::vector<Label> && labels = {} );
 	BranchStmt( const CodeLocation & loc, const Expr * computedTarget, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), originalTarget(loc), target(loc), computedTarget(computedTarget), kind(Goto) {}
+		: Stmt(NodeKind::BranchStmt, loc, std::move(labels)), originalTarget(loc), target(loc), computedTarget(computedTarget), kind(Goto) {}
 
 	const char * kindName() const { return kindNames[kind]; }
 
@@ -310,7 +310,7 @@ class ReturnStmt final : public Stmt {
 	ptr<Expr> expr;
 
 	ReturnStmt( const CodeLocation & loc, const Expr * expr, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), expr(expr) {}
+		: Stmt(NodeKind::ReturnStmt, loc, std::move(labels)), expr(expr) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -330,7 +330,7 @@ class ThrowStmt final : public Stmt {
 
 	ThrowStmt( const CodeLocation & loc, ExceptionKind kind, const Expr * expr,
 			   const Expr * target, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), expr(expr), target(target), kind(kind) {}
+		: Stmt(NodeKind::ThrowStmt, loc, std::move(labels)), expr(expr), target(target), kind(kind) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -348,7 +348,7 @@ class TryStmt final : public Stmt {
 	TryStmt( const CodeLocation & loc, const CompoundStmt * body,
 			 const std::vector<ptr<CatchClause>> && handlers, const FinallyClause * finally,
 			 const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), body(body), handlers(std::move(handlers)), finally(finally) {}
+		: Stmt(NodeKind::TryStmt, loc, std::move(labels)), body(body), handlers(std::move(handlers)), finally(finally) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -366,7 +366,7 @@ class CatchClause final : public StmtClause {
 
 	CatchClause( const CodeLocation & loc, ExceptionKind kind, const Decl * decl, const Expr * cond,
 			const Stmt * body )
-		: StmtClause(loc), decl(decl), cond(cond), body(body), kind(kind) {}
+		: StmtClause(NodeKind::CatchClause, loc), decl(decl), cond(cond), body(body), kind(kind) {}
 
 	const CatchClause * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -380,7 +380,7 @@ class FinallyClause final : public StmtClause {
 	ptr<CompoundStmt> body;
 
 	FinallyClause( const CodeLocation & loc, const CompoundStmt * body )
-		: StmtClause(loc), body(body) {}
+		: StmtClause(NodeKind::FinallyClause, loc), body(body) {}
 
 	const FinallyClause * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -395,7 +395,7 @@ class SuspendStmt final : public Stmt {
 	enum Kind { None, Coroutine, Generator } kind = None;
 
 	SuspendStmt( const CodeLocation & loc, const CompoundStmt * then, Kind kind, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), then(then), kind(kind) {}
+		: Stmt(NodeKind::SuspendStmt, loc, std::move(labels)), then(then), kind(kind) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -413,8 +413,8 @@ class WaitStmt : public Stmt {
 	ptr<Stmt> else_stmt;
 	ptr<Expr> else_cond;
 
-	WaitStmt( const CodeLocation & loc, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)) {}
+	WaitStmt( NodeKind nodeKind, const CodeLocation & loc, const std::vector<Label> && labels = {} )
+		: Stmt(nodeKind, loc, std::move(labels)) {}
 
   private:
 	WaitStmt * clone() const override = 0;
@@ -430,9 +430,12 @@ class WhenClause : public StmtClause {
 	ptr<Expr> when_cond;
 
 	WhenClause( const CodeLocation & loc )
-		: StmtClause( loc ) {}
+		: StmtClause( NodeKind::WhenClause, loc ) {}
 
 	const WhenClause * accept( Visitor & v ) const override { return v.visit( this ); }
+  protected:
+	WhenClause( NodeKind nodeKind, const CodeLocation & loc )
+		: StmtClause( nodeKind, loc ) {}
   private:
 	WhenClause * clone() const override { return new WhenClause{ *this }; }
 	MUTATE_FRIEND
@@ -444,7 +447,7 @@ class WaitForStmt final : public WaitStmt {
 	std::vector<ptr<WaitForClause>> clauses;
 
 	WaitForStmt( const CodeLocation & loc, const std::vector<Label> && labels = {} )
-		: WaitStmt(loc, std::move(labels)) {}
+		: WaitStmt(NodeKind::WaitForStmt, loc, std::move(labels)) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -458,7 +461,7 @@ class WaitForClause final : public WhenClause {
 	std::vector<ptr<Expr>> target_args;
 
 	WaitForClause( const CodeLocation & loc )
-		: WhenClause( loc ) {}
+		: WhenClause( NodeKind::WaitForClause, loc ) {}
 
 	const WaitForClause * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -502,7 +505,7 @@ class WaitUntilStmt final : public WaitStmt {
 	ClauseNode * predicateTree;
 
 	WaitUntilStmt( const CodeLocation & loc, const std::vector<Label> && labels = {} )
-		: WaitStmt(loc, std::move(labels)) {}
+		: WaitStmt(NodeKind::WaitUntilStmt, loc, std::move(labels)) {}
 
 	~WaitUntilStmt() { delete predicateTree; }
 
@@ -518,7 +521,7 @@ class DeclStmt final : public Stmt {
 	ptr<Decl> decl;
 
 	DeclStmt( const CodeLocation & loc, const Decl * decl, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), decl(decl) {}
+		: Stmt(NodeKind::DeclStmt, loc, std::move(labels)), decl(decl) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -533,7 +536,7 @@ class ImplicitCtorDtorStmt final : public Stmt {
 
 	ImplicitCtorDtorStmt( const CodeLocation & loc, const Stmt * callStmt,
 						  std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), callStmt(callStmt) {}
+		: Stmt(NodeKind::ImplicitCtorDtorStmt, loc, std::move(labels)), callStmt(callStmt) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -549,7 +552,7 @@ class MutexStmt final : public Stmt {
 
 	MutexStmt( const CodeLocation & loc, const Stmt * stmt,
 			   const std::vector<ptr<Expr>> && mutexes, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), stmt(stmt), mutexObjs(std::move(mutexes)) {}
+		: Stmt(NodeKind::MutexStmt, loc, std::move(labels)), stmt(stmt), mutexObjs(std::move(mutexes)) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -563,7 +566,7 @@ class CorunStmt final : public Stmt {
 	ptr<Stmt> stmt;
 
 	CorunStmt( const CodeLocation & loc, const Stmt * stmt, const std::vector<Label> && labels = {} )
-		: Stmt(loc, std::move(labels)), stmt(stmt) {}
+		: Stmt(NodeKind::CorunStmt, loc, std::move(labels)), stmt(stmt) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -581,7 +584,7 @@ class CoforStmt final : public Stmt {
 
 	CoforStmt( const CodeLocation & loc, const std::vector<ptr<Stmt>> && inits, const Expr * cond,
 			 const Expr * inc, const Stmt * body, const std::vector<Label> && label = {} )
-		: Stmt(loc, std::move(label)), inits(std::move(inits)), cond(cond), inc(inc), body(body) {}
+		: Stmt(NodeKind::CoforStmt, loc, std::move(label)), inits(std::move(inits)), cond(cond), inc(inc), body(body) {}
 
 	const Stmt * accept( Visitor & v ) const override { return v.visit( this ); }
   private:
@@ -123,26 +123,54 @@ SymbolTable::SpecialFunctionKind SymbolTable::getSpecialFunctionKind(const std::
 	return NUMBER_OF_KINDS;
 }
 
-std::vector<SymbolTable::IdData> SymbolTable::lookupId( const std::string &id ) const {
+void SymbolTable::IdView::iterator::settle() {
+	while ( true ) {
+		for ( ; inner != MangleTable::iterator() ; ++inner ) {
+			if ( ! skipHidden || ! inner->second.id || ! inner->second.id->isHidden ) return;
+		}
+		if ( ! nested || ++outer == IdTable::iterator() ) {
+			done = true;
+			return;
+		}
+		inner = outer->second->begin();
+	}
+}
+
+SymbolTable::IdView::iterator SymbolTable::IdView::begin() const {
+	iterator it;
+	it.skipHidden = skipHidden;
+	if ( tables ) {
+		it.nested = true;
+		it.outer = tables->begin();
+		if ( it.outer == tables->end() ) return it;
+		it.inner = it.outer->second->begin();
+	} else if ( table ) {
+		it.inner = table->begin();
+	} else {
+		return it;
+	}
+	it.done = false;
+	it.settle();
+	return it;
+}
+
+SymbolTable::IdView SymbolTable::lookupIdView( const std::string &id ) const {
 	static Stats::Counters::CounterGroup * name_lookup_stats = Stats::Counters::build<Stats::Counters::CounterGroup>("Name Lookup Stats");
 	static std::map<std::string, Stats::Counters::SimpleCounter *> lookups_by_name;
 	static std::map<std::string, Stats::Counters::SimpleCounter *> candidates_by_name;
 
 	SpecialFunctionKind kind = getSpecialFunctionKind(id);
-	if (kind != NUMBER_OF_KINDS) return specialLookupId(kind);
+	if (kind != NUMBER_OF_KINDS) return specialLookupIdView(kind);
 
 	++*stats().lookup_calls;
 	if ( ! idTable ) return {};
 
 	++*stats().map_lookups;
-	auto decls = idTable->find( id );
+	auto key = Symbol::find( id );
+	if ( ! key ) return {};
+	auto decls = idTable->find( *key );
 	if ( decls == idTable->end() ) return {};
 
-	std::vector<IdData> out;
-	for ( auto decl : *(decls->second) ) {
-		out.push_back( decl.second );
-	}
-
 	if (Stats::Counters::enabled) {
 		if (! lookups_by_name.count(id)) {
 			// leaks some strings, but it is because Counters do not hold them
@@ -152,25 +180,13 @@ std::vector<SymbolTable::IdData> SymbolTable::lookupId( const std::string &id )
 			candidates_by_name.emplace(id, new Stats::Counters::SimpleCounter(candidatesCounterName->c_str(), name_lookup_stats));
 		}
 		(*lookups_by_name[id]) ++;
-		*candidates_by_name[id] += out.size();
+		*candidates_by_name[id] += decls->second->size();
 	}
 
-	return out;
-}
-
-std::vector<SymbolTable::IdData> SymbolTable::lookupIdIgnoreHidden( const std::string &id ) const {
-	std::vector<IdData> out;
-	std::vector<IdData> lookupResult = lookupId(id);
-	for ( auto candidate: lookupResult) {
-		if ( candidate.id ) {
-			if (candidate.id->isHidden) continue;
-		}
-		out.push_back(candidate);
-	}
-	return out;
+	return IdView( nullptr, decls->second );
 }
 
-std::vector<SymbolTable::IdData> SymbolTable::specialLookupId( SymbolTable::SpecialFunctionKind kind, const std::string & otypeKey ) const {
+SymbolTable::IdView SymbolTable::specialLookupIdView( SymbolTable::SpecialFunctionKind kind, const std::string & otypeKey ) const {
 	static Stats::Counters::CounterGroup * special_stats = Stats::Counters::build<Stats::Counters::CounterGroup>("Special Lookups");
 	static Stats::Counters::SimpleCounter * stat_counts[3] = {
 		Stats::Counters::build<Stats::Counters::SimpleCounter>("constructor - count", special_stats),
@@ -193,37 +209,55 @@ std::vector<SymbolTable::IdData> SymbolTable::specialLookupId( SymbolTable::Spec
 	++*stats().lookup_calls;
 	if ( ! specialFunctionTable[kind] ) return {};
 
-	std::vector<IdData> out;
+	IdView out;
 
 	if (otypeKey.empty()) { // returns everything
 		++*num_lookup_without_key;
-		for (auto & table : *specialFunctionTable[kind]) {
-			for (auto & decl : *table.second) {
-				out.push_back(decl.second);
+		out = IdView( specialFunctionTable[kind], nullptr );
+		if (Stats::Counters::enabled) {
+			for (auto & table : *specialFunctionTable[kind]) {
+				*stat_candidates[kind] += table.second->size();
 			}
 		}
 	} else {
 		++*num_lookup_with_key;
 		++*stats().map_lookups;
-		auto decls = specialFunctionTable[kind]->find(otypeKey);
+		auto key = Symbol::find(otypeKey);
+		if (!key) return {};
+		auto decls = specialFunctionTable[kind]->find(*key);
 		if (decls == specialFunctionTable[kind]->end()) return {};
 
-		for (auto decl : *(decls->second)) {
-			out.push_back(decl.second);
-		}
+		out = IdView( nullptr, decls->second );
+		*stat_candidates[kind] += decls->second->size();
 	}
 
 	++*stat_counts[kind];
-	*stat_candidates[kind] += out.size();
 
 	return out;
 }
 
+std::vector<SymbolTable::IdData> SymbolTable::lookupId( const std::string &id ) const {
+	IdView view = lookupIdView( id );
+	return std::vector<IdData>( view.begin(), view.end() );
+}
+
+std::vector<SymbolTable::IdData> SymbolTable::lookupIdIgnoreHidden( const std::string &id ) const {
+	IdView view = lookupIdView( id ).withoutHidden();
+	return std::vector<IdData>( view.begin(), view.end() );
+}
+
+std::vector<SymbolTable::IdData> SymbolTable::specialLookupId( SymbolTable::SpecialFunctionKind kind, const std::string & otypeKey ) const {
+	IdView view = specialLookupIdView( kind, otypeKey );
+	return std::vector<IdData>( view.begin(), view.end() );
+}
+
 const NamedTypeDecl * SymbolTable::lookupType( const std::string &id ) const {
 	++*stats().lookup_calls;
 	if ( ! typeTable ) return nullptr;
 	++*stats().map_lookups;
-	auto it = typeTable->find( id );
+	auto key = Symbol::find( id );
+	if ( ! key ) return nullptr;
+	auto it = typeTable->find( *key );
 	return it == typeTable->end() ? nullptr : it->second.decl;
 }
 
@@ -231,7 +265,9 @@ const StructDecl * SymbolTable::lookupStruct( const std::string &id ) const {
 	++*stats().lookup_calls;
 	if ( ! structTable ) return nullptr;
 	++*stats().map_lookups;
-	auto it = structTable->find( id );
+	auto key = Symbol::find( id );
+	if ( ! key ) return nullptr;
+	auto it = structTable->find( *key );
 	return it == structTable->end() ? nullptr : it->second.decl;
 }
 
@@ -239,7 +275,9 @@ const EnumDecl * SymbolTable::lookupEnum( const std::string &id ) const {
 	++*stats().lookup_calls;
 	if ( ! enumTable ) return nullptr;
 	++*stats().map_lookups;
-	auto it = enumTable->find( id );
+	auto key = Symbol::find( id );
+	if ( ! key ) return nullptr;
+	auto it = enumTable->find( *key );
 	return it == enumTable->end() ? nullptr : it->second.decl;
 }
 
@@ -247,7 +285,9 @@ const UnionDecl * SymbolTable::lookupUnion( const std::string &id ) const {
 	++*stats().lookup_calls;
 	if ( ! unionTable ) return nullptr;
 	++*stats().map_lookups;
-	auto it = unionTable->find( id );
+	auto key = Symbol::find( id );
+	if ( ! key ) return nullptr;
+	auto it = unionTable->find( *key );
 	return it == unionTable->end() ? nullptr : it->second.decl;
 }
 
@@ -255,7 +295,9 @@ const TraitDecl * SymbolTable::lookupTrait( const std::string &id ) const {
 	++*stats().lookup_calls;
 	if ( ! traitTable ) return nullptr;
 	++*stats().map_lookups;
-	auto it = traitTable->find( id );
+	auto key = Symbol::find( id );
+	if ( ! key ) return nullptr;
+	auto it = traitTable->find( *key );
 	return it == traitTable->end() ? nullptr : it->second.decl;
 }
 
@@ -314,7 +356,7 @@ bool SymbolTable::addedDeclConflicts(
 
 void SymbolTable::addType( const NamedTypeDecl * decl ) {
 	++*stats().add_calls;
-	const std::string &id = decl->name;
+	const Symbol id = decl->name;
 
 	if ( ! typeTable ) {
 		typeTable = TypeTable::new_ptr();
@@ -337,7 +379,7 @@ void SymbolTable::addStructId( const std::string &id ) {
 
 void SymbolTable::addStruct( const StructDecl * decl ) {
 	++*stats().add_calls;
-	const std::string &id = decl->name;
+	const Symbol id = decl->name;
 
 	if ( ! structTable ) {
 		structTable = StructTable::new_ptr();
@@ -356,7 +398,7 @@ void SymbolTable::addStruct( const StructDecl * decl ) {
 
 void SymbolTable::addEnum( const EnumDecl *decl ) {
 	++*stats().add_calls;
-	const std::string &id = decl->name;
+	const Symbol id = decl->name;
 
 	if ( ! enumTable ) {
 		enumTable = EnumTable::new_ptr();
@@ -379,7 +421,7 @@ void SymbolTable::addUnionId( const std::string &id ) {
 
 void SymbolTable::addUnion( const UnionDecl * decl ) {
 	++*stats().add_calls;
-	const std::string &id = decl->name;
+	const Symbol id = decl->name;
 
 	if ( ! unionTable ) {
 		unionTable = UnionTable::new_ptr();
@@ -398,7 +440,7 @@ void SymbolTable::addUnion( const UnionDecl * decl ) {
 
 void SymbolTable::addTrait( const TraitDecl * decl ) {
 	++*stats().add_calls;
-	const std::string &id = decl->name;
+	const Symbol id = decl->name;
 
 	if ( ! traitTable ) {
 		traitTable = TraitTable::new_ptr();
@@ -546,7 +588,7 @@ bool SymbolTable::removeSpecialOverrides(
 	if ( dataIsUserDefinedFunc && dataIsCopyFunc ) {
 		// this is a user-defined copy function
 		// if this is the first such, delete/remove non-user-defined overloads as needed
-		std::vector< std::string > removed;
+		std::vector< Symbol > removed;
 		std::vector< MangleTable::value_type > deleted;
 		bool alreadyUserDefinedFunc = false;
 
@@ -717,7 +759,7 @@ void SymbolTable::addIdCommon(
 	if (kind == NUMBER_OF_KINDS) { // not a special decl
 		addIdToTable(decl, decl->name, idTable, handleConflicts, baseExpr, deleter);
 	} else {
-		std::string key;
+		Symbol key;
 		if (auto func = dynamic_cast<const FunctionDecl *>(decl)) {
 			key = getOtypeKey(func->type);
 		} else if (auto obj = dynamic_cast<const ObjectDecl *>(decl)) {
@@ -730,20 +772,20 @@ void SymbolTable::addIdCommon(
 }
 
 void SymbolTable::addIdToTable(
-		const DeclWithType * decl, const std::string & lookupKey,
+		const DeclWithType * decl, const Symbol & lookupKey,
 		IdTable::Ptr & table, SymbolTable::OnConflict handleConflicts,
 		const Expr * baseExpr, const Decl * deleter ) {
 	++*stats().add_calls;
-	const std::string &name = decl->name;
-	if ( name == "" ) return;
+	if ( decl->name == "" ) return;
+	const Symbol name = decl->name;
 
-	std::string mangleName;
+	Symbol mangleName;
 	if ( decl->linkage.is_overrideable ) {
 		// mangle the name without including the appropriate suffix, so overridable routines
 		// are placed into the same "bucket" as their user defined versions.
-		mangleName = Mangle::mangle( decl, Mangle::Mode{ Mangle::NoOverrideable } );
+		mangleName = Mangle::mangleCached( decl, Mangle::Mode{ Mangle::NoOverrideable } );
 	} else {
-		mangleName = Mangle::mangle( decl );
+		mangleName = Mangle::mangleCached( decl );
 	}
 
 	// this ensures that no two declarations with the same unmangled name at the same scope
@@ -831,7 +873,7 @@ void SymbolTable::addMembers(
 	}
 }
 
-bool SymbolTable::hasCompatibleCDecl( const std::string &id, const std::string &mangleName ) const {
+bool SymbolTable::hasCompatibleCDecl( const Symbol &id, const Symbol &mangleName ) const {
 	if ( ! idTable ) return false;
 
 	++*stats().map_lookups;
@@ -848,7 +890,7 @@ bool SymbolTable::hasCompatibleCDecl( const std::string &id, const std::string &
 	return false;
 }
 
-bool SymbolTable::hasIncompatibleCDecl( const std::string &id, const std::string &mangleName ) const {
+bool SymbolTable::hasIncompatibleCDecl( const Symbol &id, const Symbol &mangleName ) const {
 	if ( ! idTable ) return false;
 
 	++*stats().map_lookups;
@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <cstddef>                 // for size_t, ptrdiff_t
+#include <iterator>                // for forward_iterator_tag
 #include <memory>                  // for shared_ptr, enable_shared_from_this
 #include <vector>
 
@@ -22,6 +24,7 @@
 #include "Node.hpp"                // for ptr, readonly
 #include "Common/CodeLocation.hpp"
 #include "Common/PersistentMap.hpp"
+#include "Common/Symbol.hpp"
 
 namespace ResolvExpr {
 	class Cost;
@@ -67,13 +70,15 @@ private:
 		scoped(const D * d, unsigned long s) : decl(d), scope(s) {}
 	};
 
-	using MangleTable = PersistentMap< std::string, IdData >;
-	using IdTable = PersistentMap< std::string, MangleTable::Ptr >;
-	using TypeTable = PersistentMap< std::string, scoped<NamedTypeDecl> >;
-	using StructTable = PersistentMap< std::string, scoped<StructDecl> >;
-	using EnumTable = PersistentMap< std::string, scoped<EnumDecl> >;
-	using UnionTable = PersistentMap< std::string, scoped<UnionDecl> >;
-	using TraitTable = PersistentMap< std::string, scoped<TraitDecl> >;
+	// Keys are interned, so the hashing and comparison of (often long, mangled) names is done
+	// once when they are interned rather than on every access.
+	using MangleTable = PersistentMap< Symbol, IdData >;
+	using IdTable = PersistentMap< Symbol, MangleTable::Ptr >;
+	using TypeTable = PersistentMap< Symbol, scoped<NamedTypeDecl> >;
+	using StructTable = PersistentMap< Symbol, scoped<StructDecl> >;
+	using EnumTable = PersistentMap< Symbol, scoped<EnumDecl> >;
+	using UnionTable = PersistentMap< Symbol, scoped<UnionDecl> >;
+	using TraitTable = PersistentMap< Symbol, scoped<TraitDecl> >;
 
 	IdTable::Ptr idTable;          ///< identifier namespace
 	TypeTable::Ptr typeTable;      ///< type namespace
@@ -118,12 +123,80 @@ public:
 	void enterScope();
 	void leaveScope();
 
+	/// Declarations found by an identifier lookup, read in place from the identifier tables
+	/// rather than copied out. Holding a view keeps its tables alive, and its iterators stay
+	/// valid for as long as the view does.
+	class IdView {
+		friend class SymbolTable;
+		IdTable::Ptr tables;     ///< visit every mangle table in this table, if set
+		MangleTable::Ptr table;  ///< otherwise, visit only this mangle table
+		bool skipHidden = false; ///< skip hidden members of enumerations
+
+		IdView( IdTable::Ptr ts, MangleTable::Ptr t ) : tables( std::move( ts ) ), table( std::move( t ) ) {}
+	public:
+		class iterator {
+			friend class IdView;
+			IdTable::iterator outer;     ///< end if not nested
+			MangleTable::iterator inner;
+			bool nested = false;
+			bool skipHidden = false;
+			bool done = true;
+
+			/// Moves forward to the next visible declaration, or to the end.
+			void settle();
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = IdData;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const IdData *;
+			using reference = const IdData &;
+
+			iterator() = default;
+
+			reference operator*() const { return inner->second; }
+			pointer operator->() const { return &inner->second; }
+			iterator & operator++() { ++inner; settle(); return *this; }
+			iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; }
+
+			bool operator==( const iterator & other ) const {
+				return done ? other.done : ( ! other.done && inner == other.inner );
+			}
+			bool operator!=( const iterator & other ) const { return ! (*this == other); }
+		};
+
+		IdView() = default;
+
+		iterator begin() const;
+		iterator end() const { return iterator(); }
+		bool empty() const { return begin() == end(); }
+
+		/// The same declarations, less the hidden members of enumerations; filtered while
+		/// iterating.
+		IdView withoutHidden() const {
+			IdView ret = *this;
+			ret.skipHidden = true;
+			return ret;
+		}
+
+		/// Identifies the tables read; views with the same key and filtering visit the same
+		/// declarations, for as long as either is held.
+		const void * key() const {
+			return tables ? static_cast<const void *>( tables.get() ) : table.get();
+		}
+	};
+
+	/// Views all declarations with the given ID
+	IdView lookupIdView( const std::string &id ) const;
+	/// Views special functions associated with a type; if no key is given, views everything
+	IdView specialLookupIdView( SpecialFunctionKind kind, const std::string & otypeKey = "" ) const;
+
 	/// Gets all declarations with the given ID
 	std::vector<IdData> lookupId( const std::string &id ) const;
 	/// Gets all declarations with the given ID, ignoring hidden members from enumeration
 	std::vector<IdData> lookupIdIgnoreHidden( const std::string &id ) const;
 	/// Gets special functions associated with a type; if no key is given, returns everything
 	std::vector<IdData> specialLookupId( SpecialFunctionKind kind, const std::string & otypeKey = "" ) const;
+
 	/// Gets the top-most type declaration with the given ID
 	const NamedTypeDecl * lookupType( const std::string &id ) const;
 	/// Gets the top-most struct declaration with the given ID
@@ -244,7 +317,7 @@ private:
 
 	/// common code for addId when special decls are placed into separate tables
 	void addIdToTable(
-		const DeclWithType * decl, const std::string & lookupKey,
+		const DeclWithType * decl, const Symbol & lookupKey,
 		IdTable::Ptr & idTable, OnConflict handleConflicts,
 		const Expr * baseExpr = nullptr, const Decl * deleter = nullptr);
 
@@ -252,9 +325,9 @@ private:
 	void addMembers( const AggregateDecl * aggr, const Expr * expr, OnConflict handleConflicts );
 
 	/// returns true if there exists a declaration with C linkage and the given name with the same mangled name
-	bool hasCompatibleCDecl( const std::string &id, const std::string &mangleName ) const;
+	bool hasCompatibleCDecl( const Symbol &id, const Symbol &mangleName ) const;
 	/// returns true if there exists a declaration with C linkage and the given name with a different mangled name
-	bool hasIncompatibleCDecl( const std::string &id, const std::string &mangleName ) const;
+	bool hasIncompatibleCDecl( const Symbol &id, const Symbol &mangleName ) const;
 };
 
 }
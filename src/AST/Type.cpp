@@ -92,7 +92,7 @@ const char * BasicType::typeNames[] = {
 
 // --- FunctionType
 namespace {
-	bool containsTtype( const std::vector<ptr<Type>> & l ) {
+	bool containsTtype( const SmallVector<ptr<Type>> & l ) {
 		if ( ! l.empty() ) {
 			return Tuples::isTtype( l.back() );
 		}
@@ -120,14 +120,14 @@ std::vector<readonly<Decl>> BaseInstType::lookup( const std::string& name ) cons
 
 template<typename decl_t>
 SueInstType<decl_t>::SueInstType(
-	const base_type * b, CV::Qualifiers q, std::vector<ptr<Attribute>>&& as )
-: BaseInstType( b->name, q, std::move(as) ), base( b ) {}
+	const base_type * b, CV::Qualifiers q, SmallVector<ptr<Attribute>>&& as )
+: BaseInstType( NodeKindRange<SueInstType>::first, b->name, q, std::move(as) ), base( b ) {}
 
 template<typename decl_t>
 SueInstType<decl_t>::SueInstType(
-	const base_type * b, std::vector<ptr<Expr>> && params,
-	CV::Qualifiers q, std::vector<ptr<Attribute>> && as )
-: BaseInstType( b->name, std::move(params), q, std::move(as) ), base( b ) {}
+	const base_type * b, SmallVector<ptr<Expr>> && params,
+	CV::Qualifiers q, SmallVector<ptr<Attribute>> && as )
+: BaseInstType( NodeKindRange<SueInstType>::first, b->name, std::move(params), q, std::move(as) ), base( b ) {}
 
 template<typename decl_t>
 bool SueInstType<decl_t>::isComplete() const {
@@ -141,13 +141,13 @@ template class SueInstType<EnumDecl>;
 // --- TraitInstType
 
 TraitInstType::TraitInstType(
-	const TraitDecl * b, CV::Qualifiers q, std::vector<ptr<Attribute>>&& as )
-: BaseInstType( b->name, q, std::move(as) ), base( b ) {}
+	const TraitDecl * b, CV::Qualifiers q, SmallVector<ptr<Attribute>>&& as )
+: BaseInstType( NodeKind::TraitInstType, b->name, q, std::move(as) ), base( b ) {}
 
 // --- TypeInstType
 
 TypeInstType::TypeInstType( const TypeEnvKey & key )
-: BaseInstType(key.base->name), base(key.base), kind(key.base->kind), formal_usage(key.formal_usage), expr_id(key.expr_id) {}
+: BaseInstType(NodeKind::TypeInstType, key.base->name), base(key.base), kind(key.base->kind), formal_usage(key.formal_usage), expr_id(key.expr_id) {}
 
 bool TypeInstType::operator==( const TypeInstType & other ) const {
 	return base == other.base
@@ -156,8 +156,8 @@ bool TypeInstType::operator==( const TypeInstType & other ) const {
 }
 
 TypeInstType::TypeInstType( const TypeDecl * b,
-	CV::Qualifiers q, std::vector<ptr<Attribute>> && as )
-: BaseInstType( b->name, q, std::move(as) ), base( b ), kind( b->kind ) {}
+	CV::Qualifiers q, SmallVector<ptr<Attribute>> && as )
+: BaseInstType( NodeKind::TypeInstType, b->name, q, std::move(as) ), base( b ), kind( b->kind ) {}
 
 void TypeInstType::set_base( const TypeDecl * b ) {
 	base = b;
@@ -198,7 +198,7 @@ bool TypeEnvKey::operator<(
 // --- TupleType
 
 TupleType::TupleType( std::vector<ptr<Type>> && ts, CV::Qualifiers q )
-: Type( q ), types( std::move(ts) ) {}
+: Type( NodeKind::TupleType, q ), types( std::move(ts) ) {}
 
 bool isUnboundType(const Type * type) {
 	if (auto typeInst = dynamic_cast<const TypeInstType *>(type)) {
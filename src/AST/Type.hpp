@@ -27,6 +27,7 @@
 #include "Fwd.hpp"
 #include "Node.hpp"          // for Node, ptr, ptr_base
 #include "Visitor.hpp"
+#include "Common/SmallVector.hpp"
 
 // Must be included in *all* AST classes; should be #undef'd at the end of the file
 #define MUTATE_FRIEND \
@@ -38,10 +39,10 @@ namespace ast {
 class Type : public Node {
 public:
 	CV::Qualifiers qualifiers;
-	std::vector<ptr<Attribute>> attributes;
+	SmallVector<ptr<Attribute>> attributes;
 
-	Type( CV::Qualifiers q = {}, std::vector<ptr<Attribute>> && as = {} )
-	: qualifiers(q), attributes(std::move(as)) {}
+	Type( NodeKind nodeKind, CV::Qualifiers q = {}, SmallVector<ptr<Attribute>> && as = {} )
+	: Node( nodeKind ), qualifiers(q), attributes(std::move(as)) {}
 
 	bool is_const() const { return qualifiers.is_const; }
 	bool is_volatile() const { return qualifiers.is_volatile; }
@@ -99,7 +100,7 @@ void remove_qualifiers( ptr_base< Type, ref_t > & p, CV::Qualifiers q ) {
 /// `void`
 class VoidType final : public Type {
 public:
-	VoidType( CV::Qualifiers q = {} ) : Type( q ) {}
+	VoidType( CV::Qualifiers q = {} ) : Type( NodeKind::VoidType, q ) {}
 
 	unsigned size() const override { return 0; }
 	bool isVoid() const override { return true; }
@@ -119,8 +120,8 @@ public:
 	/// string names of basic types; generated to match with Kind
 	static const char *typeNames[];
 
-	BasicType( BasicKind k, CV::Qualifiers q = {}, std::vector<ptr<Attribute>> && as = {} )
-	: Type(q, std::move(as)), kind(k) {}
+	BasicType( BasicKind k, CV::Qualifiers q = {}, SmallVector<ptr<Attribute>> && as = {} )
+	: Type(NodeKind::BasicType, q, std::move(as)), kind(k) {}
 
 	/// Check if this type represents an integer type
 	bool isInteger() const { return kind <= MAX_INTEGER_TYPE; }
@@ -147,9 +148,9 @@ public:
 	LengthFlag isVarLen = FixedLen;
 	DimensionFlag isStatic = DynamicDim;
 
-	PointerType( const Type * b, CV::Qualifiers q = {} ) : Type(q), base(b), dimension() {}
+	PointerType( const Type * b, CV::Qualifiers q = {} ) : Type(NodeKind::PointerType, q), base(b), dimension() {}
 	PointerType( const Type * b, const Expr * d, LengthFlag vl, DimensionFlag s,
-		CV::Qualifiers q = {} ) : Type(q), base(b), dimension(d), isVarLen(vl), isStatic(s) {}
+		CV::Qualifiers q = {} ) : Type(NodeKind::PointerType, q), base(b), dimension(d), isVarLen(vl), isStatic(s) {}
 
 	// true if this pointer is actually an array
 	bool isArray() const { return isVarLen || isStatic || dimension; }
@@ -171,7 +172,7 @@ public:
 	DimensionFlag isStatic;
 
 	ArrayType( const Type * b, const Expr * d, LengthFlag vl, DimensionFlag s,
-		CV::Qualifiers q = {} ) : Type(q), base(b), dimension(d), isVarLen(vl), isStatic(s) {}
+		CV::Qualifiers q = {} ) : Type(NodeKind::ArrayType, q), base(b), dimension(d), isVarLen(vl), isStatic(s) {}
 
 	// array types are complete if they have a dimension expression or are
 	// VLAs ('*' in parameter declaration), and incomplete otherwise.
@@ -189,7 +190,7 @@ class ReferenceType final : public Type {
 public:
 	ptr<Type> base;
 
-	ReferenceType( const Type * b, CV::Qualifiers q = {} ) : Type(q), base(b) {}
+	ReferenceType( const Type * b, CV::Qualifiers q = {} ) : Type(NodeKind::ReferenceType, q), base(b) {}
 
 	unsigned referenceDepth() const override { return base->referenceDepth() + 1; }
 
@@ -211,7 +212,7 @@ public:
 	ptr<Type> child;
 
 	QualifiedType( const Type * p, const Type * c, CV::Qualifiers q = {} )
-	: Type(q), parent(p), child(c) {}
+	: Type(NodeKind::QualifiedType, q), parent(p), child(c) {}
 
 	const Type * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -222,13 +223,13 @@ private:
 /// Type of a function `[R1, R2](*)(P1, P2, P3)`
 class FunctionType final : public Type {
 public:
-	using ForallList = std::vector<ptr<TypeInstType>>;
-	using AssertionList = std::vector<ptr<VariableExpr>>;
+	using ForallList = SmallVector<ptr<TypeInstType>>;
+	using AssertionList = SmallVector<ptr<VariableExpr>>;
 	ForallList forall;
 	AssertionList assertions;
 
-	std::vector<ptr<Type>> returns;
-	std::vector<ptr<Type>> params;
+	SmallVector<ptr<Type>> returns;
+	SmallVector<ptr<Type>> params;
 
 	/// Does the function accept a variable number of arguments following the arguments specified
 	/// in the parameters list.
@@ -238,7 +239,7 @@ public:
 	ArgumentFlag isVarArgs;
 
 	FunctionType( ArgumentFlag va = FixedArgs, CV::Qualifiers q = {} )
-	: Type(q), returns(), params(), isVarArgs(va) {}
+	: Type(NodeKind::FunctionType, q), returns(), params(), isVarArgs(va) {}
 
 	FunctionType( const FunctionType & o ) = default;
 
@@ -256,18 +257,18 @@ private:
 /// base class for types that refer to types declared elsewhere (aggregates and typedefs)
 class BaseInstType : public Type {
 public:
-	std::vector<ptr<Expr>> params;
+	SmallVector<ptr<Expr>> params;
 	std::string name;
 	bool hoistType = false;
 
 	BaseInstType(
-		const std::string& n, CV::Qualifiers q = {}, std::vector<ptr<Attribute>> && as = {} )
-	: Type(q, std::move(as)), params(), name(n) {}
+		NodeKind nodeKind, const std::string& n, CV::Qualifiers q = {}, SmallVector<ptr<Attribute>> && as = {} )
+	: Type(nodeKind, q, std::move(as)), params(), name(n) {}
 
 	BaseInstType(
-		const std::string& n, std::vector<ptr<Expr>> && params,
-		CV::Qualifiers q = {}, std::vector<ptr<Attribute>> && as = {} )
-	: Type(q, std::move(as)), params(std::move(params)), name(n) {}
+		NodeKind nodeKind, const std::string& n, SmallVector<ptr<Expr>> && params,
+		CV::Qualifiers q = {}, SmallVector<ptr<Attribute>> && as = {} )
+	: Type(nodeKind, q, std::move(as)), params(std::move(params)), name(n) {}
 
 	BaseInstType( const BaseInstType & o ) = default;
 
@@ -289,15 +290,15 @@ public:
 	readonly<decl_t> base;
 
 	SueInstType(
-		const std::string& n, CV::Qualifiers q = {}, std::vector<ptr<Attribute>> && as = {} )
-	: BaseInstType( n, q, std::move(as) ), base() {}
+		const std::string& n, CV::Qualifiers q = {}, SmallVector<ptr<Attribute>> && as = {} )
+	: BaseInstType( NodeKindRange<SueInstType>::first, n, q, std::move(as) ), base() {}
 
 	SueInstType(
-		const base_type * b, CV::Qualifiers q = {}, std::vector<ptr<Attribute>> && as = {} );
+		const base_type * b, CV::Qualifiers q = {}, SmallVector<ptr<Attribute>> && as = {} );
 
 	SueInstType(
-		const base_type * b, std::vector<ptr<Expr>> && params,
-		CV::Qualifiers q = {}, std::vector<ptr<Attribute>> && as = {} );
+		const base_type * b, SmallVector<ptr<Expr>> && params,
+		CV::Qualifiers q = {}, SmallVector<ptr<Attribute>> && as = {} );
 
 	bool isComplete() const override;
 
@@ -324,11 +325,11 @@ public:
 	readonly<TraitDecl> base;
 
 	TraitInstType(
-		const std::string& n, CV::Qualifiers q = {}, std::vector<ptr<Attribute>> && as = {} )
-	: BaseInstType( n, q, std::move(as) ), base() {}
+		const std::string& n, CV::Qualifiers q = {}, SmallVector<ptr<Attribute>> && as = {} )
+	: BaseInstType( NodeKind::TraitInstType, n, q, std::move(as) ), base() {}
 
 	TraitInstType(
-		const TraitDecl * b, CV::Qualifiers q = {}, std::vector<ptr<Attribute>> && as = {} );
+		const TraitDecl * b, CV::Qualifiers q = {}, SmallVector<ptr<Attribute>> && as = {} );
 
 	// not meaningful for TraitInstType
 	bool isComplete() const override { assert(false); }
@@ -358,15 +359,15 @@ public:
 
 	TypeInstType(
 		const std::string& n, const TypeDecl * b, CV::Qualifiers q = {},
-		std::vector<ptr<Attribute>> && as = {} )
-	: BaseInstType( n, q, std::move(as) ), base( b ), kind( b->kind ) {}
+		SmallVector<ptr<Attribute>> && as = {} )
+	: BaseInstType( NodeKind::TypeInstType, n, q, std::move(as) ), base( b ), kind( b->kind ) {}
 
 	TypeInstType( const TypeDecl * b,
-		CV::Qualifiers q = {}, std::vector<ptr<Attribute>> && as = {} );
+		CV::Qualifiers q = {}, SmallVector<ptr<Attribute>> && as = {} );
 
 	TypeInstType( const std::string& n, TypeDecl::Kind k, CV::Qualifiers q = {},
-		std::vector<ptr<Attribute>> && as = {} )
-	: BaseInstType( n, q, std::move(as) ), base(), kind( k ) {}
+		SmallVector<ptr<Attribute>> && as = {} )
+	: BaseInstType( NodeKind::TypeInstType, n, q, std::move(as) ), base(), kind( k ) {}
 
 	TypeInstType( const TypeInstType & o ) = default;
 
@@ -442,7 +443,7 @@ public:
 	enum Kind { Typeof, Basetypeof } kind;
 
 	TypeofType( const Expr * e, Kind k = Typeof, CV::Qualifiers q = {} )
-	: Type(q), expr(e), kind(k) {}
+	: Type(NodeKind::TypeofType, q), expr(e), kind(k) {}
 
 	const Type * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -455,7 +456,7 @@ class VTableType final : public Type {
 public:
 	ptr<Type> base;
 
-	VTableType( const Type * b, CV::Qualifiers q = {} ) : Type(q), base(b) {}
+	VTableType( const Type * b, CV::Qualifiers q = {} ) : Type(NodeKind::VTableType, q), base(b) {}
 
 	const Type * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -466,7 +467,7 @@ private:
 /// GCC built-in varargs type
 class VarArgsType final : public Type {
 public:
-	VarArgsType( CV::Qualifiers q = {} ) : Type( q ) {}
+	VarArgsType( CV::Qualifiers q = {} ) : Type( NodeKind::VarArgsType, q ) {}
 
 	const Type * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -477,7 +478,7 @@ private:
 /// Type of zero constant `0`
 class ZeroType final : public Type {
 public:
-	ZeroType( CV::Qualifiers q = {} ) : Type( q ) {}
+	ZeroType( CV::Qualifiers q = {} ) : Type( NodeKind::ZeroType, q ) {}
 
 	const Type * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -488,7 +489,7 @@ private:
 /// Type of one constant `1`
 class OneType final : public Type {
 public:
-	OneType( CV::Qualifiers q = {} ) : Type( q ) {}
+	OneType( CV::Qualifiers q = {} ) : Type( NodeKind::OneType, q ) {}
 
 	const Type * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -499,7 +500,7 @@ private:
 /// Parent type for scope-qualified types at global scope
 class GlobalScopeType final : public Type {
 public:
-	GlobalScopeType() : Type() {}
+	GlobalScopeType() : Type( NodeKind::GlobalScopeType ) {}
 
 	const Type * accept( Visitor & v ) const override { return v.visit( this ); }
 private:
@@ -81,35 +81,119 @@ void print( std::ostream & out, const EqvClass & clz, Indenter indent ) {
 	out << std::endl;
 }
 
-const EqvClass * TypeEnvironment::lookup( const TypeEnvKey & var ) const {
-	for ( ClassList::const_iterator i = env.begin(); i != env.end(); ++i ) {
-		if ( i->vars.find( var ) != i->vars.end() ) return &*i;
+TypeEnvironment::Classes::Classes( const Classes & o )
+: list( o.list ), index(), overlapping( o.overlapping ), substitution() {}
+
+namespace {
+	/// Searches of an unindexed list before its index is built
+	const unsigned maxScans = 4;
+}
+
+TypeEnvironment::ClassList::iterator TypeEnvironment::Classes::find( const TypeEnvKey & var ) {
+	if ( ! indexed && ! overlapping && maxScans < ++scans ) buildIndex();
+	if ( ! indexed ) {
+		for ( ClassList::iterator i = list.begin(); i != list.end(); ++i ) {
+			if ( i->vars.count( var ) ) return i;
+		}
+		return list.end();
 	}
-	return nullptr;
+	auto entry = index.find( var );
+	return entry == index.end() ? list.end() : entry->second;
 }
 
-namespace {
-	/// Removes any class from env that intersects eqvClass
-	void filterOverlappingClasses( std::list<EqvClass> & env, const EqvClass & eqvClass ) {
-		auto i = env.begin();
-		while ( i != env.end() ) {
-			auto next = i; ++next;  // save next node in case of erasure
-
-			for ( const auto & v : eqvClass.vars ) {
-				if ( i->vars.count( v ) ) {
-					env.erase( i );  // remove overlapping class
-					break;           // done with this class
-				}
+void TypeEnvironment::Classes::buildIndex() {
+	for ( auto i = list.begin(); i != list.end(); ++i ) {
+		for ( const auto & var : i->vars ) {
+			if ( ! index.emplace( var, i ).second ) {
+				overlapping = true;
+				index.clear();
+				return;
 			}
+		}
+	}
+	indexed = true;
+}
 
-			i = next;  // go to next node even if this removed
+void TypeEnvironment::Classes::push( EqvClass && eqvClass ) {
+	changed();
+	auto clz = list.insert( list.end(), std::move( eqvClass ) );
+	if ( ! indexed ) return;
+	for ( const auto & var : clz->vars ) {
+		if ( ! index.emplace( var, clz ).second ) {
+			overlapping = true;
+			indexed = false;
+			index.clear();
+			return;
 		}
 	}
 }
 
+void TypeEnvironment::Classes::addVar( ClassList::iterator clz, const TypeEnvKey & var ) {
+	changed();
+	if ( ! clz->vars.emplace( var ).second || ! indexed ) return;
+	if ( ! index.emplace( var, clz ).second ) {
+		overlapping = true;
+		indexed = false;
+		index.clear();
+	}
+}
+
+void TypeEnvironment::Classes::merge( ClassList::iterator to, ClassList::iterator from ) {
+	changed();
+	to->vars.insert( from->vars.begin(), from->vars.end() );
+	if ( indexed ) {
+		for ( const auto & var : from->vars ) index[ var ] = to;
+	}
+	list.erase( from );
+}
+
+void TypeEnvironment::Classes::erase( ClassList::iterator clz ) {
+	changed();
+	if ( indexed ) {
+		for ( const auto & var : clz->vars ) index.erase( var );
+	}
+	list.erase( clz );
+}
+
+TypeEnvironment::Classes & TypeEnvironment::unshare() {
+	if ( ! env ) {
+		env = std::make_shared< Classes >();
+	} else if ( env.use_count() > 1 ) {
+		env = std::make_shared< Classes >( *env );
+	} else {
+		env->changed();
+	}
+	return *env;
+}
+
+const TypeEnvironment::ClassList & TypeEnvironment::noClasses() {
+	static const ClassList none;
+	return none;
+}
+
+const TypeSubstitution & TypeEnvironment::substitution() const {
+	if ( ! env ) {
+		static const TypeSubstitution none;
+		return none;
+	}
+	if ( ! env->substitution ) {
+		env->substitution.reset( new TypeSubstitution() );
+		writeToSubstitution( *env->substitution );
+	}
+	return *env->substitution;
+}
+
+const EqvClass * TypeEnvironment::lookup( const TypeEnvKey & var ) const {
+	if ( ! env ) return nullptr;
+	auto clz = env->find( var );
+	return clz == env->list.end() ? nullptr : &*clz;
+}
+
 void TypeEnvironment::add( const FunctionType::ForallList & tyDecls ) {
+	if ( tyDecls.empty() ) return;
+	Classes & classes = unshare();
 	for ( auto & tyDecl : tyDecls ) {
-		env.emplace_back( tyDecl );
+		classes.push( EqvClass{ tyDecl } );
 	}
 }
 
@@ -120,7 +204,7 @@ void TypeEnvironment::add( const TypeSubstitution & sub ) {
 }
 
 void TypeEnvironment::writeToSubstitution( TypeSubstitution & sub ) const {
-	for ( const auto & clz : env ) {
+	for ( const auto & clz : *this ) {
 		TypeEnvKey clzRep;
 		bool first = true;
 		for ( const auto & var : clz.vars ) {
@@ -138,7 +222,15 @@ void TypeEnvironment::writeToSubstitution( TypeSubstitution & sub ) const {
 }
 
 void TypeEnvironment::simpleCombine( const TypeEnvironment & o ) {
-	env.insert( env.end(), o.env.begin(), o.env.end() );
+	if ( o.empty() ) return;
+	if ( empty() ) {
+		env = o.env;  // share until either changes
+		return;
+	}
+	Classes & classes = unshare();
+	for ( const EqvClass & c : o ) {
+		classes.push( EqvClass{ c } );
+	}
 }
 
 namespace {
@@ -185,41 +277,46 @@ bool TypeEnvironment::combine(
 		return true;
 	}
 
+	// o keeps its own reference to the classes, if shared with this environment
+	Classes & classes = unshare();
+
 	// merge classes
-	for ( const EqvClass & c : o.env ) {
+	for ( const EqvClass & c : o ) {
 		// index of typeclass in local environment bound to c
-		auto rt = env.end();
+		auto rt = classes.list.end();
 
 		// look for first existing bound variable
 		auto vt = c.vars.begin();
 		for ( ; vt != c.vars.end(); ++vt ) {
-			rt = internal_lookup( *vt );
-			if ( rt != env.end() ) break;
+			rt = classes.find( *vt );
+			if ( rt != classes.list.end() ) break;
 		}
 
-		if ( rt != env.end() ) {  // c needs to be merged into *rt
+		if ( rt != classes.list.end() ) {  // c needs to be merged into *rt
 			EqvClass & r = *rt;
 			// merge bindings
 			if ( ! mergeBound( r, c, open ) ) return false;
 			// merge previous unbound variables into this class, checking occurs if needed
 			if ( r.bound ) for ( const auto & u : c.vars ) {
 				if ( occurs( r.bound, u, *this ) ) return false;
-				r.vars.emplace( u );
-			} else { r.vars.insert( c.vars.begin(), vt ); }
+				classes.addVar( rt, u );
+			} else for ( auto ut = c.vars.begin(); ut != vt; ++ut ) {
+				classes.addVar( rt, *ut );
+			}
 			// merge subsequent variables into this class (skipping *vt, already there)
 			while ( ++vt != c.vars.end() ) {
-				auto st = internal_lookup( *vt );
-				if ( st == env.end() ) {
+				auto st = classes.find( *vt );
+				if ( st == classes.list.end() ) {
 					// unbound, safe to add if occurs
 					if ( r.bound && occurs( r.bound, *vt, *this ) ) return false;
-					r.vars.emplace( *vt );
+					classes.addVar( rt, *vt );
 				} else if ( st != rt ) {
 					// bound, but not to the same class
 					if ( ! mergeClasses( rt, st, open ) ) return false;
 				}	// ignore bound into the same class
 			}
 		} else {  // no variables in c bound; just copy up
-			env.emplace_back( c );
+			classes.push( EqvClass{ c } );
 		}
 	}
 
@@ -228,7 +325,7 @@ bool TypeEnvironment::combine(
 }
 
 void TypeEnvironment::extractOpenVars( OpenVarSet & open ) const {
-	for ( const auto & clz : env ) {
+	for ( const auto & clz : *this ) {
 		for ( const auto & var : clz.vars ) {
 			open[ var ] = clz.data;
 		}
@@ -236,13 +333,15 @@ void TypeEnvironment::extractOpenVars( OpenVarSet & open ) const {
 }
 
 void TypeEnvironment::addActual( const TypeEnvironment & actualEnv, OpenVarSet & open ) {
+	if ( actualEnv.empty() ) return;
+	Classes & classes = unshare();
 	for ( const auto & clz : actualEnv ) {
 		EqvClass c = clz;
 		c.allowWidening = false;
 		for ( const auto & var : c.vars ) {
 			open[ var ] = c.data;
 		}
-		env.emplace_back( std::move(c) );
+		classes.push( std::move(c) );
 	}
 }
 
@@ -288,30 +387,36 @@ bool TypeEnvironment::bindVar(
 	if ( ! tyVarCompatible( tyvar->second, target ) ) return false;
 	if ( occurs( target, *typeInst, *this ) ) return false;
 
-	auto it = internal_lookup( *typeInst );
-	if ( it != env.end() ) {
-		if ( it->bound ) {
+	// the classes are only copied (if shared) once a change is certain
+	const EqvClass * clz = lookup( *typeInst );
+	if ( clz ) {
+		if ( clz->bound ) {
 			// attempt to unify equivalence class type with type to bind to.
 			// equivalence class type has stripped qualifiers which must be restored
 			ptr<Type> common;
-			ptr<Type> newType = it->bound;
+			ptr<Type> newType = clz->bound;
 			reset_qualifiers( newType, typeInst->qualifiers );
 			if ( unifyInexact(
 					newType, target, *this, need, have, open,
-					widen & WidenMode{ it->allowWidening, true }, common ) ) {
+					widen & WidenMode{ clz->allowWidening, true }, common ) ) {
 				if ( common ) {
+					// unification may have changed the classes, find the class again
+					Classes & classes = unshare();
+					auto it = classes.find( *typeInst );
 					it->bound = std::move(common);
 					reset_qualifiers( it->bound );
 				}
 			} else return false;
 		} else {
+			Classes & classes = unshare();
+			auto it = classes.find( *typeInst );
 			it->bound = std::move(target);
 			reset_qualifiers( it->bound );
 			it->allowWidening = widen.first && widen.second;
 		}
 	} else {
-		env.emplace_back(
-			*typeInst, target, widen.first && widen.second, data );
+		unshare().push( EqvClass{
+			*typeInst, target, widen.first && widen.second, data } );
 	}
 	return true;
 }
@@ -321,12 +426,15 @@ bool TypeEnvironment::bindVarToVar(
 		AssertionSet & need, AssertionSet & have, const OpenVarSet & open,
 		WidenMode widen
 ) {
-	auto c1 = internal_lookup( *var1 );
-	auto c2 = internal_lookup( *var2 );
+	// the classes are only copied (if shared) once a change is certain
+	const EqvClass * c1 = lookup( *var1 );
+	const EqvClass * c2 = lookup( *var2 );
 
 	// exit early if variables already bound together
-	if ( c1 != env.end() && c1 == c2 ) {
-		c1->allowWidening &= widen;
+	if ( c1 && c1 == c2 ) {
+		if ( c1->allowWidening && ! widen ) {
+			unshare().find( *var1 )->allowWidening = false;
+		}
 		return true;
 	}
 
@@ -334,14 +442,14 @@ bool TypeEnvironment::bindVarToVar(
 	const Type * type1 = nullptr, * type2 = nullptr;
 
 	// check for existing bindings, perform occurs check
-	if ( c1 != env.end() ) {
+	if ( c1 ) {
 		if ( c1->bound ) {
 			if ( occurs( c1->bound, *var2, *this ) ) return false;
 			type1 = c1->bound;
 		}
 		widen1 = widen.first && c1->allowWidening;
 	}
-	if ( c2 != env.end() ) {
+	if ( c2 ) {
 		if ( c2->bound ) {
 			if ( occurs( c2->bound, *var1, *this ) ) return false;
 			type2 = c2->bound;
@@ -357,53 +465,69 @@ bool TypeEnvironment::bindVarToVar(
 
 		if ( unifyInexact(
 				newType1, newType2, *this, need, have, open, newWidenMode, common ) ) {
-			c1->vars.insert( c2->vars.begin(), c2->vars.end() );
-			c1->allowWidening = widen1 && widen2;
+			// unification may have changed the classes, find them again
+			Classes & classes = unshare();
+			auto it1 = classes.find( *var1 ), it2 = classes.find( *var2 );
+			if ( it1 != it2 ) classes.merge( it1, it2 );
+			it1->allowWidening = widen1 && widen2;
 			if ( common ) {
-				c1->bound = std::move(common);
-				reset_qualifiers( c1->bound );
+				it1->bound = std::move(common);
+				reset_qualifiers( it1->bound );
 			}
-			c1->data.isComplete |= data.isComplete;
-			env.erase( c2 );
+			it1->data.isComplete |= data.isComplete;
 		} else return false;
-	} else if ( c1 != env.end() && c2 != env.end() ) {
+	} else if ( c1 && c2 ) {
 		// both classes exist, at least one unbound, merge unconditionally
+		Classes & classes = unshare();
+		auto it1 = classes.find( *var1 ), it2 = classes.find( *var2 );
 		if ( type1 ) {
-			c1->vars.insert( c2->vars.begin(), c2->vars.end() );
-			c1->allowWidening = widen1;
-			c1->data.isComplete |= data.isComplete;
-			env.erase( c2 );
+			classes.merge( it1, it2 );
+			it1->allowWidening = widen1;
+			it1->data.isComplete |= data.isComplete;
 		} else {
-			c2->vars.insert( c1->vars.begin(), c1->vars.end() );
-			c2->allowWidening = widen2;
-			c2->data.isComplete |= data.isComplete;
-			env.erase( c1 );
+			classes.merge( it2, it1 );
+			it2->allowWidening = widen2;
+			it2->data.isComplete |= data.isComplete;
 		}
-	} else if ( c1 != env.end() ) {
+	} else if ( c1 ) {
 		// var2 unbound, add to env[c1]
-		c1->vars.emplace( *var2 );
-		c1->allowWidening = widen1;
-		c1->data.isComplete |= data.isComplete;
-	} else if ( c2 != env.end() ) {
+		Classes & classes = unshare();
+		auto it1 = classes.find( *var1 );
+		classes.addVar( it1, *var2 );
+		it1->allowWidening = widen1;
+		it1->data.isComplete |= data.isComplete;
+	} else if ( c2 ) {
 		// var1 unbound, add to env[c2]
-		c2->vars.emplace( *var1 );
-		c2->allowWidening = widen2;
-		c2->data.isComplete |= data.isComplete;
+		Classes & classes = unshare();
+		auto it2 = classes.find( *var2 );
+		classes.addVar( it2, *var1 );
+		it2->allowWidening = widen2;
+		it2->data.isComplete |= data.isComplete;
 	} else {
 		// neither var bound, create new class
-		env.emplace_back( *var1, *var2, widen1 && widen2, data );
+		unshare().push( EqvClass{ *var1, *var2, widen1 && widen2, data } );
 	}
 
 	return true;
 }
 
 void TypeEnvironment::forbidWidening() {
-	for ( EqvClass& c : env ) c.allowWidening = false;
+	// avoid copying shared classes that are already fixed
+	bool widening = false;
+	for ( const EqvClass & c : *this ) widening |= c.allowWidening;
+	if ( ! widening ) return;
+	for ( EqvClass& c : unshare().list ) c.allowWidening = false;
 }
 
 void TypeEnvironment::add( EqvClass && eqvClass ) {
-	filterOverlappingClasses( env, eqvClass );
-	env.emplace_back( std::move(eqvClass) );
+	Classes & classes = unshare();
+	// remove any class that intersects eqvClass
+	for ( const auto & v : eqvClass.vars ) {
+		for ( auto clz = classes.find( v ); clz != classes.list.end(); clz = classes.find( v ) ) {
+			classes.erase( clz );
+		}
+	}
+	classes.push( std::move(eqvClass) );
 }
 
 bool TypeEnvironment::mergeBound(
@@ -422,10 +546,12 @@ bool TypeEnvironment::mergeBound(
 				if ( common ) {
 					to.bound = std::move(common);
 					reset_qualifiers( to.bound );
+					env->changed();
 				}
 			} else return false; // cannot unify
 		} else {
 			to.bound = from.bound;
+			env->changed();
 		}
 	}
 
@@ -448,20 +574,12 @@ bool TypeEnvironment::mergeClasses(
 	}
 
 	// merge classes
-	r.vars.insert( s.vars.begin(), s.vars.end() );
 	r.allowWidening &= s.allowWidening;
-	env.erase( from );
+	env->merge( to, from );
 
 	return true;
 }
 
-TypeEnvironment::ClassList::iterator TypeEnvironment::internal_lookup( const TypeEnvKey & var ) {
-	for ( ClassList::iterator i = env.begin(); i != env.end(); ++i ) {
-		if ( i->vars.count( var ) ) return i;
-	}
-	return env.end();
-}
-
 void print( std::ostream & out, const TypeEnvironment & env, Indenter indent ) {
 	for ( const auto & clz : env ) {
 		print( out, clz, indent );
@@ -16,7 +16,9 @@
 #pragma once
 
 #include <iostream>
+#include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -132,7 +134,52 @@ class TypeEnvironment {
 	/// The underlying list of equivalence classes
 	using ClassList = std::list< EqvClass >;
 
-	ClassList env;
+	/// The classes in order, with an index from each variable to its class. Copies of an
+	/// environment share this until one of them changes, so copying candidates is cheap.
+	/// A copy made for a change scans the list until it has been searched a few times, as
+	/// most are changed once or twice and dropped, and only then builds the index.
+	struct Classes {
+		ClassList list;
+		std::unordered_map< TypeEnvKey, ClassList::iterator > index;
+		/// Set once the index covers every variable
+		bool indexed = false;
+		/// Set once a variable is in more than one class (simpleCombine and addActual do not
+		/// check); the index is then abandoned for the first-match scan of the list.
+		bool overlapping = false;
+		/// Searches of the list without the index
+		unsigned scans = 0;
+		/// The classes written to a substitution, built on first use and dropped on any change
+		mutable std::unique_ptr< TypeSubstitution > substitution;
+
+		Classes() = default;
+		Classes( const Classes & o );
+
+		/// Finds the (first) class containing a variable; list.end() for none such
+		ClassList::iterator find( const TypeEnvKey & var );
+		/// Indexes every variable, or sets overlapping
+		void buildIndex();
+		/// Appends a class
+		void push( EqvClass && eqvClass );
+		/// Adds a variable to a class
+		void addVar( ClassList::iterator clz, const TypeEnvKey & var );
+		/// Moves the variables of `from` into `to` and removes `from`
+		void merge( ClassList::iterator to, ClassList::iterator from );
+		/// Removes a class
+		void erase( ClassList::iterator clz );
+		/// Drops anything computed from the classes, call on every change
+		void changed() { substitution.reset(); }
+	};
+
+	/// Null for an environment with no classes
+	std::shared_ptr< Classes > env;
+
+	/// Gets the classes for modification, copying them if they are shared
+	Classes & unshare();
+
+	static const ClassList & noClasses();
+
+	/// The substitution for the environment, maintained between changes
+	const TypeSubstitution & substitution() const;
 
 public:
 	/// Finds the equivalence class containing a variable; nullptr for none such
@@ -149,19 +196,15 @@ public:
 
 	template< typename node_t >
 	auto apply( node_t && type ) const {
-		TypeSubstitution sub;
-		writeToSubstitution( sub );
-		return sub.apply( std::forward<node_t>(type) );
+		return substitution().apply( std::forward<node_t>(type) );
 	}
 
 	template< typename node_t >
 	auto applyFree( node_t && type ) const {
-		TypeSubstitution sub;
-		writeToSubstitution( sub );
-		return sub.applyFree( std::forward<node_t>(type) );
+		return substitution().applyFree( std::forward<node_t>(type) );
 	}
 
-	bool empty() const { return env.empty(); }
+	bool empty() const { return ! env || env->list.empty(); }
 
 	/// Concatenate environment onto this one; no safety checks performed
 	void simpleCombine( const TypeEnvironment & o );
@@ -195,8 +238,8 @@ public:
 	void forbidWidening();
 
 	using iterator = ClassList::const_iterator;
-	iterator begin() const { return env.begin(); }
-	iterator end() const { return env.end(); }
+	iterator begin() const { return ( env ? env->list : noClasses() ).begin(); }
+	iterator end() const { return ( env ? env->list : noClasses() ).end(); }
 
 private:
 	/// Add an equivalence class to the environment, checking for existing conflicting classes
@@ -209,9 +252,6 @@ private:
 	/// Merges two type classes from local environment, returning false if fails
 	bool mergeClasses(
 		ClassList::iterator to, ClassList::iterator from, OpenVarSet & openVars);
-
-	/// Private lookup API; returns array index of string, or env.size() for not found
-	ClassList::iterator internal_lookup( const TypeEnvKey & );
 };
 
 void print( std::ostream & out, const TypeEnvironment & env, Indenter indent = {} );
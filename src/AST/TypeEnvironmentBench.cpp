@@ -0,0 +1,114 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// TypeEnvironmentBench.cpp -- Micro-benchmark of the type environment access
+//     patterns of the candidate finder. Build with `make TypeEnvironmentBench`.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 21:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 21:00:00 2026
+// Update Count     : 0
+//
+
+#include <chrono>                  // for steady_clock, duration
+#include <cstdio>                  // for printf
+#include <cstdlib>                 // for atoi
+#include <string>                  // for string, to_string
+#include <vector>                  // for vector
+
+#include "Decl.hpp"
+#include "Type.hpp"
+#include "TypeEnvironment.hpp"
+
+using namespace ast;
+using ResolvExpr::WidenMode;
+
+namespace {
+
+/// Keeps the optimizer from dropping the work.
+volatile std::size_t sink;
+
+template<typename Step>
+void report( const char * name, int rounds, Step && step ) {
+	auto start = std::chrono::steady_clock::now();
+	std::size_t count = 0;
+	for ( int round = 0 ; round < rounds ; ++round ) count += step( round );
+	std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+	sink = count;
+	std::printf( "%-32s %10.1f ns/round\n", name, time.count() / rounds );
+}
+
+} // namespace
+
+int main( int argc, char * argv[] ) {
+	int vars = 1 < argc ? std::atoi( argv[1] ) : 16;
+	int rounds = 2 < argc ? std::atoi( argv[2] ) : 200000;
+	if ( vars < 4 ) vars = 4;
+	std::printf( "%d type variables, %d rounds\n", vars, rounds );
+
+	// forall( T0, ..., Tn ), the way a candidate's function type opens them
+	FunctionType::ForallList forall;
+	for ( int i = 0 ; i < vars ; ++i ) {
+		const TypeDecl * decl = new TypeDecl( CodeLocation(), "T" + std::to_string( i ),
+			Storage::Classes(), nullptr, TypeDecl::Dtype, true );
+		forall.emplace_back( new TypeInstType( decl ) );
+	}
+	ptr<Type> intType = new BasicType( BasicKind::SignedInt );
+	ptr<Type> pointerType = new PointerType( forall[0] );
+
+	// pairs of variables unified together, the first quarter of them bound to int
+	TypeEnvironment env;
+	env.add( forall );
+	OpenVarSet open;
+	env.extractOpenVars( open );
+	AssertionSet need, have;
+	for ( int i = 0 ; i + 1 < vars ; i += 2 ) {
+		env.bindVarToVar( forall[i], forall[i + 1], TypeData( forall[i]->base ),
+			need, have, open, WidenMode( true, true ) );
+		if ( i < vars / 4 ) {
+			env.bindVar( forall[i], intType, TypeData( forall[i]->base ),
+				need, have, open, WidenMode( true, true ) );
+		}
+	}
+
+	// copying a candidate's environment, which it does not change
+	report( "copy", rounds, [&]( int ) {
+		TypeEnvironment copy = env;
+		return copy.lookup( *forall[0] ) != nullptr;
+	} );
+
+	// unifying two variables already in one class, as repeated parameters do
+	report( "copy, same-class var to var", rounds, [&]( int ) {
+		TypeEnvironment copy = env;
+		return copy.bindVarToVar( forall[0], forall[1], TypeData( forall[0]->base ),
+			need, have, open, WidenMode( true, true ) );
+	} );
+
+	// binding an unbound class, which has to change the copy
+	report( "copy, bind unbound var", rounds, [&]( int ) {
+		TypeEnvironment copy = env;
+		return copy.bindVar( forall[vars - 1], intType, TypeData( forall[vars - 1]->base ),
+			need, have, open, WidenMode( true, true ) );
+	} );
+
+	// substituting into a type, with the substitution built by an earlier apply
+	report( "apply", rounds, [&]( int ) {
+		return env.apply( pointerType.get() ).node.get() != pointerType.get();
+	} );
+
+	// the same after a copy, which shares the substitution
+	report( "copy, apply", rounds, [&]( int ) {
+		TypeEnvironment copy = env;
+		return copy.apply( pointerType.get() ).node.get() != pointerType.get();
+	} );
+}
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
@@ -15,15 +15,16 @@
 
 #include "TypeSubstitution.hpp"
 
+#include "Expr.hpp"   // for ConstantExpr, TypeExpr
 #include "Type.hpp"   // for TypeInstType, Type, StructInstType, UnionInstType
 #include "Pass.hpp"   // for Pass, PureVisitor, WithGuards, WithVisitorRef
 
 namespace ast {
 
-TypeSubstitution::TypeSubstitution() {
+TypeSubstitution::TypeSubstitution() : Node( NodeKind::TypeSubstitution ) {
 }
 
-TypeSubstitution::TypeSubstitution( const TypeSubstitution &other ) : Node() {
+TypeSubstitution::TypeSubstitution( const TypeSubstitution &other ) : Node( NodeKind::TypeSubstitution ) {
 	initialize( other, *this );
 }
 
@@ -153,9 +154,67 @@ void TypeSubstitution::normalize() {
 	} while ( sub.core.subCount );
 }
 
+namespace {
+	/// False only if the type has no type variables, so no substitution can change it. Parts
+	/// that could hide one, such as non-constant dimensions, are assumed to have one.
+	bool mayHaveTypeVars( const Type * type ) {
+		if ( ! type->attributes.empty() ) return true;
+		switch ( type->kind() ) {
+		  case NodeKind::BasicType:
+		  case NodeKind::VoidType:
+		  case NodeKind::ZeroType:
+		  case NodeKind::OneType:
+		  case NodeKind::VarArgsType:
+			return false;
+		  case NodeKind::PointerType: {
+			auto pointer = static_cast< const PointerType * >( type );
+			return pointer->dimension || mayHaveTypeVars( pointer->base );
+		  }
+		  case NodeKind::ArrayType: {
+			auto array = static_cast< const ArrayType * >( type );
+			return ( array->dimension && ! isa< ConstantExpr >( array->dimension.get() ) )
+				|| mayHaveTypeVars( array->base );
+		  }
+		  case NodeKind::ReferenceType:
+			return mayHaveTypeVars( static_cast< const ReferenceType * >( type )->base );
+		  case NodeKind::FunctionType: {
+			auto func = static_cast< const FunctionType * >( type );
+			if ( ! func->forall.empty() || ! func->assertions.empty() ) return true;
+			for ( const ptr<Type> & ret : func->returns ) {
+				if ( mayHaveTypeVars( ret ) ) return true;
+			}
+			for ( const ptr<Type> & param : func->params ) {
+				if ( mayHaveTypeVars( param ) ) return true;
+			}
+			return false;
+		  }
+		  case NodeKind::StructInstType:
+		  case NodeKind::UnionInstType:
+		  case NodeKind::EnumInstType:
+			for ( const ptr<Expr> & param : static_cast< const BaseInstType * >( type )->params ) {
+				auto typeExpr = param.as< TypeExpr >();
+				if ( ! typeExpr || mayHaveTypeVars( typeExpr->type ) ) return true;
+			}
+			return false;
+		  case NodeKind::TupleType:
+			for ( const ptr<Type> & member : static_cast< const TupleType * >( type )->types ) {
+				if ( mayHaveTypeVars( member ) ) return true;
+			}
+			return false;
+		  default:
+			return true;
+		}
+	}
+} // namespace
+
 TypeSubstitution::ApplyResult<Node> TypeSubstitution::applyBase(
 		const Node * input, bool isFree ) const {
 	assert( input );
+	// Nothing to substitute, the traversal would return the input unchanged.
+	if ( typeMap.empty() ) return { input, 0 };
+	if ( auto type = dyn_cast< Type >( input ) ) {
+		if ( ! mayHaveTypeVars( type ) ) return { input, 0 };
+	}
 	Pass<Substituter> sub( *this, isFree );
 	const Node * output = input->accept( sub );
 	return { output, sub.core.subCount };
@@ -99,6 +99,7 @@ class TypeSubstitution : public Node {
 
 	TypeSubstitution * clone() const override { return new TypeSubstitution( *this ); }
 
+
   private:
 
 	// Mutator that performs the substitution
@@ -125,13 +126,15 @@ class TypeSubstitution : public Node {
 };
 
 template< typename FormalContainer, typename ActualContainer >
-TypeSubstitution::TypeSubstitution( FormalContainer formals, ActualContainer actuals ) {
+TypeSubstitution::TypeSubstitution( FormalContainer formals, ActualContainer actuals )
+		: Node( NodeKind::TypeSubstitution ) {
 	assert( formals.size() == actuals.size() );
 	addAll( formals.begin(), formals.end(), actuals.begin() );
 }
 
 template< typename FormalIterator, typename ActualIterator >
-TypeSubstitution::TypeSubstitution( FormalIterator formalBegin, FormalIterator formalEnd, ActualIterator actualBegin ) {
+TypeSubstitution::TypeSubstitution( FormalIterator formalBegin, FormalIterator formalEnd, ActualIterator actualBegin )
+		: Node( NodeKind::TypeSubstitution ) {
 	addAll( formalBegin, formalEnd, actualBegin );
 }
 
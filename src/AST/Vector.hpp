@@ -8,22 +8,22 @@
 //
 // Author           : Andrew Beach
 // Created On       : Thu Oct 20  9:46:00 2022
-// Last Modified By : Andrew Beach
-// Last Modified On : Thu Oct 20 10:16:00 2022
-// Update Count     : 0
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 19:00:00 2026
+// Update Count     : 1
 //
 
 #pragma once
 
-#include <vector>
-
 #include "AST/Node.hpp"
+#include "Common/SmallVector.hpp"
 
 namespace ast {
 
-/// Short hand for a vector of ast::ptr types.
-template<typename T, typename Alloc = std::allocator<ptr<T>> >
-using vector = std::vector<ptr<T>, Alloc>;
+/// Short hand for a vector of ast::ptr types. Child lists are usually short,
+/// so the first few elements are kept in the vector itself.
+template<typename T>
+using vector = SmallVector<ptr<T>>;
 
 }
 
@@ -44,6 +44,9 @@ SRC_AST = \
 	AST/LinkageSpec.hpp \
 	AST/Node.cpp \
 	AST/Node.hpp \
+	AST/NodeArena.cpp \
+	AST/NodeArena.hpp \
+	AST/NodeKind.hpp \
 	AST/ParseNode.hpp \
 	AST/Pass.cpp \
 	AST/Pass.hpp \
@@ -19,7 +19,6 @@
 #include "OperatorTable.hpp"         // for OperatorInfo, operatorLookup
 #include "CodeGen/GenType.hpp"       // for genType
 #include "Common/ToString.hpp"       // for toString
-#include "Common/UniqueName.hpp"     // for UniqueName
 
 namespace CodeGen {
 
@@ -82,7 +81,6 @@ void CodeGenerator::updateLocation( CodeLocation const & to ) {
 		       << "\"\n" << indent;
 		currentLocation = to;
 	}
-	output << std::flush;
 }
 
 void CodeGenerator::updateLocation( ast::ParseNode const * to ) {
@@ -90,7 +88,7 @@ void CodeGenerator::updateLocation( ast::ParseNode const * to ) {
 }
 
 std::ostream & CodeGenerator::LineEnder::operator()( std::ostream & os ) const {
-	os << "\n" << std::flush;
+	os << "\n";
 	cg.currentLocation.first_line++;
 	return os;
 }
@@ -100,6 +98,18 @@ CodeGenerator::CodeGenerator( std::ostream & os, const Options & options ) :
 		options( options ), printLabels( *this ), endl( *this )
 {}
 
+int anonymousNames = 0;
+bool markAnonymousNames = false;
+
+std::string newAnonymousName() {
+	int index = anonymousNames++;
+	if ( markAnonymousNames ) {
+		return "__anonymous_object" + std::string( 1, '\0' )
+			+ std::to_string( index ) + std::string( 1, '\0' );
+	}
+	return "__anonymous_object" + std::to_string( index );
+}
+
 std::string CodeGenerator::mangleName( ast::DeclWithType const * decl ) {
 	if ( !options.pretty && decl->linkage.is_mangled && decl->mangleName != "" ) {
 		return decl->scopedMangleName();
@@ -108,23 +118,6 @@ std::string CodeGenerator::mangleName( ast::DeclWithType const * decl ) {
 	}
 }
 
-void CodeGenerator::genAttributes(
-		const std::vector<ast::ptr<ast::Attribute>> & attributes ) {
-	if ( attributes.empty() ) return;
-	output << "__attribute__ ((";
-	for ( auto attr = attributes.begin() ;; ) {
-		output << (*attr)->name;
-		if ( !(*attr)->params.empty() ) {
-			output << "(";
-			genCommaList( (*attr)->params );
-			output << ")";
-		}
-		if ( ++attr == attributes.end() ) break;
-		output << ",";
-	}
-	output << ")) ";
-}
-
 void CodeGenerator::previsit( ast::Node const * ) {
 	// All traversal is manual.
 	// TODO: Which means the ast::Pass is just providing a default no visit?
@@ -231,8 +224,7 @@ ast::ObjectDecl const * CodeGenerator::postvisit(
 		auto mutDecl = ast::mutate( decl );
 		// Only generate an anonymous name when generating C code,
 		// otherwise it clutters the output too much.
-		static UniqueName name = { "__anonymous_object" };
-		mutDecl->name = name.newName();
+		mutDecl->name = newAnonymousName();
 		// Stops unused parameter warnings.
 		if ( options.anonymousUnused ) {
 			mutDecl->attributes.push_back( new ast::Attribute( "unused" ) );
@@ -162,12 +162,34 @@ public:
 	LineEnder endl;
 	void updateLocation( ast::ParseNode const * to );
 
-	template<typename T>
-	void genCommaList( std::vector<ast::ptr<T>> const & range ) {
+	/// The location the output is at, for line marks.
+	CodeLocation const & location() const { return currentLocation; }
+	/// Continue as if the output were at the location, without printing.
+	void assumeLocation( CodeLocation const & to ) { currentLocation = to; }
+
+	template<typename Range>
+	void genCommaList( Range const & range ) {
 		genCommaList( range.begin(), range.end() );
 	}
 
-	void genAttributes( std::vector<ast::ptr<ast::Attribute>> const & );
+	/// Attributes are in a std::vector on declarations and in an ast::vector
+	/// on types.
+	template<typename Range>
+	void genAttributes( Range const & attributes ) {
+		if ( attributes.empty() ) return;
+		output << "__attribute__ ((";
+		for ( auto attr = attributes.begin() ;; ) {
+			output << (*attr)->name;
+			if ( !(*attr)->params.empty() ) {
+				output << "(";
+				genCommaList( (*attr)->params );
+				output << ")";
+			}
+			if ( ++attr == attributes.end() ) break;
+			output << ",";
+		}
+		output << ")) ";
+	}
 
 private:
 	void asmName( ast::DeclWithType const * decl );
@@ -187,6 +209,17 @@ inline bool doSemicolon( ast::Decl const * decl ) {
 	return true;
 }
 
+/// Number of names given to anonymous objects so far.
+extern int anonymousNames;
+/// When set, anonymous object names end in their index between two '\0'
+/// characters instead of the number. Only a code generation worker sets it;
+/// its stream takes the marks out and passes the places of the names beside
+/// the text, for the numbers to be filled in when the text is joined.
+extern bool markAnonymousNames;
+
+/// Returns the next name for an anonymous object.
+std::string newAnonymousName();
+
 /// Returns the C-compatible name of the declaration.
 std::string genName( ast::DeclWithType const * decl );
 
@@ -0,0 +1,111 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// FdStream.cpp -- Buffered output stream writing straight to a file descriptor.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 15:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 15:00:00 2026
+// Update Count     : 0
+//
+
+#include "FdStream.hpp"
+
+#include <cerrno>      // for errno, EINTR
+#include <cstring>     // for memcpy
+#include <fcntl.h>     // for open, O_WRONLY, O_CREAT, O_TRUNC
+#include <unistd.h>    // for write, close
+
+namespace CodeGen {
+
+namespace {
+	const std::size_t bufferSize = 1 << 16;
+}
+
+FdBuf::FdBuf( int fd, bool owned ) :
+		buffer( bufferSize ), fd_( fd ), owned( owned ), good_( 0 <= fd ) {
+	setp( buffer.data(), buffer.data() + buffer.size() );
+}
+
+FdBuf::~FdBuf() {
+	drain();
+	if ( owned && 0 <= fd_ ) close( fd_ );
+}
+
+bool FdBuf::writeAll( char const * s, std::size_t n ) {
+	while ( good_ && 0 < n ) {
+		ssize_t written = write( fd_, s, n );
+		if ( written < 0 ) {
+			if ( EINTR == errno ) continue;
+			good_ = false;
+		} else {
+			s += written;
+			n -= written;
+		}
+	}
+	return good_;
+}
+
+bool FdBuf::drain() {
+	bool ret = writeAll( pbase(), pptr() - pbase() );
+	setp( buffer.data(), buffer.data() + buffer.size() );
+	return ret;
+}
+
+FdBuf::int_type FdBuf::overflow( int_type ch ) {
+	if ( !drain() ) return traits_type::eof();
+	if ( !traits_type::eq_int_type( ch, traits_type::eof() ) ) {
+		*pptr() = traits_type::to_char_type( ch );
+		pbump( 1 );
+	}
+	return traits_type::not_eof( ch );
+}
+
+std::streamsize FdBuf::xsputn( char const * s, std::streamsize n ) {
+	std::size_t size = n;
+	if ( size <= std::size_t( epptr() - pptr() ) ) {
+		std::memcpy( pptr(), s, size );
+		pbump( n );
+		return n;
+	}
+	// Large writes go around the buffer.
+	if ( !drain() ) return 0;
+	if ( buffer.size() <= size ) {
+		return writeAll( s, size ) ? n : 0;
+	}
+	std::memcpy( pptr(), s, size );
+	pbump( n );
+	return n;
+}
+
+int FdBuf::sync() {
+	return drain() ? 0 : -1;
+}
+
+FdStream::FdStream( int fd ) :
+		std::ostream( nullptr ), buf( fd, false ) {
+	rdbuf( &buf );
+}
+
+FdStream::FdStream( char const * filename ) :
+		std::ostream( nullptr ),
+		buf( open( filename, O_WRONLY | O_CREAT | O_TRUNC, 0666 ), true ) {
+	rdbuf( &buf );
+	if ( !buf.good() ) setstate( std::ios_base::failbit );
+}
+
+FdStream::~FdStream() {
+	flush();
+}
+
+} // namespace CodeGen
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
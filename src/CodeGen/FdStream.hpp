@@ -0,0 +1,67 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// FdStream.hpp -- Buffered output stream writing straight to a file descriptor.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 15:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 15:00:00 2026
+// Update Count     : 0
+//
+
+#pragma once
+
+#include <ostream>     // for ostream
+#include <streambuf>   // for streambuf
+#include <vector>      // for vector
+
+namespace CodeGen {
+
+/// Stream buffer writing to a file descriptor with write(2) once its buffer
+/// is full or on flush, without the locale and sentry work of a filebuf.
+class FdBuf final : public std::streambuf {
+public:
+	/// Writes to fd, which is closed with the buffer if owned is set.
+	FdBuf( int fd, bool owned );
+	~FdBuf();
+
+	int fd() const { return fd_; }
+	/// False once a write to the file descriptor has failed.
+	bool good() const { return good_; }
+protected:
+	int_type overflow( int_type ch ) override;
+	std::streamsize xsputn( char const * s, std::streamsize n ) override;
+	int sync() override;
+private:
+	bool drain();
+	bool writeAll( char const * s, std::size_t n );
+
+	std::vector<char> buffer;
+	int fd_;
+	bool owned;
+	bool good_ = true;
+};
+
+/// Output stream over an FdBuf.
+class FdStream final : public std::ostream {
+public:
+	/// Writes to an existing file descriptor, which is left open.
+	explicit FdStream( int fd );
+	/// Creates or truncates the named file; check fail() afterwards.
+	explicit FdStream( char const * filename );
+	~FdStream();
+private:
+	FdBuf buf;
+};
+
+} // namespace CodeGen
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
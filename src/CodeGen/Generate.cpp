@@ -14,11 +14,21 @@
 //
 #include "Generate.hpp"
 
+#include <algorithm>                 // for min
+#include <cstdlib>                   // for atoi
+#include <cstring>                   // for memchr, memcpy
 #include <iostream>                  // for ostream, endl, operator<<
 #include <list>                      // for list
-#include <string>                    // for operator<<
+#include <streambuf>                 // for streambuf
+#include <string>                    // for operator<<, string
+#include <sys/mman.h>                // for memfd_create, mmap, munmap
+#include <sys/stat.h>                // for fstat
+#include <sys/wait.h>                // for waitpid
+#include <unistd.h>                  // for fork, close, _exit
+#include <vector>                    // for vector
 
 #include "CodeGenerator.hpp"         // for CodeGenerator, doSemicolon, ...
+#include "FdStream.hpp"              // for FdStream
 #include "GenType.hpp"               // for genPrettyType
 
 using namespace std;
@@ -45,25 +55,305 @@ namespace {
 			return stmt->callStmt;
 		}
 	};
+
+	using DeclIter = std::vector<ast::Decl const *>::const_iterator;
+
+	/// Fewest declarations worth a worker process.
+	const std::size_t minDeclsPerJob = 64;
+
+	void generateDecl( ast::Pass<CodeGenerator> & cgv, std::ostream & os,
+			ast::Decl const * decl ) {
+		cgv.core.updateLocation( decl );
+		decl->accept( cgv );
+		if ( doSemicolon( decl ) ) {
+			os << ";";
+		}
+		os << cgv.core.endl;
+	}
+
+	/// Where the name of an anonymous object goes in the text of a worker,
+	/// and its index among the names the worker gave.
+	struct NamePlace {
+		std::size_t offset;
+		int index;
+	};
+
+	/// Written by a worker after its text, the places of its anonymous
+	/// object names and the file name of its location.
+	struct WorkerTrailer {
+		std::size_t filenameSize;
+		std::size_t places;
+		int line;
+		int anonymousNames;
+	};
+
+	/// Stream buffer of a worker that takes the anonymous object names
+	/// marked by newAnonymousName out of the text on its way to the file and
+	/// records where they go, so the file holds plain text and the numbers
+	/// are passed beside it. A '\0' that does not start the mark of a name
+	/// given by the worker is kept as text.
+	class NameMarkBuf final : public std::streambuf {
+	public:
+		explicit NameMarkBuf( std::streambuf * sink ) : sink( sink ) {}
+
+		/// Writes out the start of a mark left unfinished at the end.
+		void finish() {
+			if ( inMark ) put( std::string( 1, '\0' ) + mark );
+			inMark = false;
+		}
+
+		std::vector<NamePlace> const & places() const { return places_; }
+		bool good() const { return good_; }
+	protected:
+		int_type overflow( int_type ch ) override {
+			if ( traits_type::eq_int_type( ch, traits_type::eof() ) ) {
+				return traits_type::not_eof( ch );
+			}
+			char c = traits_type::to_char_type( ch );
+			return 1 == xsputn( &c, 1 ) ? ch : traits_type::eof();
+		}
+
+		std::streamsize xsputn( char const * s, std::streamsize n ) override {
+			char const * end = s + n;
+			while ( s < end ) {
+				if ( !inMark ) {
+					auto nul = static_cast<char const *>( std::memchr( s, '\0', end - s ) );
+					char const * stop = nul ? nul : end;
+					put( s, stop - s );
+					s = stop;
+					if ( nul ) {
+						inMark = true;
+						mark.clear();
+						++s;
+					}
+				} else if ( '\0' == *s ) {
+					++s;
+					endMark();
+				} else if ( '0' <= *s && *s <= '9' && mark.size() < 9 ) {
+					mark += *s++;
+				} else {
+					inMark = false;
+					put( std::string( 1, '\0' ) + mark );
+				}
+			}
+			return good_ ? n : 0;
+		}
+
+		int sync() override {
+			return good_ ? sink->pubsync() : -1;
+		}
+	private:
+		void put( char const * s, std::size_t n ) {
+			if ( good_ && std::streamsize( n ) != sink->sputn( s, n ) ) good_ = false;
+			written += n;
+		}
+		void put( std::string const & s ) { put( s.data(), s.size() ); }
+
+		/// The closing '\0' of a mark: records the name if the mark is one,
+		/// otherwise keeps the bytes and lets the '\0' open the next mark.
+		void endMark() {
+			int index = mark.empty() ? -1 : std::atoi( mark.c_str() );
+			if ( 0 <= index && index < anonymousNames ) {
+				places_.push_back( { written, index } );
+				inMark = false;
+			} else {
+				put( std::string( 1, '\0' ) + mark );
+				mark.clear();
+			}
+		}
+
+		std::streambuf * sink;
+		std::vector<NamePlace> places_;
+		std::string mark;
+		std::size_t written = 0;
+		bool inMark = false;
+		bool good_ = true;
+	};
+
+	/// A range of declarations rendered by a forked copy of the compiler,
+	/// which does not share the reference counts of the nodes.
+	struct Worker {
+		DeclIter begin, end;
+		pid_t pid = -1;
+		int fd = -1;
+	};
+
+	/// Runs in the worker: renders the declarations into its file, starting
+	/// at the location of the first one as if a line mark had just moved
+	/// there. The parent prints what is needed to get to that location.
+	[[noreturn]] void runWorker( Worker const & worker, Options const & options ) {
+		int status = 1;
+		try {
+			markAnonymousNames = true;
+			anonymousNames = 0;
+			FdStream file( worker.fd );
+			NameMarkBuf names( file.rdbuf() );
+			std::ostream out( &names );
+			ast::Pass<CodeGenerator> cgv( out, options );
+			cgv.core.assumeLocation( (*worker.begin)->location );
+			for ( auto it = worker.begin ; it != worker.end ; ++it ) {
+				generateDecl( cgv, out, *it );
+			}
+			out.flush();
+			names.finish();
+			std::vector<NamePlace> const & places = names.places();
+			std::string const & filename = cgv.core.location().filename.str();
+			WorkerTrailer trailer = { filename.size(), places.size(),
+				cgv.core.location().first_line, anonymousNames };
+			file.write( reinterpret_cast<char const *>( places.data() ),
+				places.size() * sizeof( NamePlace ) );
+			file << filename;
+			file.write( reinterpret_cast<char const *>( &trailer ), sizeof( trailer ) );
+			file.flush();
+			if ( out.good() && names.good() && file.good() ) status = 0;
+		} catch ( ... ) {
+			// The parent renders the declarations again and reports the error.
+		}
+		// Skips the destructors and the buffers copied from the parent.
+		_exit( status );
+	}
+
+	/// Checks the name places of a worker against its text and trailer.
+	bool validPlaces( char const * places, std::size_t textSize,
+			WorkerTrailer const & trailer ) {
+		std::size_t last = 0;
+		for ( std::size_t i = 0 ; i < trailer.places ; ++i ) {
+			NamePlace place;
+			std::memcpy( &place, places + i * sizeof( place ), sizeof( place ) );
+			if ( place.offset < last || textSize < place.offset
+					|| place.index < 0 || trailer.anonymousNames <= place.index ) {
+				return false;
+			}
+			last = place.offset;
+		}
+		return true;
+	}
+
+	/// Copies the text of a worker, putting in the numbers of its anonymous
+	/// object names after those given so far.
+	void copyWorkerText( std::ostream & os, char const * text, std::size_t textSize,
+			char const * places, std::size_t count ) {
+		std::size_t done = 0;
+		for ( std::size_t i = 0 ; i < count ; ++i ) {
+			NamePlace place;
+			std::memcpy( &place, places + i * sizeof( place ), sizeof( place ) );
+			os.write( text + done, place.offset - done );
+			os << anonymousNames + place.index;
+			done = place.offset;
+		}
+		os.write( text + done, textSize - done );
+	}
+
+	/// Waits for the worker and appends its text, returns false if it failed.
+	bool collectWorker( Worker const & worker, ast::Pass<CodeGenerator> & cgv,
+			std::ostream & os ) {
+		int status;
+		if ( -1 == worker.pid || -1 == waitpid( worker.pid, &status, 0 )
+				|| !WIFEXITED( status ) || 0 != WEXITSTATUS( status ) ) {
+			return false;
+		}
+		struct stat info;
+		if ( -1 == fstat( worker.fd, &info )
+				|| std::size_t( info.st_size ) < sizeof( WorkerTrailer ) ) {
+			return false;
+		}
+		std::size_t size = info.st_size;
+		void * map = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, worker.fd, 0 );
+		if ( MAP_FAILED == map ) return false;
+		char const * text = static_cast<char const *>( map );
+
+		WorkerTrailer trailer;
+		std::memcpy( &trailer, text + size - sizeof( trailer ), sizeof( trailer ) );
+		std::size_t rest = size - sizeof( trailer );
+		if ( rest < trailer.filenameSize
+				|| ( rest - trailer.filenameSize ) / sizeof( NamePlace ) < trailer.places ) {
+			munmap( map, size );
+			return false;
+		}
+		char const * filename = text + rest - trailer.filenameSize;
+		char const * places = filename - trailer.places * sizeof( NamePlace );
+		std::size_t textSize = places - text;
+		if ( !validPlaces( places, textSize, trailer ) ) {
+			munmap( map, size );
+			return false;
+		}
+
+		cgv.core.updateLocation( *worker.begin );
+		copyWorkerText( os, text, textSize, places, trailer.places );
+		anonymousNames += trailer.anonymousNames;
+		cgv.core.assumeLocation( CodeLocation(
+			std::string( filename, trailer.filenameSize ).c_str(), trailer.line ) );
+		munmap( map, size );
+		return true;
+	}
+
+	/// Renders the declarations in jobs processes. Each range starts at a
+	/// declaration that does not depend on where the output is before it,
+	/// and the ranges are joined in order, so the output is the same as
+	/// rendering them in one.
+	void generateParallel( std::vector<ast::Decl const *> const & decls,
+			ast::Pass<CodeGenerator> & cgv, std::ostream & os,
+			Options const & options, unsigned jobs ) {
+		auto canStart = [&options]( ast::Decl const * decl ) {
+			return !options.lineMarks || decl->location.isSet();
+		};
+
+		std::vector<Worker> workers;
+		DeclIter first = decls.begin();
+		for ( unsigned job = 1 ; job < jobs ; ++job ) {
+			DeclIter it = decls.begin() + decls.size() * job / jobs;
+			if ( it <= first ) continue;
+			while ( it != decls.end() && !canStart( *it ) ) ++it;
+			if ( it == decls.end() ) break;
+			if ( !workers.empty() ) workers.back().end = it;
+			workers.push_back( { it, decls.end() } );
+			first = it;
+		}
+		// Anything written before a fork must not be written again.
+		os.flush();
+		for ( Worker & worker : workers ) {
+			worker.fd = memfd_create( "cfa-codegen", MFD_CLOEXEC );
+			if ( -1 == worker.fd ) continue;
+			worker.pid = fork();
+			if ( 0 == worker.pid ) runWorker( worker, options );
+		}
+
+		DeclIter end = workers.empty() ? decls.end() : workers.front().begin;
+		for ( DeclIter it = decls.begin() ; it != end ; ++it ) {
+			generateDecl( cgv, os, *it );
+		}
+		for ( Worker const & worker : workers ) {
+			if ( !collectWorker( worker, cgv, os ) ) {
+				for ( DeclIter it = worker.begin ; it != worker.end ; ++it ) {
+					generateDecl( cgv, os, *it );
+				}
+			}
+			if ( -1 != worker.fd ) close( worker.fd );
+		}
+	}
 } // namespace
 
 void generate( ast::TranslationUnit & translationUnit, std::ostream & os, bool doIntrinsics,
-		bool pretty, bool generateC, bool lineMarks, bool printExprTypes ) {
+		bool pretty, bool generateC, bool lineMarks, bool printExprTypes, unsigned jobs ) {
 	erase_if( translationUnit.decls, shouldClean );
 	ast::Pass<TreeCleaner>::run( translationUnit );
 
-	ast::Pass<CodeGenerator> cgv( os,
-			Options( pretty, generateC, lineMarks, printExprTypes ) );
+	Options options( pretty, generateC, lineMarks, printExprTypes );
+	ast::Pass<CodeGenerator> cgv( os, options );
+	std::vector<ast::Decl const *> decls;
 	for ( auto & decl : translationUnit.decls ) {
 		if ( decl->linkage.is_generatable && (doIntrinsics || !decl->linkage.is_builtin ) ) {
-			cgv.core.updateLocation( decl );
-			decl->accept( cgv );
-			if ( doSemicolon( decl ) ) {
-				os << ";";
-			}
-			os << cgv.core.endl;
+			decls.push_back( decl );
 		}
 	}
+	if ( 1 < jobs && 2 * minDeclsPerJob <= decls.size() ) {
+		jobs = std::min<std::size_t>( jobs, decls.size() / minDeclsPerJob );
+		generateParallel( decls, cgv, os, options, jobs );
+		return;
+	}
+	for ( ast::Decl const * decl : decls ) {
+		generateDecl( cgv, os, decl );
+	}
 }
 
 } // namespace CodeGen
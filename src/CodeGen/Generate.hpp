@@ -29,8 +29,9 @@ namespace CodeGen {
 /// generateC: Make sure the output only consists of C code (allows some assertions, etc.)
 /// lineMarks: Output line marks (processed line directives) in the output.
 /// printExprTypes: Print the types of expressions in comments.
+/// jobs: Processes rendering declarations, the output does not depend on it.
 void generate( ast::TranslationUnit & transUnit, std::ostream &os, bool doIntrinsics,
-		bool pretty, bool generateC, bool lineMarks, bool printExprTypes );
+		bool pretty, bool generateC, bool lineMarks, bool printExprTypes, unsigned jobs );
 
 } // namespace CodeGen
 
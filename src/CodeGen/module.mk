@@ -23,6 +23,8 @@ SRC_CODEGEN = \
 	CodeGen/OperatorTable.hpp
 
 SRC += $(SRC_CODEGEN) \
+	CodeGen/FdStream.cpp \
+	CodeGen/FdStream.hpp \
 	CodeGen/FixMain.cpp \
 	CodeGen/FixMain.hpp \
 	CodeGen/FixNames.cpp \
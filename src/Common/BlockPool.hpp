@@ -0,0 +1,96 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// BlockPool.hpp -- Recycled storage for small objects.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 10:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 10:00:00 2026
+// Update Count     : 0
+//
+
+#pragma once
+
+#include <cassert>        // for assert
+#include <cstddef>        // for size_t, max_align_t
+#include <new>            // for operator new
+
+/// Blocks for small objects, carved out of large chunks. A released block is
+/// kept on the free list of its size class for the next block of that class.
+/// Chunks are never returned, the pool is meant to live as long as the
+/// process. The pool itself needs no destruction, so objects released during
+/// static destruction can still go back to it.
+class BlockPool {
+public:
+	/// Block sizes are multiples of this, which is also their alignment.
+	static constexpr std::size_t Align = alignof(std::max_align_t);
+	static constexpr std::size_t MaxSize = 512;
+	static constexpr std::size_t ChunkSize = 1 << 20;
+
+	/// Can blocks of this size come from a pool?
+	static constexpr bool fits( std::size_t size ) { return size <= MaxSize; }
+
+	/// Get a released block of the size class, null if there is none.
+	void * reuse( std::size_t size ) {
+		assert( fits( size ) );
+		FreeBlock *& head = freeLists[ sizeClass( size ) ];
+		FreeBlock * block = head;
+		if ( block ) head = block->next;
+		return block;
+	}
+
+	/// Get a new block of the size class.
+	void * carve( std::size_t size ) {
+		assert( fits( size ) );
+		std::size_t bytes = ( sizeClass( size ) + 1 ) * Align;
+		if ( static_cast<std::size_t>( end - next ) < bytes ) {
+			// The rest of the old chunk is left unused.
+			next = static_cast<char *>( ::operator new( ChunkSize ) );
+			end = next + ChunkSize;
+		}
+		void * block = next;
+		next += bytes;
+		return block;
+	}
+
+	/// Get a block, preferring a released one.
+	void * allocate( std::size_t size ) {
+		void * block = reuse( size );
+		return block ? block : carve( size );
+	}
+
+	/// Release a block from this pool, with the size it was allocated with.
+	void release( void * block, std::size_t size ) {
+		assert( fits( size ) );
+		FreeBlock * freed = static_cast<FreeBlock *>( block );
+		FreeBlock *& head = freeLists[ sizeClass( size ) ];
+		freed->next = head;
+		head = freed;
+	}
+
+private:
+	static constexpr std::size_t Classes = MaxSize / Align;
+
+	static constexpr std::size_t sizeClass( std::size_t size ) {
+		return size ? ( size + Align - 1 ) / Align - 1 : 0;
+	}
+
+	/// A released block, linked through its own storage.
+	struct FreeBlock {
+		FreeBlock * next;
+	};
+
+	FreeBlock * freeLists[Classes] = {};
+	char * next = nullptr;
+	char * end = nullptr;
+};
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
@@ -18,6 +18,7 @@
 #include "AST/LinkageSpec.hpp"
 #include "AST/Pass.hpp"
 #include "AST/Print.hpp"
+#include "AST/Vector.hpp"
 #include "Common/VectorMap.hpp"
 
 #include <iostream>
@@ -222,7 +223,7 @@ struct DeclStats : public ast::WithShortCircuiting {
 
 	/// Perform sub-type analysis on each subtype in an argument pack.
 	void analyzeSubPack(
-			const std::vector<ast::ptr<ast::Type>> & types, Stats & stats,
+			const ast::vector<ast::Type> & types, Stats & stats,
 			std::unordered_set<std::string> & elSeen, unsigned & n_poly,
 			bool & seen_poly, unsigned & max_depth, unsigned depth,
 			unsigned & n_subs ) {
@@ -310,7 +311,7 @@ struct DeclStats : public ast::WithShortCircuiting {
 
 	/// Update an ArgPackStats based on the list of types it repersents.
 	void analyzeArgPack(
-			const std::vector<ast::ptr<ast::Type>> & types,
+			const ast::vector<ast::Type> & types,
 			Stats & stats,
 			ArgPackStats & packStats,
 			// What are these two used for?
@@ -119,8 +119,8 @@ OutType map_range( const Range& range, Functor&& functor ) {
 	OutType out;
 
 	std::transform(
-		begin( range ),
-		end( range ),
+		std::begin( range ),
+		std::end( range ),
 		std::back_inserter( out ),
 		std::forward< Functor >( functor )
 	);
@@ -220,7 +220,7 @@ struct lambda_iterate_t {
 	std::function<Func> f;
 
 	struct iterator {
-		typedef decltype(begin(ref)) Iter;
+		typedef decltype(std::begin(ref)) Iter;
 		Iter it;
 		std::function<Func> f;
 		iterator( Iter it, std::function<Func> f ) : it(it), f(f) {}
@@ -8,24 +8,29 @@
 //
 // Author           : Aaron B. Moss
 // Created On       : Thu Mar  7 15:50:00 2019
-// Last Modified By : Aaron B. Moss
-// Last Modified On : Thu Mar  7 15:50:00 2019
-// Update Count     : 1
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 17:00:00 2026
+// Update Count     : 2
 //
 
 #pragma once
 
-#include <cassert>        // for assertf
-#include <cstddef>        // for size_t
+#include <array>          // for array
+#include <cstddef>        // for size_t, ptrdiff_t
+#include <cstdint>        // for uint32_t
 #include <functional>     // for hash, equal_to
+#include <iterator>       // for forward_iterator_tag
+#include <limits>         // for numeric_limits
 #include <memory>         // for shared_ptr, enable_shared_from_this, make_shared
-#include <unordered_map>  // for unordered_map
-#include <utility>        // for forward, move
-
-/// Wraps a hash table in a persistent data structure, using a technique based
-/// on the persistent array in Conchon & Filliatre "A Persistent Union-Find
-/// Data Structure"
-
+#include <utility>        // for forward, move, pair
+#include <vector>         // for vector
+
+/// Persistent hash map, as a hash array mapped trie (Bagwell, "Ideal Hash
+/// Trees") in the compressed layout of Steindorfer & Vinju, "Optimizing
+/// Hash-Array Mapped Tries for Fast and Lean Immutable JVM Collections".
+/// Each version shares all unchanged trie nodes with the version it was made
+/// from; updates copy only the path to the changed key, and every version can
+/// be read at any time in O(log32 n) without disturbing the others.
 template<typename Key, typename Val,
 		typename Hash = std::hash<Key>, typename Eq = std::equal_to<Key>>
 class PersistentMap
@@ -36,252 +41,376 @@ public:
 	/// Type of pointer to this class
 	using Ptr = std::shared_ptr<Self>;
 
-	/// Types of version nodes
-	enum Mode {
-		BASE,  ///< Root node of version tree
-		REM,   ///< Key removal node
-		INS,   ///< Key update node
-		UPD    ///< Key update node
-	};
+	using key_type = Key;
+	using mapped_type = Val;
+	using value_type = std::pair<const Key, Val>;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
 
 private:
-	using Base = std::unordered_map<Key, Val, Hash, Eq>;
+	/// Hash bits consumed per trie level
+	static constexpr unsigned Bits = 5;
+	/// Levels with a hash fragment; keys with equal hashes share a list below the last
+	static constexpr unsigned MaxDepth =
+		( std::numeric_limits<std::size_t>::digits + Bits - 1 ) / Bits;
+
+	struct Node;
+
+	/// Intrusive reference to a trie node. Not thread-safe, like the AST.
+	class NodeRef {
+		Node * node = nullptr;
+	public:
+		NodeRef() = default;
+		explicit NodeRef( const Node * n ) : node( const_cast<Node *>( n ) ) {
+			if ( node ) ++node->refs;
+		}
+		NodeRef( const NodeRef & o ) : NodeRef( o.node ) {}
+		NodeRef( NodeRef && o ) : node( o.node ) { o.node = nullptr; }
+		~NodeRef() { if ( node && 0 == --node->refs ) delete node; }
 
-	/// Insertion/update node
-	struct Ins {
-		Ptr base;  ///< Modified map
-		Key key;   ///< Key inserted
-		Val val;   ///< Value stored
+		NodeRef & operator= ( NodeRef o ) { std::swap( node, o.node ); return *this; }
 
-		template<typename P, typename K, typename V>
-		Ins(P&& p, K&& k, V&& v)
-		: base(std::forward<P>(p)), key(std::forward<K>(k)), val(std::forward<V>(v)) {}
+		const Node * get() const { return node; }
+		const Node * operator-> () const { return node; }
 	};
 
-	/// Removal node
-	struct Rem {
-		Ptr base;  ///< Modified map
-		Key key;   ///< Key removed
-
-		template<typename P, typename K>
-		Rem(P&& p, K&& k) : base(std::forward<P>(p)), key(std::forward<K>(k)) {}
+	/// Trie node; never changed once it is reachable from a map. Entries and
+	/// children are each kept in hash fragment order, except below MaxDepth,
+	/// where the node is an unordered list of entries with the same hash.
+	struct Node {
+		std::size_t refs = 0;
+		std::uint32_t dataMap = 0;        ///< fragments with an entry in this node
+		std::uint32_t nodeMap = 0;        ///< fragments with a child node
+		std::vector<value_type> entries;
+		std::vector<NodeRef> children;
 	};
 
-	/// Underlying storage
-	union Data {
-		char def;
-		Base base;
-		Ins ins;
-		Rem rem;
+	static unsigned fragment( std::size_t hash, unsigned depth ) {
+		return ( hash >> ( depth * Bits ) ) & ( ( 1u << Bits ) - 1 );
+	}
 
-		Data() : def('\0') {}
-		~Data() {}
-	} data;
+	/// index of the element for bit among those in map
+	static unsigned index( std::uint32_t map, std::uint32_t bit ) {
+		return __builtin_popcount( map & ( bit - 1 ) );
+	}
 
-	/// Type of node
-	mutable Mode mode;
+	static const std::size_t none = -1;
 
-	/// get mutable reference as T
+	/// Copies in to out, leaving out the element at drop and adding *add (if
+	/// non-null) before the element at pos.
 	template<typename T>
-	T& as() { return reinterpret_cast<T&>(data); }
+	static void splice( std::vector<T> & out, const std::vector<T> & in,
+			std::size_t drop, std::size_t pos = none, T * add = nullptr ) {
+		out.reserve( in.size() + ( add ? 1 : 0 ) );
+		for ( std::size_t i = 0 ; i <= in.size() ; ++i ) {
+			if ( add && i == pos ) out.push_back( std::move( *add ) );
+			if ( i < in.size() && i != drop ) out.push_back( in[i] );
+		}
+	}
 
-	/// get const reference as T
-	template<typename T>
-	const T& as() const { return reinterpret_cast<const T&>(data); }
+	/// Node with entries and children from n, where entries are modified by
+	/// the splice arguments.
+	static Node * withEntries( const Node * n, std::size_t drop, std::size_t pos = none,
+			value_type * add = nullptr ) {
+		Node * ret = new Node;
+		ret->dataMap = n->dataMap;
+		ret->nodeMap = n->nodeMap;
+		splice( ret->entries, n->entries, drop, pos, add );
+		ret->children = n->children;
+		return ret;
+	}
 
-	/// get rvalue reference as T
-	template<typename T>
-	T&& take_as() { return std::move(as<T>()); }
+	/// Subtrie holding just a and b, which differ in hash before depth or
+	/// have equal hashes.
+	static NodeRef pair( const value_type & a, std::size_t ha,
+			value_type & b, std::size_t hb, unsigned depth ) {
+		Node * ret = new Node;
+		if ( MaxDepth == depth ) {
+			ret->entries.push_back( a );
+			ret->entries.push_back( std::move( b ) );
+			return NodeRef( ret );
+		}
+		unsigned fa = fragment( ha, depth ), fb = fragment( hb, depth );
+		if ( fa == fb ) {
+			ret->nodeMap = 1u << fa;
+			ret->children.push_back( pair( a, ha, b, hb, depth + 1 ) );
+		} else {
+			ret->dataMap = ( 1u << fa ) | ( 1u << fb );
+			if ( fa < fb ) {
+				ret->entries.push_back( a );
+				ret->entries.push_back( std::move( b ) );
+			} else {
+				ret->entries.push_back( std::move( b ) );
+				ret->entries.push_back( a );
+			}
+		}
+		return NodeRef( ret );
+	}
+
+	/// Copy of n with e stored for its key; sets added if the key was new.
+	static NodeRef insert( const Node * n, std::size_t hash, unsigned depth,
+			value_type & e, bool & added ) {
+		if ( MaxDepth == depth ) {
+			for ( std::size_t i = 0 ; i < n->entries.size() ; ++i ) {
+				if ( Eq{}( n->entries[i].first, e.first ) ) {
+					return NodeRef( withEntries( n, i, i, &e ) );
+				}
+			}
+			added = true;
+			return NodeRef( withEntries( n, none, n->entries.size(), &e ) );
+		}
 
-	/// initialize as T
-	template<typename T, typename... Args>
-	void init( Args&&... args ) {
-		new( &as<T>() ) T { std::forward<Args>(args)... };
+		std::uint32_t bit = 1u << fragment( hash, depth );
+		if ( n->dataMap & bit ) {
+			unsigned i = index( n->dataMap, bit );
+			const value_type & old = n->entries[i];
+			if ( Eq{}( old.first, e.first ) ) {
+				return NodeRef( withEntries( n, i, i, &e ) );
+			}
+			// push both entries down into a new child
+			added = true;
+			NodeRef child = pair( old, Hash{}( old.first ), e, hash, depth + 1 );
+			Node * ret = new Node;
+			ret->dataMap = n->dataMap ^ bit;
+			ret->nodeMap = n->nodeMap | bit;
+			splice( ret->entries, n->entries, i );
+			splice( ret->children, n->children, none, index( ret->nodeMap, bit ), &child );
+			return NodeRef( ret );
+		} else if ( n->nodeMap & bit ) {
+			unsigned i = index( n->nodeMap, bit );
+			NodeRef child = insert( n->children[i].get(), hash, depth + 1, e, added );
+			Node * ret = new Node;
+			ret->dataMap = n->dataMap;
+			ret->nodeMap = n->nodeMap;
+			splice( ret->entries, n->entries, none );
+			splice( ret->children, n->children, i, i, &child );
+			return NodeRef( ret );
+		} else {
+			added = true;
+			Node * ret = withEntries( n, none, index( n->dataMap, bit ), &e );
+			ret->dataMap |= bit;
+			return NodeRef( ret );
+		}
 	}
 
-	/// reset as current mode
-	void reset() {
-		switch( mode ) {
-			case BASE:          as<Base>().~Base(); break;
-			case REM:           as<Rem>().~Rem();   break;
-			case INS: case UPD: as<Ins>().~Ins();   break;
+	/// Copy of n without k, or n itself if k is not present; sets removed if
+	/// k was present. Children left with a single entry are folded into
+	/// their parent, so a trie holds the same nodes for the same keys however
+	/// it was built.
+	static NodeRef remove( const Node * n, std::size_t hash, unsigned depth,
+			const Key & k, bool & removed ) {
+		if ( MaxDepth == depth ) {
+			for ( std::size_t i = 0 ; i < n->entries.size() ; ++i ) {
+				if ( Eq{}( n->entries[i].first, k ) ) {
+					removed = true;
+					return NodeRef( withEntries( n, i ) );
+				}
+			}
+			return NodeRef( n );
+		}
+
+		std::uint32_t bit = 1u << fragment( hash, depth );
+		if ( n->dataMap & bit ) {
+			unsigned i = index( n->dataMap, bit );
+			if ( ! Eq{}( n->entries[i].first, k ) ) return NodeRef( n );
+			removed = true;
+			Node * ret = withEntries( n, i );
+			ret->dataMap ^= bit;
+			return NodeRef( ret );
+		} else if ( n->nodeMap & bit ) {
+			unsigned i = index( n->nodeMap, bit );
+			NodeRef child = remove( n->children[i].get(), hash, depth + 1, k, removed );
+			if ( ! removed ) return NodeRef( n );
+			Node * ret = new Node;
+			if ( child->children.empty() && 1 == child->entries.size() ) {
+				value_type last = child->entries.front();
+				ret->dataMap = n->dataMap | bit;
+				ret->nodeMap = n->nodeMap ^ bit;
+				splice( ret->entries, n->entries, none, index( ret->dataMap, bit ), &last );
+				splice( ret->children, n->children, i );
+			} else {
+				ret->dataMap = n->dataMap;
+				ret->nodeMap = n->nodeMap;
+				splice( ret->entries, n->entries, none );
+				splice( ret->children, n->children, i, i, &child );
+			}
+			return NodeRef( ret );
+		} else {
+			return NodeRef( n );
 		}
 	}
 
-	/// reset as base
-	void reset_as_base() {
-		as<Base>().~Base();
+	/// value stored for k, or null if not present
+	const Val * lookup( const Key & k ) const {
+		std::size_t hash = Hash{}( k );
+		const Node * n = root.get();
+		for ( unsigned depth = 0 ; depth < MaxDepth ; ++depth ) {
+			std::uint32_t bit = 1u << fragment( hash, depth );
+			if ( n->dataMap & bit ) {
+				const value_type & e = n->entries[ index( n->dataMap, bit ) ];
+				return Eq{}( e.first, k ) ? &e.second : nullptr;
+			} else if ( n->nodeMap & bit ) {
+				n = n->children[ index( n->nodeMap, bit ) ].get();
+			} else {
+				return nullptr;
+			}
+		}
+		for ( const value_type & e : n->entries ) {
+			if ( Eq{}( e.first, k ) ) return &e.second;
+		}
+		return nullptr;
 	}
 
+	NodeRef root;     ///< never null
+	size_type count_; ///< number of entries
+
 public:
-	using key_type = typename Base::key_type;
-	using mapped_type = typename Base::mapped_type;
-	using value_type = typename Base::value_type;
-	using size_type = typename Base::size_type;
-	using difference_type = typename Base::difference_type;
-	using iterator = typename Base::const_iterator;
+	/// Iterator over the entries of one version; stays valid as long as that
+	/// version exists, whatever is done with the others.
+	class iterator {
+		friend class PersistentMap;
+		/// node and position in its entries, then children, on the path to
+		/// the current entry
+		struct Frame {
+			const Node * node;
+			std::size_t pos;
+		};
+		std::array<Frame, MaxDepth + 1> frames{};
+		unsigned depth = 0;  ///< frames in use; none at the end
+
+		/// advance to the next entry from the current position, if not at one
+		void settle() {
+			while ( depth ) {
+				Frame & f = frames[depth - 1];
+				std::size_t entries = f.node->entries.size();
+				if ( f.pos < entries ) return;
+				if ( f.pos - entries < f.node->children.size() ) {
+					frames[depth] = Frame{ f.node->children[f.pos - entries].get(), 0 };
+					++depth;
+				} else if ( --depth ) {
+					++frames[depth - 1].pos;
+				}
+			}
+		}
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = PersistentMap::value_type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const value_type *;
+		using reference = const value_type &;
+
+		/// the end iterator
+		iterator() = default;
+
+		reference operator* () const {
+			const Frame & f = frames[depth - 1];
+			return f.node->entries[f.pos];
+		}
+		pointer operator-> () const { return &**this; }
+
+		iterator & operator++ () {
+			++frames[depth - 1].pos;
+			settle();
+			return *this;
+		}
+		iterator operator++ (int) { iterator tmp = *this; ++*this; return tmp; }
+
+		bool operator== ( const iterator & o ) const {
+			return depth ? ( o.depth && &**this == &*o ) : ! o.depth;
+		}
+		bool operator!= ( const iterator & o ) const { return ! (*this == o); }
+	};
 
-	PersistentMap() : data(), mode(BASE) { init<Base>(); }
+	PersistentMap() : root( new Node ), count_( 0 ) {}
 
-	PersistentMap( Base&& b ) : data(), mode(BASE) { init<Base>(std::move(b)); }
+	/// Map with the given trie; use set and erase to create new versions
+	PersistentMap( NodeRef r, size_type n ) : root( std::move( r ) ), count_( n ) {}
 
 	PersistentMap( const Self& o ) = delete;
 
 	Self& operator= ( const Self& o ) = delete;
 
-	~PersistentMap() { reset(); }
-
 	/// Create a pointer to a new, empty persistent map
 	static Ptr new_ptr() { return std::make_shared<Self>(); }
 
-	/// reroot persistent map at current node
-	void reroot() const {
-		// recursive base case
-		if ( mode == BASE ) return;
-
-		// reroot base
-		Self* mut_this = const_cast<Self*>(this);
-		Ptr base = ( mode == REM ) ? mut_this->as<Rem>().base : mut_this->as<Ins>().base;
-		base->reroot();
-
-		// remove map from base
-		Base base_map = base->template take_as<Base>();
-		base->reset_as_base();
-
-		// switch base to inverse of self and mutate base map
-		switch ( mode ) {
-			case REM: {
-				Rem& self = mut_this->as<Rem>();
-				auto it = base_map.find( self.key );
-
-				base->template init<Ins>(
-						mut_this->shared_from_this(), std::move(self.key), std::move(it->second) );
-				base->mode = INS;
-
-				base_map.erase( it );
-				break;
-			}
-			case INS: {
-				Ins& self = mut_this->as<Ins>();
+	/// true iff the map is empty
+	bool empty() const { return 0 == count_; }
 
-				base->template init<Rem>( mut_this->shared_from_this(), self.key );
-				base->mode = REM;
+	/// number of entries in map
+	size_type size() const { return count_; }
+
+	/// begin iterator for map
+	iterator begin() const {
+		iterator it;
+		it.frames[0] = typename iterator::Frame{ root.get(), 0 };
+		it.depth = 1;
+		it.settle();
+		return it;
+	}
 
-				base_map.emplace( std::move(self.key), std::move(self.val) );
-				break;
+	/// end iterator for map
+	iterator end() const { return iterator(); }
+
+	/// iterator for value, or end if not present
+	iterator find(const Key& k) const {
+		iterator it;
+		std::size_t hash = Hash{}( k );
+		const Node * n = root.get();
+		for ( unsigned depth = 0 ; depth < MaxDepth ; ++depth ) {
+			std::uint32_t bit = 1u << fragment( hash, depth );
+			if ( n->dataMap & bit ) {
+				unsigned i = index( n->dataMap, bit );
+				if ( ! Eq{}( n->entries[i].first, k ) ) return end();
+				it.frames[depth] = typename iterator::Frame{ n, i };
+				it.depth = depth + 1;
+				return it;
+			} else if ( n->nodeMap & bit ) {
+				unsigned i = index( n->nodeMap, bit );
+				it.frames[depth] = typename iterator::Frame{ n, n->entries.size() + i };
+				n = n->children[i].get();
+			} else {
+				return end();
 			}
-			case UPD: {
-				Ins& self = mut_this->as<Ins>();
-				auto it = base_map.find( self.key );
-
-				base->template init<Ins>(
-						mut_this->shared_from_this(), std::move(self.key), std::move(it->second) );
-				base->mode = UPD;
-
-				it->second = std::move(self.val);
-				break;
+		}
+		for ( std::size_t i = 0 ; i < n->entries.size() ; ++i ) {
+			if ( Eq{}( n->entries[i].first, k ) ) {
+				it.frames[MaxDepth] = typename iterator::Frame{ n, i };
+				it.depth = MaxDepth + 1;
+				return it;
 			}
-			case BASE: assertf(false, "unreachable"); break;
 		}
-
-		// set base map into self
-		mut_this->reset();
-		mut_this->init<Base>( std::move(base_map) );
-		mode = BASE;
-	}
-
-private:
-	/// the base after rerooting at the current node
-	const Base& rerooted() const {
-		reroot();
-		return as<Base>();
+		return end();
 	}
 
-public:
-	/// true iff the map is empty
-	bool empty() const { return rerooted().empty(); }
-
-	/// number of entries in map
-	size_type size() const { return rerooted().size(); }
-
-	/// begin iterator for map; may be invalidated by calls to non-iteration functions
-	/// or functions on other maps in the same tree
-	iterator begin() const { return rerooted().begin(); }
-
-	/// end iterator for map; may be invalidated by calls to non-iteration functions
-	/// or functions on other maps in the same tree
-	iterator end() const { return rerooted().end(); }
-
-	/// underlying map iterator for value
-	iterator find(const Key& k) const { return rerooted().find( k ); }
-
 	/// check if value is present
-	size_type count(const Key& k) const { return rerooted().count( k ); }
+	size_type count(const Key& k) const { return lookup( k ) ? 1 : 0; }
 
 	/// get value; undefined behaviour if not present
-	const Val& get(const Key& k) const {
-		const Base& self = rerooted();
-		auto it = self.find( k );
-		return it->second;
-	}
+	const Val& get(const Key& k) const { return *lookup( k ); }
 
 	/// get value; returns default if not present
 	template<typename V>
 	Val get_or_default(const Key& k, V&& d) const {
-		const Base& self = rerooted();
-		auto it = self.find( k );
-		if ( it == self.end() ) return d;
-		else return it->second;
+		const Val * v = lookup( k );
+		if ( ! v ) return d;
+		else return *v;
 	}
 
-	/// set value, storing new map in output variable
+	/// set value, returning the new map; this map is unchanged
 	template<typename K, typename V>
 	Ptr set(K&& k, V&& v) {
-		reroot();
-
-		// transfer map to new node
-		Ptr ret = std::make_shared<Self>( take_as<Base>() );
-		reset_as_base();
-		Base& base_map = ret->template as<Base>();
-
-		// check if this is update or insert
-		auto it = base_map.find( k );
-		if ( it == base_map.end() ) {
-			// set self to REM node and insert into base
-			init<Rem>( ret, k );
-			mode = REM;
-
-			base_map.emplace_hint( it, std::forward<K>(k), std::forward<V>(v) );
-		} else {
-			// set self to UPD node and modify base
-			init<Ins>( ret, std::forward<K>(k), std::move(it->second) );
-			mode = UPD;
-
-			it->second = std::forward<V>(v);
-		}
-
-		return ret;
+		value_type e( std::forward<K>(k), std::forward<V>(v) );
+		bool added = false;
+		NodeRef r = insert( root.get(), Hash{}( e.first ), 0, e, added );
+		return std::make_shared<Self>( std::move( r ), count_ + ( added ? 1 : 0 ) );
 	}
 
-	/// remove value, storing new map in output variable; does nothing if key not in map
+	/// remove value, returning the new map; returns this map if key not in map
 	Ptr erase(const Key& k) {
-		reroot();
-
-		// exit early if key does not exist in map
-		if ( ! as<Base>().count( k ) ) return this->shared_from_this();
-
-		// transfer map to new node
-		Ptr ret = std::make_shared<Self>( take_as<Base>() );
-		reset_as_base();
-		Base& base_map = ret->template as<Base>();
-
-		// set self to INS node and remove from base
-		init<Ins>( ret, k, base_map[k] );
-		mode = INS;
-
-		base_map.erase( k );
-
-		return ret;
+		bool removed = false;
+		NodeRef r = remove( root.get(), Hash{}( k ), 0, k, removed );
+		if ( ! removed ) return this->shared_from_this();
+		return std::make_shared<Self>( std::move( r ), count_ - 1 );
 	}
 };
 
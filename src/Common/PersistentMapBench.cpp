@@ -0,0 +1,106 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// PersistentMapBench.cpp -- Micro-benchmark of the persistent map access
+//     patterns of the symbol table. Build with `make PersistentMapBench`.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 17:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 17:00:00 2026
+// Update Count     : 0
+//
+
+#include <chrono>                  // for steady_clock, duration
+#include <cstdio>                  // for printf
+#include <cstdlib>                 // for atoi
+#include <string>                  // for string, to_string
+#include <vector>                  // for vector
+
+#include "PersistentMap.hpp"
+#include "Symbol.hpp"
+
+namespace {
+
+using Table = PersistentMap< Symbol, int >;
+
+/// Keeps the optimizer from dropping the lookups.
+volatile std::size_t sink;
+
+std::vector<Symbol> names( const std::string & prefix, int n ) {
+	std::vector<Symbol> ret;
+	ret.reserve( n );
+	for ( int i = 0 ; i < n ; ++i ) ret.emplace_back( prefix + std::to_string( i ) );
+	return ret;
+}
+
+Table::Ptr extend( Table::Ptr table, const std::vector<Symbol> & keys ) {
+	for ( std::size_t i = 0 ; i < keys.size() ; ++i ) table = table->set( keys[i], i );
+	return table;
+}
+
+/// Alternates finds between versions, as the resolver does between a scope
+/// and its parent or between the symbol tables of sibling satisfaction states.
+template<typename Lookup>
+void report( const char * name, int rounds, Lookup && lookup ) {
+	auto start = std::chrono::steady_clock::now();
+	std::size_t found = 0;
+	for ( int round = 0 ; round < rounds ; ++round ) found += lookup( round );
+	std::chrono::duration<double, std::nano> time = std::chrono::steady_clock::now() - start;
+	sink = found;
+	std::printf( "%-32s %10.1f ns/round\n", name, time.count() / rounds );
+}
+
+std::size_t count( const Table::Ptr & table, const Symbol & key ) {
+	return table->find( key ) != table->end();
+}
+
+} // namespace
+
+int main( int argc, char * argv[] ) {
+	int globals = 1 < argc ? std::atoi( argv[1] ) : 20000;
+	int locals = 2 < argc ? std::atoi( argv[2] ) : 64;
+	int rounds = 3 < argc ? std::atoi( argv[3] ) : 200000;
+	std::printf( "%d global names, %d local names, %d rounds\n", globals, locals, rounds );
+
+	std::vector<Symbol> globalNames = names( "global", globals );
+	std::vector<Symbol> localNames = names( "local", locals );
+	std::vector<Symbol> otherNames = names( "other", locals );
+	Table::Ptr global = extend( Table::new_ptr(), globalNames );
+
+	// child scope with a few declarations, read alternately with its parent
+	Table::Ptr scope = extend( global, localNames );
+	report( "scope/parent ping-pong", rounds, [&]( int round ) {
+		const Symbol & key = globalNames[ round % globals ];
+		return count( scope, key ) + count( global, key );
+	} );
+
+	// sibling states made from the same table, read alternately
+	Table::Ptr left = extend( global, localNames );
+	Table::Ptr right = extend( global, otherNames );
+	report( "sibling ping-pong", rounds, [&]( int round ) {
+		const Symbol & key = globalNames[ round % globals ];
+		return count( left, key ) + count( right, key );
+	} );
+
+	// the same pattern with every lookup in one version, for comparison
+	report( "single version", rounds, [&]( int round ) {
+		const Symbol & key = globalNames[ round % globals ];
+		return count( left, key ) + count( left, key );
+	} );
+
+	// adding a declaration to one sibling, then reading the other
+	report( "sibling add/find", rounds / 10, [&]( int round ) {
+		left = left->set( localNames[ round % locals ], round );
+		return count( right, globalNames[ round % globals ] );
+	} );
+}
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
@@ -25,6 +25,7 @@
 #include "AST/Pass.hpp"
 #include "AST/TranslationUnit.hpp"
 #include "AST/Type.hpp"
+#include "AST/Vector.hpp"
 #include "CodeGen/OperatorTable.hpp"
 
 namespace {
@@ -107,9 +108,9 @@ std::string ti_name( const std::string & name ) {
 	return stripped;
 }
 
-std::vector<ast::ptr<ast::Type>> to_types(
-		const std::vector<ast::ptr<ast::Expr>> & data ) {
-	std::vector<ast::ptr<ast::Type>> ret_val;
+ast::vector<ast::Type> to_types(
+		const ast::vector<ast::Expr> & data ) {
+	ast::vector<ast::Type> ret_val;
 	ret_val.reserve( data.size() );
 	for ( auto entry : data ) {
 		if ( auto * typeExpr = entry.as<ast::TypeExpr>() ) {
@@ -121,10 +122,10 @@ std::vector<ast::ptr<ast::Type>> to_types(
 
 enum class septype { separated, terminated, preceded };
 
-template<typename V>
+template<typename V, typename Types>
 void build(
 		V & visitor,
-		const std::vector<ast::ptr<ast::Type>> & types,
+		const Types & types,
 		std::stringstream & ss,
 		septype mode );
 
@@ -412,10 +413,10 @@ struct ExprPrinter : public ast::WithShortCircuiting, ast::WithVisitorRef<ExprPr
 	// TODO: Handle ignored ImplicitCopyCtorExpr and below.
 };
 
-template<typename V>
+template<typename V, typename Types>
 void build(
 		V & visitor,
-		const std::vector<ast::ptr<ast::Type>> & types,
+		const Types & types,
 		std::stringstream & ss,
 		septype mode ) {
 	if ( types.empty() ) return;
@@ -657,7 +658,7 @@ public:
 
 		// Add information body if available.
 		if ( !decl->stmts ) return;
-		const std::vector<ast::ptr<ast::Type>> & returns =
+		const ast::vector<ast::Type> & returns =
 				decl->type->returns;
 
 		// Add the return statement.
@@ -0,0 +1,336 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// SmallVector.hpp -- Vector keeping its first few elements inline.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 19:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 19:00:00 2026
+// Update Count     : 0
+//
+
+#pragma once
+
+#include <algorithm>         // for move, move_backward, rotate, equal, lexicographical_compare
+#include <cstddef>           // for size_t, ptrdiff_t
+#include <cstdint>           // for uint32_t
+#include <initializer_list>  // for initializer_list
+#include <iterator>          // for reverse_iterator, iterator_traits, distance
+#include <new>               // for operator new, operator delete
+#include <stdexcept>         // for out_of_range
+#include <type_traits>       // for is_base_of, enable_if_t
+#include <utility>           // for forward, move
+#include <vector>            // for vector
+
+#include "Common/Stats/Heap.hpp"
+
+/// Heap trace counting the buffers of small vectors that outgrew their inline
+/// storage; shown in the Traces table of `-S heap`.
+inline std::size_t smallVectorSpillTrace() {
+	static const std::size_t id = Stats::Heap::new_stacktrace_id( "SmallVector spills" );
+	return id;
+}
+
+/// Vector with std::vector's interface that stores up to inline_capacity
+/// elements in the object itself and only allocates past that. Meant for the
+/// short child lists of AST nodes, most of which never hold more than a
+/// single element. Moves to and from std::vector are implicit, copies
+/// are explicit so they do not happen by accident.
+template<typename E>
+class SmallVector {
+public:
+	using value_type = E;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = E &;
+	using const_reference = const E &;
+	using pointer = E *;
+	using const_pointer = const E *;
+	using iterator = E *;
+	using const_iterator = const E *;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	/// Elements held without allocating: as many as fit in one pointer, which
+	/// keeps a vector of pointers the size of a std::vector. Most child lists
+	/// are empty or hold a single element, and nodes carry several of them,
+	/// so more inline storage costs more memory than the allocations it saves.
+	static constexpr size_type inline_capacity =
+		sizeof(E) < sizeof(void *) ? sizeof(void *) / sizeof(E) : 1;
+
+private:
+	template<typename It>
+	using RequireInputIter = std::enable_if_t<std::is_base_of<std::input_iterator_tag,
+		typename std::iterator_traits<It>::iterator_category>::value>;
+
+	E * data_;
+	std::uint32_t size_;
+	std::uint32_t capacity_;
+	alignas(E) unsigned char storage[inline_capacity * sizeof(E)];
+
+	E * inlineData() { return reinterpret_cast<E *>( storage ); }
+	bool isInline() const { return data_ == reinterpret_cast<const E *>( storage ); }
+
+	static E * allocate( size_type n ) {
+		Stats::Heap::stacktrace_push( smallVectorSpillTrace() );
+		void * p = ::operator new( n * sizeof(E) );
+		Stats::Heap::stacktrace_pop();
+		return static_cast<E *>( p );
+	}
+
+	/// Frees a heap buffer and goes back to the inline storage; elements
+	/// must already be destroyed.
+	void release() {
+		if ( isInline() ) return;
+		Stats::Heap::stacktrace_push( smallVectorSpillTrace() );
+		::operator delete( data_ );
+		Stats::Heap::stacktrace_pop();
+		data_ = inlineData();
+		capacity_ = inline_capacity;
+	}
+
+	void destroy( E * first, E * last ) {
+		for ( ; first != last ; ++first ) first->~E();
+	}
+
+	/// Moves the elements to a heap buffer of at least n elements.
+	void grow( size_type n ) {
+		size_type cap = std::max<size_type>( n, 2 * capacity_ );
+		E * buf = allocate( cap );
+		for ( size_type i = 0 ; i < size_ ; ++i ) new ( buf + i ) E( std::move( data_[i] ) );
+		destroy( begin(), end() );
+		release();
+		data_ = buf;
+		capacity_ = cap;
+	}
+
+	/// Takes the elements of o, which must be empty here, leaving o empty.
+	void steal( SmallVector & o ) {
+		if ( o.isInline() ) {
+			for ( size_type i = 0 ; i < o.size_ ; ++i ) new ( data_ + i ) E( std::move( o.data_[i] ) );
+			size_ = o.size_;
+			o.clear();
+		} else {
+			data_ = o.data_;
+			size_ = o.size_;
+			capacity_ = o.capacity_;
+			o.data_ = o.inlineData();
+			o.size_ = 0;
+			o.capacity_ = inline_capacity;
+		}
+	}
+
+	template<typename It>
+	void append( It first, It last ) {
+		using category = typename std::iterator_traits<It>::iterator_category;
+		if ( std::is_base_of<std::forward_iterator_tag, category>::value ) {
+			reserve( size_ + std::distance( first, last ) );
+		}
+		for ( ; first != last ; ++first ) emplace_back( *first );
+	}
+
+public:
+	SmallVector() noexcept : data_( inlineData() ), size_( 0 ), capacity_( inline_capacity ) {}
+	explicit SmallVector( size_type n ) : SmallVector() { resize( n ); }
+	SmallVector( size_type n, const E & val ) : SmallVector() { assign( n, val ); }
+	template<typename It, typename = RequireInputIter<It>>
+	SmallVector( It first, It last ) : SmallVector() { append( first, last ); }
+	SmallVector( std::initializer_list<E> il ) : SmallVector() { append( il.begin(), il.end() ); }
+	SmallVector( const SmallVector & o ) : SmallVector() { append( o.begin(), o.end() ); }
+	SmallVector( SmallVector && o ) noexcept : SmallVector() { steal( o ); }
+	explicit SmallVector( const std::vector<E> & o ) : SmallVector() { append( o.begin(), o.end() ); }
+	SmallVector( std::vector<E> && o ) : SmallVector() {
+		append( std::make_move_iterator( o.begin() ), std::make_move_iterator( o.end() ) );
+		o.clear();
+	}
+
+	~SmallVector() {
+		destroy( begin(), end() );
+		release();
+	}
+
+	SmallVector & operator= ( const SmallVector & o ) {
+		if ( this != &o ) assign( o.begin(), o.end() );
+		return *this;
+	}
+	SmallVector & operator= ( SmallVector && o ) noexcept {
+		if ( this != &o ) {
+			clear();
+			release();
+			steal( o );
+		}
+		return *this;
+	}
+	SmallVector & operator= ( std::initializer_list<E> il ) {
+		assign( il.begin(), il.end() );
+		return *this;
+	}
+
+	explicit operator std::vector<E>() const & { return std::vector<E>( begin(), end() ); }
+	operator std::vector<E>() && {
+		std::vector<E> ret( std::make_move_iterator( begin() ), std::make_move_iterator( end() ) );
+		clear();
+		return ret;
+	}
+
+	void assign( size_type n, const E & val ) {
+		E tmp( val );
+		clear();
+		reserve( n );
+		while ( size_ < n ) emplace_back( tmp );
+	}
+	template<typename It, typename = RequireInputIter<It>>
+	void assign( It first, It last ) {
+		clear();
+		append( first, last );
+	}
+	void assign( std::initializer_list<E> il ) { assign( il.begin(), il.end() ); }
+
+	iterator begin() { return data_; }
+	const_iterator begin() const { return data_; }
+	const_iterator cbegin() const { return data_; }
+	iterator end() { return data_ + size_; }
+	const_iterator end() const { return data_ + size_; }
+	const_iterator cend() const { return data_ + size_; }
+	reverse_iterator rbegin() { return reverse_iterator( end() ); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator( end() ); }
+	const_reverse_iterator crbegin() const { return const_reverse_iterator( end() ); }
+	reverse_iterator rend() { return reverse_iterator( begin() ); }
+	const_reverse_iterator rend() const { return const_reverse_iterator( begin() ); }
+	const_reverse_iterator crend() const { return const_reverse_iterator( begin() ); }
+
+	bool empty() const { return 0 == size_; }
+	size_type size() const { return size_; }
+	size_type capacity() const { return capacity_; }
+	size_type max_size() const { return UINT32_MAX; }
+
+	void reserve( size_type n ) { if ( capacity_ < n ) grow( n ); }
+	void shrink_to_fit() {}
+
+	reference operator[] ( size_type i ) { return data_[i]; }
+	const_reference operator[] ( size_type i ) const { return data_[i]; }
+	reference at( size_type i ) {
+		if ( size_ <= i ) throw std::out_of_range( "SmallVector::at" );
+		return data_[i];
+	}
+	const_reference at( size_type i ) const {
+		if ( size_ <= i ) throw std::out_of_range( "SmallVector::at" );
+		return data_[i];
+	}
+	reference front() { return data_[0]; }
+	const_reference front() const { return data_[0]; }
+	reference back() { return data_[size_ - 1]; }
+	const_reference back() const { return data_[size_ - 1]; }
+	E * data() { return data_; }
+	const E * data() const { return data_; }
+
+	template<typename... Args>
+	reference emplace_back( Args &&... args ) {
+		if ( size_ == capacity_ ) {
+			// args may refer to an element
+			E tmp( std::forward<Args>( args )... );
+			grow( size_ + 1 );
+			new ( data_ + size_ ) E( std::move( tmp ) );
+		} else {
+			new ( data_ + size_ ) E( std::forward<Args>( args )... );
+		}
+		return data_[size_++];
+	}
+	void push_back( const E & val ) { emplace_back( val ); }
+	void push_back( E && val ) { emplace_back( std::move( val ) ); }
+	void pop_back() { data_[--size_].~E(); }
+
+	template<typename... Args>
+	iterator emplace( const_iterator pos, Args &&... args ) {
+		size_type i = pos - begin();
+		if ( i == size_ ) {
+			emplace_back( std::forward<Args>( args )... );
+		} else {
+			E tmp( std::forward<Args>( args )... );
+			emplace_back( std::move( back() ) );
+			std::move_backward( begin() + i, end() - 2, end() - 1 );
+			data_[i] = std::move( tmp );
+		}
+		return begin() + i;
+	}
+	iterator insert( const_iterator pos, const E & val ) { return emplace( pos, val ); }
+	iterator insert( const_iterator pos, E && val ) { return emplace( pos, std::move( val ) ); }
+	iterator insert( const_iterator pos, size_type n, const E & val ) {
+		size_type i = pos - begin(), old = size_;
+		E tmp( val );
+		reserve( size_ + n );
+		while ( size_ < old + n ) emplace_back( tmp );
+		std::rotate( begin() + i, begin() + old, end() );
+		return begin() + i;
+	}
+	template<typename It, typename = RequireInputIter<It>>
+	iterator insert( const_iterator pos, It first, It last ) {
+		size_type i = pos - begin(), old = size_;
+		append( first, last );
+		std::rotate( begin() + i, begin() + old, end() );
+		return begin() + i;
+	}
+	iterator insert( const_iterator pos, std::initializer_list<E> il ) {
+		return insert( pos, il.begin(), il.end() );
+	}
+
+	iterator erase( const_iterator pos ) { return erase( pos, pos + 1 ); }
+	iterator erase( const_iterator first, const_iterator last ) {
+		iterator f = begin() + ( first - begin() ), l = begin() + ( last - begin() );
+		if ( f != l ) {
+			iterator e = std::move( l, end(), f );
+			destroy( e, end() );
+			size_ = e - begin();
+		}
+		return f;
+	}
+
+	void clear() {
+		destroy( begin(), end() );
+		size_ = 0;
+	}
+
+	void resize( size_type n ) {
+		if ( n < size_ ) {
+			erase( begin() + n, end() );
+		} else {
+			reserve( n );
+			while ( size_ < n ) emplace_back();
+		}
+	}
+	void resize( size_type n, const E & val ) {
+		if ( n < size_ ) {
+			erase( begin() + n, end() );
+		} else {
+			insert( end(), n - size_, val );
+		}
+	}
+
+	void swap( SmallVector & o ) {
+		SmallVector tmp( std::move( o ) );
+		o = std::move( *this );
+		*this = std::move( tmp );
+	}
+
+	friend void swap( SmallVector & a, SmallVector & b ) { a.swap( b ); }
+
+	friend bool operator== ( const SmallVector & a, const SmallVector & b ) {
+		return a.size() == b.size() && std::equal( a.begin(), a.end(), b.begin() );
+	}
+	friend bool operator!= ( const SmallVector & a, const SmallVector & b ) {
+		return !( a == b );
+	}
+	friend bool operator< ( const SmallVector & a, const SmallVector & b ) {
+		return std::lexicographical_compare( a.begin(), a.end(), b.begin(), b.end() );
+	}
+};
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
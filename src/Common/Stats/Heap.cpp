@@ -41,6 +41,10 @@ namespace Stats {
 		void newPass( const char * const ) {}
 
 		void print() {}
+
+		size_t new_stacktrace_id( const char * const ) { return 0; }
+		void stacktrace_push( size_t ) {}
+		void stacktrace_pop() {}
 #else
 		extern bool enabled;
 
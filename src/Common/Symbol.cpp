@@ -11,9 +11,10 @@ public:
 	// As long as we are using a pointer sized counter,
 	// overflow should never be an issue.
 	std::size_t refCount;
+	std::size_t const hash;
 
 	SymbolData(std::string const & value, std::size_t refCount) :
-		value(value), refCount(refCount)
+		value(value), refCount(refCount), hash(std::hash<std::string>()(value))
 	{}
 };
 
@@ -46,19 +47,10 @@ static SymbolMap & getAllSymbols() {
 	return allSymbols;
 }
 
-/// Clear out all unsed SymbolData.
-static void eraseUnused() {
-	SymbolMap & allSymbols = getAllSymbols();
-
-	auto it = allSymbols.begin();
-	while (it != allSymbols.end()) {
-		if (it->second->refCount) {
-			++it;
-		} else {
-			delete it->second;
-			it = allSymbols.erase(it);
-		}
-	}
+/// Clear out a SymbolData that is no longer used.
+static void eraseUnused(SymbolData * data) {
+	getAllSymbols().erase(&data->value);
+	delete data;
 }
 
 /// Convert a string to a new or existing SymbolData.
@@ -86,10 +78,14 @@ static void decSymbolData(SymbolData * data) {
 
 	// If it has hit zero, remove it from the map.
 	if (0 == data->refCount) {
-		eraseUnused();
+		eraseUnused(data);
 	}
 }
 
+Symbol::Symbol(SymbolData * data) : data(data) {
+	++data->refCount;
+}
+
 Symbol::Symbol() : data(getSymbolData(std::string())) {}
 
 Symbol::Symbol(std::string const & str) : data(getSymbolData(str)) {}
@@ -146,3 +142,14 @@ std::string const & Symbol::str() const {
 char const * Symbol::c_str() const {
 	return data->value.c_str();
 }
+
+std::size_t Symbol::hash() const {
+	return data->hash;
+}
+
+std::optional<Symbol> Symbol::find(std::string const & str) {
+	SymbolMap & allSymbols = getAllSymbols();
+	auto it = allSymbols.find(&str);
+	if (it == allSymbols.end()) return std::nullopt;
+	return Symbol(it->second);
+}
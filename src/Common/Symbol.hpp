@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 
 // Internal Type:
@@ -8,6 +9,8 @@ class SymbolData;
 /// A Symbol is an interned string, where the characters are 'hidden'.
 class Symbol final {
 	SymbolData * data;
+
+	explicit Symbol(SymbolData *);
 public:
 	/// Create a Symbol for the empty string.
 	Symbol();
@@ -29,4 +32,22 @@ public:
 
 	std::string const & str() const;
 	char const * c_str() const;
+
+	/// Hash of the characters, computed once when the string is interned.
+	/// Equal to the std::hash of the string so hashed containers keyed on
+	/// Symbols iterate in the same order as ones keyed on the strings.
+	std::size_t hash() const;
+
+	/// Get the Symbol for a string if it has already been interned.
+	/// No table keyed on Symbols can contain a string that has not.
+	static std::optional<Symbol> find(std::string const &);
 };
+
+namespace std {
+	template<>
+	struct hash<Symbol> {
+		std::size_t operator()(Symbol const & symbol) const {
+			return symbol.hash();
+		}
+	};
+} // namespace std
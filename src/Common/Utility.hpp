@@ -17,6 +17,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <iterator>
 #include <list>
 #include <string>
 #include <type_traits>
@@ -26,19 +27,21 @@
 template<typename T>
 T copy( const T & x ) { return x; }
 
-/// Splice src onto the end of dst, clearing src
-template< typename T >
-void splice( std::vector< T > & dst, std::vector< T > & src ) {
+/// Splice src onto the end of dst, clearing src; either may be a std::vector
+/// or a SmallVector
+template< typename Dst, typename Src >
+void splice( Dst & dst, Src & src ) {
 	dst.reserve( dst.size() + src.size() );
-	for ( T & x : src ) { dst.emplace_back( std::move( x ) ); }
+	for ( auto & x : src ) { dst.emplace_back( std::move( x ) ); }
 	src.clear();
 }
 
 /// Splice src onto the begining of dst, clearing src
-template< typename T >
-void spliceBegin( std::vector< T > & dst, std::vector< T > & src ) {
-	splice( src, dst );
-	dst.swap( src );
+template< typename Dst, typename Src >
+void spliceBegin( Dst & dst, Src & src ) {
+	dst.insert( dst.begin(),
+		std::make_move_iterator( src.begin() ), std::make_move_iterator( src.end() ) );
+	src.clear();
 }
 
 /// Remove elements that match pred from the container.
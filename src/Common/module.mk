@@ -16,6 +16,7 @@
 
 SRC_COMMON = \
 	Common/Assert.cpp \
+	Common/BlockPool.hpp \
 	Common/CodeLocation.hpp \
 	Common/CodeLocationTools.hpp \
 	Common/CodeLocationTools.cpp \
@@ -36,6 +37,7 @@ SRC_COMMON = \
 	Common/ScopedMap.hpp \
 	Common/SemanticError.cpp \
 	Common/SemanticError.hpp \
+	Common/SmallVector.hpp \
 	Common/Stats.hpp \
 	Common/Stats/Base.hpp \
 	Common/Stats/Counter.cpp \
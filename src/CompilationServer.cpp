@@ -0,0 +1,187 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// CompilationServer.cpp -- Serving translation requests from a warm process.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 10:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 10:00:00 2026
+// Update Count     : 0
+//
+
+#include "CompilationServer.hpp"
+
+#include <sys/socket.h>                     // for socket, bind, listen, accept, recvmsg
+#include <sys/un.h>                         // for sockaddr_un
+#include <sys/wait.h>                       // for waitpid, WIFSIGNALED, ...
+#include <unistd.h>                         // for fork, dup2, chdir, close, unlink
+#include <cerrno>                           // for errno, EINTR
+#include <csignal>                          // for signal, SIGCHLD
+#include <cstdint>                          // for int32_t, uint32_t
+#include <cstdlib>                          // for exit, _Exit
+#include <cstring>                          // for memcpy, strerror, strlen
+#include <iostream>                         // for cerr, cout, flush
+#include <string>                           // for string
+#include <vector>                           // for vector
+
+namespace CompilationServer {
+
+namespace {
+
+enum { StreamCount = 3 };                   // standard input, output and error
+enum Reply : int32_t { Rejected, Exited, Signalled };
+
+[[noreturn]] void fail( const char * what ) {
+	std::cerr << "cfa-cpp server error: " << what << ", " << strerror( errno ) << std::endl;
+	exit( EXIT_FAILURE );
+}
+
+bool readAll( int fd, void * buffer, size_t size ) {
+	char * next = static_cast<char *>( buffer );
+	while ( size != 0 ) {
+		ssize_t done = read( fd, next, size );
+		if ( done == -1 && errno == EINTR ) continue;
+		if ( done <= 0 ) return false;
+		next += done;
+		size -= done;
+	}
+	return true;
+}
+
+void reply( int conn, Reply kind, int32_t value ) {
+	int32_t message[2] = { kind, value };
+	// The client treats a short reply as a failed translation.
+	(void)!write( conn, message, sizeof(message) );
+}
+
+/// Receive a request: the size of the rest of the request, with the client's
+/// standard streams attached, then its working directory and command line as
+/// consecutive null-terminated strings.
+bool receive( int conn, int streams[StreamCount], std::vector<std::string> & strings ) {
+	uint32_t size;
+	struct iovec data = { &size, sizeof(size) };
+	union {
+		char buffer[CMSG_SPACE( sizeof(int) * StreamCount )];
+		struct cmsghdr align;
+	} control;
+	struct msghdr message = {};
+	message.msg_iov = &data;
+	message.msg_iovlen = 1;
+	message.msg_control = control.buffer;
+	message.msg_controllen = sizeof(control.buffer);
+	if ( recvmsg( conn, &message, MSG_WAITALL ) != sizeof(size) ) return false;
+
+	struct cmsghdr * header = CMSG_FIRSTHDR( &message );
+	if ( header == nullptr || header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS
+			|| header->cmsg_len != CMSG_LEN( sizeof(int) * StreamCount ) ) return false;
+	memcpy( streams, CMSG_DATA( header ), sizeof(int) * StreamCount );
+
+	std::string contents( size, '\0' );
+	if ( ! readAll( conn, &contents[0], size ) ) return false;
+	for ( size_t start = 0 ; start < size ; ) {
+		size_t end = contents.find( '\0', start );
+		if ( end == std::string::npos ) return false;
+		strings.push_back( contents.substr( start, end - start ) );
+		start = end + 1;
+	}
+	// At least the working directory and the program name.
+	return strings.size() >= 2;
+}
+
+/// Handle one request, in a fork of the server. The translation is run in a
+/// further fork so how it ends, including by a signal, can be reported.
+[[noreturn]] void handle( int conn, Acceptor accept, Translator translate ) {
+	signal( SIGCHLD, SIG_DFL );						// must wait for the translation
+
+	int streams[StreamCount];
+	std::vector<std::string> strings;
+	if ( ! receive( conn, streams, strings ) ) _Exit( EXIT_FAILURE );
+	for ( int i = 0 ; i < StreamCount ; i += 1 ) {
+		dup2( streams[i], i );
+		close( streams[i] );
+	}
+	if ( chdir( strings[0].c_str() ) == -1 ) {
+		reply( conn, Rejected, 0 );
+		_Exit( EXIT_SUCCESS );
+	}
+
+	std::vector<char *> argv;
+	for ( auto arg = strings.begin() + 1 ; arg != strings.end() ; ++arg ) {
+		argv.push_back( &(*arg)[0] );
+	}
+	int argc = argv.size();
+	argv.push_back( nullptr );
+
+	// Messages from checking the command line go to the client.
+	if ( ! accept( argc, argv.data() ) ) {
+		reply( conn, Rejected, 0 );
+		_Exit( EXIT_SUCCESS );
+	}
+	std::cout << std::flush;
+
+	pid_t pid = fork();
+	if ( pid == -1 ) fail( "fork" );
+	if ( pid == 0 ) {
+		close( conn );
+		exit( translate( argc, argv.data() ) );		// flush the output streams
+	}
+
+	int status;
+	while ( waitpid( pid, &status, 0 ) == -1 ) {
+		if ( errno != EINTR ) fail( "waitpid" );
+	}
+	if ( WIFSIGNALED( status ) ) {
+		reply( conn, Signalled, WTERMSIG( status ) );
+	} else {
+		reply( conn, Exited, WEXITSTATUS( status ) );
+	}
+	_Exit( EXIT_SUCCESS );
+}
+
+} // namespace
+
+void serve( const char * path, Acceptor accept, Translator translate ) {
+	struct sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if ( strlen( path ) >= sizeof(address.sun_path) ) {
+		errno = ENAMETOOLONG;
+		fail( path );
+	}
+	strcpy( address.sun_path, path );
+
+	int listener = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if ( listener == -1 ) fail( "socket" );
+	unlink( path );									// left behind by a killed server
+	if ( bind( listener, (struct sockaddr *)&address, sizeof(address) ) == -1 ) fail( path );
+	if ( listen( listener, SOMAXCONN ) == -1 ) fail( "listen" );
+
+	signal( SIGCHLD, SIG_IGN );						// handlers are reaped automatically
+	std::cout << std::flush;
+	std::cerr << std::flush;
+	for ( ;; ) {
+		int conn = ::accept( listener, nullptr, nullptr );
+		if ( conn == -1 ) {
+			if ( errno == EINTR || errno == ECONNABORTED ) continue;
+			fail( "accept" );
+		}
+		pid_t pid = fork();
+		if ( pid == -1 ) fail( "fork" );
+		if ( pid == 0 ) {
+			close( listener );
+			handle( conn, accept, translate );
+		}
+		close( conn );
+	}
+}
+
+} // namespace CompilationServer
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End:  //
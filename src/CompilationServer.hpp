@@ -0,0 +1,41 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// CompilationServer.hpp -- Serving translation requests from a warm process.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 10:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 10:00:00 2026
+// Update Count     : 0
+//
+
+#pragma once
+
+// A request is the client's standard input, output and error (passed as file
+// descriptors), its working directory and its cfa-cpp command line. The reply
+// says whether the request was rejected, or how the translation finished.
+// The client half of the protocol is in driver/cc1.cc.
+
+namespace CompilationServer {
+	/// Sets up a request in the process that handles it, the standard streams
+	/// and working directory are already the client's. Returns false to reject
+	/// the request, the client then runs its own cfa-cpp.
+	typedef bool (*Acceptor)( int argc, char * argv[] );
+	/// Translates an accepted request, returning the exit status.
+	typedef int (*Translator)( int argc, char * argv[] );
+
+	/// Serve requests on the Unix socket `path` until killed. Each request is
+	/// handled in a fork of this process, so whatever was loaded before the
+	/// call (the prelude) is shared by all of them rather than read each time.
+	[[noreturn]] void serve( const char * path, Acceptor accept, Translator translate );
+} // namespace CompilationServer
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End:  //
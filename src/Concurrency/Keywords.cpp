@@ -881,7 +881,7 @@ private:
 	const ast::StructDecl * thread_guard_decl = nullptr;
 	const ast::StructDecl * lock_guard_decl = nullptr;
 
-	static ast::ptr<ast::Type> generic_func;
+	static const ast::Type * generic_func();
 
 	UniqueName mutex_func_namer = UniqueName("__lock_unlock_curr");
 };
@@ -1064,8 +1064,6 @@ ast::CompoundStmt * MutexKeyword::addDtorStatements(
 		)
 	);
 
-	assert( generic_func );
-
 	// In reverse order:
 	// monitor_dtor_guard_t __guard = { __monitor, func, false };
 	mutBody->push_front(
@@ -1082,7 +1080,7 @@ ast::CompoundStmt * MutexKeyword::addDtorStatements(
 					new ast::SingleInit( location,
 						new ast::CastExpr( location,
 							new ast::VariableExpr( location, func ),
-							generic_func,
+							generic_func(),
 							ast::ExplicitCast ) ),
 					new ast::SingleInit( location,
 						ast::ConstantExpr::from_bool( location, false ) ),
@@ -1144,8 +1142,6 @@ ast::CompoundStmt * MutexKeyword::addStatements(
 		)
 	);
 
-	assert( generic_func );
-
 	// In Reverse Order:
 	mutBody->push_front(
 		new ast::DeclStmt( location, new ast::ObjectDecl(
@@ -1162,7 +1158,7 @@ ast::CompoundStmt * MutexKeyword::addStatements(
 					new ast::SingleInit( location, new ast::CastExpr(
 						location,
 						new ast::VariableExpr( location, func ),
-						generic_func,
+						generic_func(),
 						ast::ExplicitCast
 					) ),
 				},
@@ -1508,8 +1504,11 @@ ast::CompoundStmt * MutexKeyword::addThreadDtorStatements(
 	return mutBody;
 }
 
-ast::ptr<ast::Type> MutexKeyword::generic_func =
-	new ast::FunctionType( ast::FixedArgs );
+// Built on first use, not during static initialization, so it comes from the node arena.
+const ast::Type * MutexKeyword::generic_func() {
+	static ast::ptr<ast::Type> type = new ast::FunctionType( ast::FixedArgs );
+	return type;
+}
 
 // --------------------------------------------------------------------------
 struct ThreadStarter final {
@@ -132,7 +132,7 @@ Replaces the waituntil statement above with the following code:
 
 namespace Concurrency {
 
-class GenerateWaitUntilCore final {
+class GenerateWaitUntilCore final : public SkipFrozenDecls {
 	vector<FunctionDecl *> & satFns;
 	UniqueName namer_sat = "__is_full_sat_"s;
 	UniqueName namer_run = "__is_run_sat_"s;
@@ -1397,7 +1397,7 @@ Stmt * GenerateWaitUntilCore::postvisit( const WaitUntilStmt * stmt ) {
 
 // To add the predicates at global scope we need to do it in a second pass
 // Predicates are added after "struct select_node { ... };"
-class AddPredicateDecls final : public WithDeclsToAdd {
+class AddPredicateDecls final : public WithDeclsToAdd, public SkipFrozenDecls {
 	vector<FunctionDecl *> & satFns;
 	const StructDecl * selectNodeDecl = nullptr;
 
@@ -22,15 +22,16 @@
 #include "AST/Pass.hpp"
 #include "AST/Print.hpp"
 #include "AST/Type.hpp"
+#include "AST/Vector.hpp"
 #include "Virtual/Tables.hpp"
 
 namespace ControlStruct {
 
 namespace {
 
-std::vector<ast::ptr<ast::Expr>> forallToParams(
+ast::vector<ast::Expr> forallToParams(
 		std::vector<ast::ptr<ast::TypeDecl>> const & forall ) {
-	return map_range<std::vector<ast::ptr<ast::Expr>>>( forall,
+	return map_range<ast::vector<ast::Expr>>( forall,
 		[]( ast::ptr<ast::TypeDecl> const & decl ) {
 			return new ast::TypeExpr( decl->location,
 				new ast::TypeInstType( decl->name, decl->kind ) );
@@ -41,7 +42,7 @@ std::vector<ast::ptr<ast::Expr>> forallToParams(
 // A slightly argumented extra constructor, adds a deepCopy.
 ast::StructInstType * namedStructInstType(
 		std::string const & name, ast::CV::Qualifiers qualifiers,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	ast::StructInstType * type = new ast::StructInstType( name, qualifiers );
 	for ( ast::ptr<ast::Expr> const & param : params ) {
 		type->params.push_back( ast::deepCopy( param ) );
@@ -51,27 +52,27 @@ ast::StructInstType * namedStructInstType(
 
 ast::StructInstType * createExceptionInstType(
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	return namedStructInstType( exceptionName, ast::CV::Qualifiers(), params );
 }
 
 ast::StructInstType * createVTableInstType(
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	std::string name = Virtual::vtableTypeName( exceptionName );
 	return namedStructInstType( name, ast::CV::Const, params );
 }
 
 ast::StructInstType * createTypeIdInstType(
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	std::string name = Virtual::typeIdType( exceptionName );
 	return namedStructInstType( name, ast::CV::Const, params );
 }
 
 ast::FunctionType const * createCopyFuncType(
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	ast::FunctionType * type = new ast::FunctionType( ast::FixedArgs );
 	type->params.push_back( new ast::PointerType(
 		createExceptionInstType( exceptionName, params ) ) );
@@ -83,7 +84,7 @@ ast::FunctionType const * createCopyFuncType(
 
 ast::FunctionType const * createDtorFuncType(
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	ast::FunctionType * type = new ast::FunctionType( ast::FixedArgs );
 	type->params.push_back( new ast::ReferenceType(
 		createExceptionInstType( exceptionName, params ) ) );
@@ -93,7 +94,7 @@ ast::FunctionType const * createDtorFuncType(
 
 ast::FunctionType const * createMsgFuncType(
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	ast::FunctionType * type = new ast::FunctionType( ast::FixedArgs );
 	type->params.push_back( new ast::PointerType(
 		createExceptionInstType( exceptionName, params ) ) );
@@ -124,7 +125,7 @@ ast::StructDecl const * createTypeIdStruct(
 ast::ObjectDecl const * createTypeIdValue(
 		CodeLocation const & location,
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	ast::StructInstType * typeIdType =
 		createTypeIdInstType( exceptionName, params );
 	return new ast::ObjectDecl(
@@ -159,7 +160,7 @@ ast::StructDecl const * createVirtualTableStruct(
 		CodeLocation const & location,
 		std::string const & exceptionName,
 		std::vector<ast::ptr<ast::TypeDecl>> const & forall,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	ast::StructInstType * typeIdType =
 		createTypeIdInstType( exceptionName, params );
 	ast::ObjectDecl * typeId = new ast::ObjectDecl(
@@ -206,7 +207,7 @@ ast::StructDecl const * createExceptionStruct(
 		CodeLocation const & location,
 		std::string const & exceptionName,
 		std::vector<ast::ptr<ast::TypeDecl>> const & forallClause,
-		std::vector<ast::ptr<ast::Expr>> const & params,
+		ast::vector<ast::Expr> const & params,
 		std::vector<ast::ptr<ast::Decl>> const & members ) {
 	ast::StructDecl * decl = new ast::StructDecl( location, exceptionName );
 	decl->members.push_back( new ast::ObjectDecl(
@@ -228,7 +229,7 @@ ast::StructDecl const * createExceptionStruct(
 ast::ObjectDecl const * createExternTypeId(
 		CodeLocation const & location,
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	return new ast::ObjectDecl(
 		location,
 		Virtual::typeIdName( exceptionName ),
@@ -244,7 +245,7 @@ ast::ObjectDecl const * createExternTypeId(
 ast::ObjectDecl * createExternVTable(
 		CodeLocation const & location,
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params,
+		ast::vector<ast::Expr> const & params,
 		std::string const & tableName ) {
 	return new ast::ObjectDecl(
 		location,
@@ -259,7 +260,7 @@ ast::ObjectDecl * createExternVTable(
 ast::FunctionDecl const * createCopy(
 		CodeLocation const & location,
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	return new ast::FunctionDecl(
 		location,
 		"copy",
@@ -306,7 +307,7 @@ ast::FunctionDecl const * createCopy(
 ast::FunctionDecl const * createMsg(
 		CodeLocation const & location,
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params ) {
+		ast::vector<ast::Expr> const & params ) {
 	std::stringstream msg;
 	msg << exceptionName;
 	// The forall variant, add parameters to the string.
@@ -360,7 +361,7 @@ ast::FunctionDecl const * createMsg(
 ast::ObjectDecl * createVirtualTable(
 		CodeLocation const & location,
 		std::string const & exceptionName,
-		std::vector<ast::ptr<ast::Expr>> const & params,
+		ast::vector<ast::Expr> const & params,
 		std::string const & tableName ) {
 	ast::StructInstType * sizeType = new ast::StructInstType( exceptionName );
 	for ( ast::ptr<ast::Expr> const & param : params ) {
@@ -427,7 +428,7 @@ ast::StructDecl const * ExceptDeclCore::transformExcept(
 	CodeLocation const & location = decl->location;
 	std::string const & exceptionName = decl->name;
 	std::vector<ast::ptr<ast::TypeDecl>> const & forall = decl->params;
-	std::vector<ast::ptr<ast::Expr>> params = forallToParams( forall );
+	ast::vector<ast::Expr> params = forallToParams( forall );
 	std::vector<ast::ptr<ast::Decl>> const & members = decl->members;
 
 	declsToAddBefore.push_back(
@@ -449,7 +450,7 @@ ast::ObjectDecl const * ExceptDeclCore::transformVTable(
 	CodeLocation const & location = decl->location;
 	auto base = type->base.strict_as<ast::TypeInstType>();
 	std::string const & exceptionName = base->name;
-	std::vector<ast::ptr<ast::Expr>> const & params = base->params;
+	ast::vector<ast::Expr> const & params = base->params;
 	std::string const & tableName = decl->name;
 
 	ast::ObjectDecl * retDecl;
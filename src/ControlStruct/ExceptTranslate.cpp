@@ -31,7 +31,8 @@ void appendDeclStmt( ast::CompoundStmt * block, ast::DeclWithType * item ) {
 	block->push_back( new ast::DeclStmt( block->location, item ) );
 }
 
-class TranslateThrowsCore final : public ast::WithGuards {
+class TranslateThrowsCore final :
+		public ast::WithGuards, public ast::SkipFrozenDecls {
 	const ast::ObjectDecl * terminateHandlerExcept;
 	enum Context { NoHandler, TerHandler, ResHandler } currentContext;
 
@@ -135,7 +136,7 @@ const ast::Stmt * TranslateThrowsCore::postvisit(
 }
 
 
-class TryMutatorCore final {
+class TryMutatorCore final : public ast::SkipFrozenDecls {
 	// The built in types used in translation.
 	const ast::StructDecl * except_decl;
 	const ast::StructDecl * node_decl;
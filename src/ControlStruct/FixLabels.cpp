@@ -22,7 +22,7 @@
 using namespace ast;
 
 namespace ControlStruct {
-class FixLabelsCore final : public WithGuards {
+class FixLabelsCore final : public WithGuards, public SkipFrozenDecls {
 	LabelToStmt labelTable;
   public:
 	FixLabelsCore() : labelTable() {}
@@ -64,7 +64,7 @@ const Stmt * hoist( const StmtT * stmt ) {
 	return block;
 }
 
-struct hoistControlDeclsCore {
+struct hoistControlDeclsCore : public SkipFrozenDecls {
 	// Statements with declarations in conditional.
 	const Stmt * postvisit( const IfStmt * stmt ) {
 		return hoist<IfStmt>( stmt );
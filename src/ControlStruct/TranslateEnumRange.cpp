@@ -5,12 +5,6 @@
 
 namespace ControlStruct {
 
-namespace {
-
-struct TranslateEnumRangeCore {
-	const ast::Stmt * postvisit( const ast::ForeachStmt * stmt );
-};
-
 const ast::Stmt * TranslateEnumRangeCore::postvisit( const ast::ForeachStmt * stmt ) {
 	auto & location = stmt->location;
 
@@ -57,8 +51,6 @@ const ast::Stmt * TranslateEnumRangeCore::postvisit( const ast::ForeachStmt * st
 	);
 }
 
-} // namespace
-
 void translateEnumRange( ast::TranslationUnit & translationUnit ) {
 	ast::Pass<TranslateEnumRangeCore>::run( translationUnit );
 }
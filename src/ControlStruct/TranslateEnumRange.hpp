@@ -1,9 +1,16 @@
 #pragma once
 
 namespace ast {
+class ForeachStmt;
+class Stmt;
 class TranslationUnit;
 }
 
 namespace ControlStruct {
 void translateEnumRange( ast::TranslationUnit & translationUnit );
+
+/// The core of translateEnumRange, for fusing with other passes.
+struct TranslateEnumRangeCore {
+	const ast::Stmt * postvisit( const ast::ForeachStmt * stmt );
+};
 }
\ No newline at end of file
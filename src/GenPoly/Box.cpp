@@ -24,8 +24,10 @@
 #include "AST/Vector.hpp"              // for vector
 #include "AST/GenericSubstitution.hpp" // for genericSubstitution
 #include "CodeGen/OperatorTable.hpp"   // for isAssignment
+#include "Common/Eval.hpp"             // for eval
 #include "Common/Iterate.hpp"          // for group_iterate
 #include "Common/ScopedMap.hpp"        // for ScopedMap
+#include "Common/Stats/Counter.hpp"    // for SimpleCounter
 #include "Common/ToString.hpp"         // for toCString
 #include "Common/UniqueName.hpp"       // for UniqueName
 #include "GenPoly/FindFunction.hpp"    // for findFunction
@@ -62,9 +64,9 @@ struct LayoutFunctionBuilder final :
 };
 
 /// Get all sized type declarations; those that affect a layout function.
-ast::vector<ast::TypeDecl> takeSizedParams(
-		ast::vector<ast::TypeDecl> const & decls ) {
-	ast::vector<ast::TypeDecl> sizedParams;
+std::vector<ast::ptr<ast::TypeDecl>> takeSizedParams(
+		std::vector<ast::ptr<ast::TypeDecl>> const & decls ) {
+	std::vector<ast::ptr<ast::TypeDecl>> sizedParams;
 	for ( ast::ptr<ast::TypeDecl> const & decl : decls ) {
 		if ( decl->isComplete() ) {
 			sizedParams.emplace_back( decl );
@@ -75,8 +77,8 @@ ast::vector<ast::TypeDecl> takeSizedParams(
 
 /// Adds parameters for otype size and alignment to a function type.
 void addSTypeParams(
-		ast::vector<ast::DeclWithType> & params,
-		ast::vector<ast::TypeDecl> const & sizedParams ) {
+		std::vector<ast::ptr<ast::DeclWithType>> & params,
+		std::vector<ast::ptr<ast::TypeDecl>> const & sizedParams ) {
 	for ( ast::ptr<ast::TypeDecl> const & sizedParam : sizedParams ) {
 		ast::TypeInstType inst( sizedParam );
 		std::string paramName = Mangle::mangleType( &inst );
@@ -106,7 +108,7 @@ struct LayoutData {
 
 LayoutData buildLayoutFunction(
 		CodeLocation const & location, ast::AggregateDecl const * aggr,
-		ast::vector<ast::TypeDecl> const & sizedParams,
+		std::vector<ast::ptr<ast::TypeDecl>> const & sizedParams,
 		bool isInFunction, bool isStruct ) {
 	ast::ObjectDecl * sizeParam = new ast::ObjectDecl(
 		location,
@@ -119,7 +121,7 @@ LayoutData buildLayoutFunction(
 		makeLayoutOutType()
 	);
 	ast::ObjectDecl * offsetParam = nullptr;
-	ast::vector<ast::DeclWithType> params = { sizeParam, alignParam };
+	std::vector<ast::ptr<ast::DeclWithType>> params = { sizeParam, alignParam };
 	if ( isStruct ) {
 		offsetParam = new ast::ObjectDecl(
 			location,
@@ -207,7 +209,7 @@ void LayoutFunctionBuilder::previsit( ast::StructDecl const * decl ) {
 	if ( decl->members.empty() ) return;
 
 	// Get parameters that can change layout, exiting early if none.
-	ast::vector<ast::TypeDecl> sizedParams =
+	std::vector<ast::ptr<ast::TypeDecl>> sizedParams =
 		takeSizedParams( decl->params );
 	if ( sizedParams.empty() ) return;
 
@@ -281,7 +283,7 @@ void LayoutFunctionBuilder::previsit( ast::UnionDecl const * decl ) {
 	if ( decl->members.empty() ) return;
 
 	// Get parameters that can change layout, exiting early if none.
-	ast::vector<ast::TypeDecl> sizedParams =
+	std::vector<ast::ptr<ast::TypeDecl>> sizedParams =
 		takeSizedParams( decl->params );
 	if ( sizedParams.empty() ) return;
 
@@ -334,13 +336,31 @@ void LayoutFunctionBuilder::previsit( ast::UnionDecl const * decl ) {
 }
 
 // --------------------------------------------------------------------------
+auto adapterStats() {
+	using namespace Stats::Counters;
+	static auto group = build<CounterGroup>("Adapters");
+	static struct {
+		SimpleCounter * shared;
+		SimpleCounter * reused;
+		SimpleCounter * nested;
+	} ret = {
+		.shared = build<SimpleCounter>("Shared", group),
+		.reused = build<SimpleCounter>("Duplicates Removed", group),
+		.nested = build<SimpleCounter>("Nested", group),
+	};
+	return ret;
+}
+
 /// Application expression transformer.
 /// * Replaces polymorphic return types with out-parameters.
 /// * Replaces call to polymorphic functions with adapter calls which handles
 ///   dynamic arguments and return values.
 /// * Adds appropriate type variables to the function calls.
+/// Adapters with closed types are shared by the whole translation unit, the
+/// rest are nested in the scope that needs them.
 struct CallAdapter final :
 		public ast::WithConstTypeSubstitution,
+		public ast::WithDeclsToAdd,
 		public ast::WithGuards,
 		public ast::WithShortCircuiting,
 		public ast::WithStmtsToAdd,
@@ -350,6 +370,7 @@ struct CallAdapter final :
 	void previsit( ast::Decl const * decl );
 	ast::FunctionDecl const * previsit( ast::FunctionDecl const * decl );
 	void previsit( ast::TypeDecl const * decl );
+	void postvisit( ast::Decl const * decl );
 	void previsit( ast::CommaExpr const * expr );
 	ast::Expr const * postvisit( ast::ApplicationExpr const * expr );
 	ast::Expr const * postvisit( ast::UntypedExpr const * expr );
@@ -419,8 +440,18 @@ private:
 	ast::ObjectDecl * makeTemporary(
 		CodeLocation const & location, ast::Type const * type );
 
+	/// Enters a declaration, remembering the type declarations at the top
+	/// level, since they may be used by shared adapters.
+	void enterDecl( ast::Decl const * decl );
+
 	TypeVarMap scopeTypeVars;
 	ScopedMap< std::string, ast::DeclWithType const * > adapters;
+	/// The shared adapters, which are declared at the top level.
+	std::map< std::string, ast::DeclWithType const * > globalAdapters;
+	/// Shared adapters made in the current top level declaration.
+	std::list< ast::ptr<ast::Decl> > newGlobalAdapters;
+	std::unordered_set< ast::Decl const * > globalTypes;
+	unsigned declDepth = 0;
 	std::map< ast::ApplicationExpr const *, ast::Expr const * > retVals;
 	ast::DeclWithType const * retval;
 	UniqueName tmpNamer;
@@ -528,12 +559,21 @@ ast::FunctionType * makeAdapterType(
 
 CallAdapter::CallAdapter() : tmpNamer( "_temp" ) {}
 
-void CallAdapter::previsit( ast::Decl const * ) {
+void CallAdapter::enterDecl( ast::Decl const * decl ) {
+	if ( 0 == declDepth && dynamic_cast<ast::AggregateDecl const *>( decl ) ) {
+		globalTypes.insert( decl );
+	}
+	GuardValue( declDepth ) += 1;
+}
+
+void CallAdapter::previsit( ast::Decl const * decl ) {
+	enterDecl( decl );
 	// Prevent type declaration information from leaking out.
 	GuardScope( scopeTypeVars );
 }
 
 ast::FunctionDecl const * CallAdapter::previsit( ast::FunctionDecl const * decl ) {
+	enterDecl( decl );
 	// Prevent type declaration information from leaking out.
 	GuardScope( scopeTypeVars );
 
@@ -565,7 +605,7 @@ ast::FunctionDecl const * CallAdapter::previsit( ast::FunctionDecl const * decl
 	makeTypeVarMap( type, scopeTypeVars );
 
 	// Get all needed adapters from the call. We will forward them.
-	ast::vector<ast::FunctionType> functions;
+	std::vector<ast::ptr<ast::FunctionType>> functions;
 	for ( ast::ptr<ast::VariableExpr> const & assertion : type->assertions ) {
 		auto atype = assertion->result.get();
 		findFunction( atype, functions, scopeTypeVars, needsAdapter );
@@ -599,9 +639,17 @@ ast::FunctionDecl const * CallAdapter::previsit( ast::FunctionDecl const * decl
 }
 
 void CallAdapter::previsit( ast::TypeDecl const * decl ) {
+	enterDecl( decl );
 	addToTypeVarMap( decl, scopeTypeVars );
 }
 
+void CallAdapter::postvisit( ast::Decl const * ) {
+	// Shared adapters go before the first top level declaration using them.
+	if ( 1 == declDepth ) {
+		declsToAddBefore.splice( declsToAddBefore.end(), newGlobalAdapters );
+	}
+}
+
 void CallAdapter::previsit( ast::CommaExpr const * expr ) {
 	// Attempting to find application expressions that were mutated by the
 	// copy constructor passes to use an explicit return variable, so that
@@ -957,7 +1005,7 @@ void CallAdapter::passAdapters(
 	// Collect a list of function types passed as parameters or implicit
 	// parameters (assertions).
 	ast::vector<ast::Type> const & paramList = type->params;
-	ast::vector<ast::FunctionType> functions;
+	std::vector<ast::ptr<ast::FunctionType>> functions;
 
 	for ( ast::ptr<ast::VariableExpr> const & assertion : type->assertions ) {
 		findFunction( assertion->result, functions, exprTypeVars, needsAdapter );
@@ -991,22 +1039,39 @@ void CallAdapter::passAdapters(
 		mangleName += makePolyMonoSuffix( funcType, exprTypeVars );
 
 		// Check if the adapter has already been created, or has to be.
-		using AdapterIter = decltype(adapters)::iterator;
-		AdapterIter adapter = adapters.find( mangleName );
-		if ( adapter == adapters.end() ) {
+		ast::DeclWithType const * adapter = nullptr;
+		auto local = adapters.find( mangleName );
+		if ( local != adapters.end() ) {
+			adapter = local->second;
+		} else if ( isClosedOver( realType, globalTypes ) ) {
+			auto global = globalAdapters.find( mangleName );
+			if ( global != globalAdapters.end() ) {
+				++*adapterStats().reused;
+				adapter = global->second;
+			} else {
+				++*adapterStats().shared;
+				ast::FunctionDecl * newAdapter = makeAdapter(
+					funcType, realType, mangleName, exprTypeVars, location );
+				newAdapter->storage.is_static = true;
+				globalAdapters.emplace( mangleName, newAdapter );
+				newGlobalAdapters.push_back( newAdapter );
+				adapter = newAdapter;
+			}
+			// Later uses in the scope are not duplicates.
+			adapters.insert( mangleName, adapter );
+		} else {
+			++*adapterStats().nested;
 			ast::FunctionDecl * newAdapter = makeAdapter(
 				funcType, realType, mangleName, exprTypeVars, location );
-			std::pair<AdapterIter, bool> answer =
-				adapters.insert( mangleName, newAdapter );
-			adapter = answer.first;
+			adapters.insert( mangleName, newAdapter );
 			stmtsToAddBefore.push_back(
 				new ast::DeclStmt( location, newAdapter ) );
+			adapter = newAdapter;
 		}
-		assert( adapter != adapters.end() );
 
 		// Add the approprate adapter as a parameter.
 		expr->args.insert( expr->args.begin(),
-			new ast::VariableExpr( location, adapter->second ) );
+			new ast::VariableExpr( location, adapter ) );
 	}
 }
 
@@ -1038,8 +1103,8 @@ ast::Expr * makeAdapterArg(
 void addAdapterParams(
 		ast::ApplicationExpr * adaptee,
 		ast::vector<ast::Type>::const_iterator arg,
-		ast::vector<ast::DeclWithType>::iterator param,
-		ast::vector<ast::DeclWithType>::iterator paramEnd,
+		std::vector<ast::ptr<ast::DeclWithType>>::iterator param,
+		std::vector<ast::ptr<ast::DeclWithType>>::iterator paramEnd,
 		ast::vector<ast::Type>::const_iterator realParam,
 		TypeVarMap const & typeVars,
 		CodeLocation const & location ) {
@@ -1074,7 +1139,7 @@ ast::FunctionDecl * CallAdapter::makeAdapter(
 		makeAdapterName( mangleName ),
 		{}, // forall
 		{}, // assertions
-		map_range<ast::vector<ast::DeclWithType>>( adapterType->params,
+		map_range<std::vector<ast::ptr<ast::DeclWithType>>>( adapterType->params,
 				[&pNamer, &location, &first]( ast::ptr<ast::Type> const & param ) {
 			// [Trying to make the generated code match exactly more often.]
 			if ( first ) {
@@ -1083,7 +1148,7 @@ ast::FunctionDecl * CallAdapter::makeAdapter(
 			}
 			return new ast::ObjectDecl( location, pNamer.newName(), param );
 		} ),
-		map_range<ast::vector<ast::DeclWithType>>( adapterType->returns,
+		map_range<std::vector<ast::ptr<ast::DeclWithType>>>( adapterType->returns,
 				[&rNamer, &location]( ast::ptr<ast::Type> const & retval ) {
 			return new ast::ObjectDecl( location, rNamer.newName(), retval );
 		} ),
@@ -1131,7 +1196,7 @@ ast::FunctionDecl * CallAdapter::makeAdapter(
 		arg = realType->params.begin(),
 		param = adapterType->params.begin(),
 		realParam = adaptee->params.begin();
-	ast::vector<ast::DeclWithType>::iterator
+	std::vector<ast::ptr<ast::DeclWithType>>::iterator
 		paramDecl = adapterDecl->params.begin();
 	// Skip adaptee parameter in the adapter type.
 	++param;
@@ -1429,8 +1494,8 @@ ast::FunctionDecl const * DeclAdapter::previsit( ast::FunctionDecl const * decl
 	}
 
 	// Add size/align and assertions for type parameters to parameter list.
-	ast::vector<ast::DeclWithType> inferredParams;
-	ast::vector<ast::DeclWithType> layoutParams;
+	std::vector<ast::ptr<ast::DeclWithType>> inferredParams;
+	std::vector<ast::ptr<ast::DeclWithType>> layoutParams;
 	for ( ast::ptr<ast::TypeDecl> & typeParam : mutDecl->type_params ) {
 		auto mutParam = mutate( typeParam.get() );
 		// Add all size and alignment parameters to parameter list.
@@ -1475,6 +1540,7 @@ ast::FunctionDecl const * DeclAdapter::previsit( ast::FunctionDecl const * decl
 		type->returns.emplace_back( retval->get_type() );
 	}
 	mutDecl->type = type;
+	mutDecl->clearMangleCache();
 
 	return mutDecl;
 }
@@ -1513,7 +1579,7 @@ ast::FunctionDecl const * DeclAdapter::postvisit(
 
 void DeclAdapter::addAdapters(
 		ast::FunctionDecl * mutDecl, TypeVarMap & localTypeVars ) {
-	ast::vector<ast::FunctionType> functions;
+	std::vector<ast::ptr<ast::FunctionType>> functions;
 	for ( ast::ptr<ast::DeclWithType> & arg : mutDecl->params ) {
 		ast::Type const * type = arg->get_type();
 		type = findAndReplaceFunction( type, functions, localTypeVars, needsAdapter );
@@ -1776,6 +1842,7 @@ ast::DeclStmt const * PolyGenericCalculator::previsit( ast::DeclStmt const * stm
 	while ( auto arrayType = dynamic_cast<ast::ArrayType const *>( mutDecl->type.get() ) ) {
 		mutDecl->type = arrayType->base;
 	}
+	mutDecl->clearMangleCache();
 
 	mutDecl->init = new ast::SingleInit( decl->location,
 		new ast::VariableExpr( decl->location, newBuf ) );
@@ -1813,7 +1880,7 @@ bool isMember( ast::DeclWithType const * memberDecl, ast::Decl const * decl ) {
 /// Finds the member in the base list that matches the given declaration;
 /// returns its index, or -1 if not present.
 long findMember( ast::DeclWithType const * memberDecl,
-		const ast::vector<ast::Decl> & baseDecls ) {
+		const std::vector<ast::ptr<ast::Decl>> & baseDecls ) {
 	for ( auto const & [index, value] : enumerate( baseDecls ) ) {
 		if ( isMember( memberDecl, value.get() ) ) {
 			return index;
@@ -1832,6 +1899,73 @@ ast::Expr * makeOffsetIndex( CodeLocation const & location,
 	} );
 }
 
+/// Returns true if the type has the same layout in every instance of the
+/// enclosing polymorphic code: it names no type variables or generic types.
+bool hasStaticLayout( ast::Type const * type ) {
+	if ( dynamic_cast<ast::BasicType const *>( type )
+			|| dynamic_cast<ast::ZeroType const *>( type )
+			|| dynamic_cast<ast::OneType const *>( type ) ) {
+		return true;
+	} else if ( auto pointer = dynamic_cast<ast::PointerType const *>( type ) ) {
+		return !pointer->dimension && hasStaticLayout( pointer->base );
+	} else if ( auto array = dynamic_cast<ast::ArrayType const *>( type ) ) {
+		return array->dimension && eval( array->dimension ).hasKnownValue
+			&& hasStaticLayout( array->base );
+	} else if ( auto func = dynamic_cast<ast::FunctionType const *>( type ) ) {
+		// Only reached through a pointer.
+		if ( !func->forall.empty() ) return false;
+		for ( ast::ptr<ast::Type> const & ret : func->returns ) {
+			if ( !hasStaticLayout( ret ) ) return false;
+		}
+		for ( ast::ptr<ast::Type> const & param : func->params ) {
+			if ( !hasStaticLayout( param ) ) return false;
+		}
+		return true;
+	} else if ( dynamic_cast<ast::VoidType const *>( type ) ) {
+		return true;
+	} else if ( auto inst = dynamic_cast<ast::BaseInstType const *>( type ) ) {
+		return inst->params.empty()
+			&& !dynamic_cast<ast::TypeInstType const *>( type )
+			&& !dynamic_cast<ast::TraitInstType const *>( type );
+	}
+	return false;
+}
+
+/// Returns a constant expression for the offset of a member, if it and the
+/// members before it have static layouts, and nullptr otherwise. This is
+/// the calculation done by the layout function, which then does not have to
+/// be called to find the offset.
+ast::Expr const * staticOffset( CodeLocation const & location,
+		ast::StructInstType const * type, long index ) {
+	ast::TypeSubstitution sub = genericSubstitution( type );
+	std::vector<ast::ptr<ast::Type>> memberTypes;
+	for ( long i = 0 ; i <= index ; ++i ) {
+		auto member = type->base->members[i].as<ast::DeclWithType>();
+		if ( !member ) return nullptr;
+		ast::ptr<ast::Type> memberType = member->get_type();
+		sub.apply( memberType );
+		if ( !hasStaticLayout( memberType ) ) return nullptr;
+		memberTypes.push_back( memberType );
+	}
+
+	// The first member is always at the start of the structure.
+	ast::Expr const * offset = ast::ConstantExpr::from_ulong( location, 0 );
+	for ( long i = 1 ; i <= index ; ++i ) {
+		// offset = (offset + sizeof(prev) + align - 1) & ~(align - 1)
+		ast::Expr * mask = makeOp( location, "?-?",
+			new ast::AlignofExpr( location, memberTypes[i] ),
+			ast::ConstantExpr::from_ulong( location, 1 ) );
+		ast::Expr * end = makeOp( location, "?+?", offset,
+			new ast::SizeofExpr( location, memberTypes[i - 1] ) );
+		offset = makeOp( location, "?&?",
+			makeOp( location, "?+?", end, mask ),
+			new ast::UntypedExpr( location,
+				new ast::NameExpr( location, "~?" ),
+				{ ast::deepCopy( mask ) } ) );
+	}
+	return offset;
+}
+
 ast::Expr const * PolyGenericCalculator::postvisit(
 		ast::MemberExpr const * expr ) {
 	// Only mutate member expressions for polymorphic types.
@@ -1839,9 +1973,6 @@ ast::Expr const * PolyGenericCalculator::postvisit(
 		expr->aggregate->result, scopeTypeVars
 	);
 	if ( !objectType ) return expr;
-	// Ensure layout for this type is available.
-	// The boolean result is ignored.
-	findGeneric( expr->location, objectType );
 
 	// Replace member expression with dynamically-computed layout expression.
 	ast::Expr * newMemberExpr = nullptr;
@@ -1849,18 +1980,27 @@ ast::Expr const * PolyGenericCalculator::postvisit(
 		long offsetIndex = findMember( expr->member, structType->base->members );
 		if ( -1 == offsetIndex ) return expr;
 
+		// Use the layout only if the offset is not known now.
+		ast::Expr const * offset =
+			staticOffset( expr->location, structType, offsetIndex );
+		if ( !offset ) {
+			findGeneric( expr->location, objectType );
+			offset = makeOffsetIndex( expr->location, objectType, offsetIndex );
+		}
+
 		// Replace member expression with pointer to struct plus offset.
 		ast::UntypedExpr * fieldLoc = new ast::UntypedExpr( expr->location,
 				new ast::NameExpr( expr->location, "?+?" ) );
 		ast::Expr * aggr = deepCopy( expr->aggregate );
 		aggr->env = nullptr;
 		fieldLoc->args.push_back( aggr );
-		fieldLoc->args.push_back(
-			makeOffsetIndex( expr->location, objectType, offsetIndex ) );
+		fieldLoc->args.push_back( offset );
 		fieldLoc->result = deepCopy( expr->result );
 		newMemberExpr = fieldLoc;
 	// Union members are all at offset zero, so just use the aggregate expr.
 	} else if ( dynamic_cast<ast::UnionInstType const *>( objectType ) ) {
+		// Ensure layout for this type is available.
+		findGeneric( expr->location, objectType );
 		ast::Expr * aggr = deepCopy( expr->aggregate );
 		aggr->env = nullptr;
 		aggr->result = deepCopy( expr->result );
@@ -1941,6 +2081,9 @@ ast::Expr const * PolyGenericCalculator::postvisit(
 		long offsetIndex = findMember( expr->member, structType->base->members );
 		if ( -1 == offsetIndex ) return expr;
 
+		if ( auto offset = staticOffset( expr->location, structType, offsetIndex ) ) {
+			return offset;
+		}
 		return makeOffsetIndex( expr->location, type, offsetIndex );
 	// All union members are at offset zero.
 	} else if ( dynamic_cast<ast::UnionInstType const *>( type ) ) {
@@ -2017,7 +2160,7 @@ ast::ObjectDecl * PolyGenericCalculator::makeVar(
 /// puts all otype parameters in the output list.
 bool findGenericParams(
 		ast::vector<ast::Type> & out,
-		ast::vector<ast::TypeDecl> const & baseParams,
+		std::vector<ast::ptr<ast::TypeDecl>> const & baseParams,
 		ast::vector<ast::Expr> const & typeParams ) {
 	bool hasDynamicLayout = false;
 
@@ -2160,7 +2303,7 @@ void PolyGenericCalculator::addSTypeParamsToLayoutCall(
 		ast::UntypedExpr * layoutCall,
 		const ast::vector<ast::Type> & otypeParams ) {
 	CodeLocation const & location = layoutCall->location;
-	ast::vector<ast::Expr> & args = layoutCall->args;
+	std::vector<ast::ptr<ast::Expr>> & args = layoutCall->args;
 	for ( ast::ptr<ast::Type> const & param : otypeParams ) {
 		if ( findGeneric( location, param ) ) {
 			// Push size/align vars for a generic parameter back.
@@ -26,6 +26,7 @@
 #include "AST/Expr.hpp"
 #include "AST/Type.hpp"
 #include "AST/TypeSubstitution.hpp"
+#include "AST/Vector.hpp"
 #include "Common/Eval.hpp"                // for eval
 #include "GenPoly/ErasableScopedMap.hpp"  // for ErasableScopedMap<>::const_...
 #include "ResolvExpr/Typeops.hpp"         // for flatten
@@ -36,7 +37,7 @@ namespace GenPoly {
 
 namespace {
 	/// Checks a parameter list for polymorphic parameters; will substitute according to env if present.
-	bool hasPolyParams( const std::vector<ast::ptr<ast::Expr>> & params, const ast::TypeSubstitution * env ) {
+	bool hasPolyParams( const ast::vector<ast::Expr> & params, const ast::TypeSubstitution * env ) {
 		for ( auto & param : params ) {
 			auto paramType = param.as<ast::TypeExpr>();
 			assertf( paramType, "Aggregate parameters should be type expressions" );
@@ -46,7 +47,7 @@ namespace {
 	}
 
 	/// Checks a parameter list for polymorphic parameters from typeVars; will substitute according to env if present.
-	bool hasPolyParams( const std::vector<ast::ptr<ast::Expr>> & params, const TypeVarMap & typeVars, const ast::TypeSubstitution * env ) {
+	bool hasPolyParams( const ast::vector<ast::Expr> & params, const TypeVarMap & typeVars, const ast::TypeSubstitution * env ) {
 		for ( auto & param : params ) {
 			auto paramType = param.as<ast::TypeExpr>();
 			assertf( paramType, "Aggregate parameters should be type expressions" );
@@ -57,7 +58,7 @@ namespace {
 
 	/// Checks a parameter list for dynamic-layout parameters from tyVars; will substitute according to env if present.
 	bool hasDynParams(
-			const std::vector<ast::ptr<ast::Expr>> & params,
+			const ast::vector<ast::Expr> & params,
 			const TypeVarMap & typeVars,
 			const ast::TypeSubstitution * subst ) {
 		for ( ast::ptr<ast::Expr> const & paramExpr : params ) {
@@ -73,7 +74,7 @@ namespace {
 
 const ast::Type * replaceTypeInst( const ast::Type * type, const ast::TypeSubstitution * env ) {
 	if ( !env ) return type;
-	if ( auto typeInst = dynamic_cast<const ast::TypeInstType*>( type ) ) {
+	if ( auto typeInst = ast::dyn_cast<ast::TypeInstType>( type ) ) {
 		if ( auto newType = env->lookup( typeInst ) ) return newType;
 	}
 	return type;
@@ -82,14 +83,14 @@ const ast::Type * replaceTypeInst( const ast::Type * type, const ast::TypeSubsti
 const ast::Type * isPolyType( const ast::Type * type, const ast::TypeSubstitution * subst ) {
 	type = replaceTypeInst( type, subst );
 
-	if ( dynamic_cast< const ast::TypeInstType * >( type ) ) {
+	if ( ast::dyn_cast< ast::TypeInstType >( type ) ) {
 		// This case is where the two variants of isPolyType differ.
 		return type;
-	} else if ( auto arrayType = dynamic_cast< const ast::ArrayType * >( type ) ) {
+	} else if ( auto arrayType = ast::dyn_cast< ast::ArrayType >( type ) ) {
 		return isPolyType( arrayType->base, subst );
-	} else if ( auto structType = dynamic_cast< const ast::StructInstType* >( type ) ) {
+	} else if ( auto structType = ast::dyn_cast< ast::StructInstType >( type ) ) {
 		if ( hasPolyParams( structType->params, subst ) ) return type;
-	} else if ( auto unionType = dynamic_cast< const ast::UnionInstType* >( type ) ) {
+	} else if ( auto unionType = ast::dyn_cast< ast::UnionInstType >( type ) ) {
 		if ( hasPolyParams( unionType->params, subst ) ) return type;
 	}
 	return nullptr;
@@ -99,13 +100,13 @@ const ast::Type * isPolyType( const ast::Type * type,
 		const TypeVarMap & typeVars, const ast::TypeSubstitution * subst ) {
 	type = replaceTypeInst( type, subst );
 
-	if ( auto inst = dynamic_cast< const ast::TypeInstType * >( type ) ) {
+	if ( auto inst = ast::dyn_cast< ast::TypeInstType >( type ) ) {
 		if ( typeVars.contains( *inst ) ) return type;
-	} else if ( auto array = dynamic_cast< const ast::ArrayType * >( type ) ) {
+	} else if ( auto array = ast::dyn_cast< ast::ArrayType >( type ) ) {
 		return isPolyType( array->base, typeVars, subst );
-	} else if ( auto sue = dynamic_cast< const ast::StructInstType * >( type ) ) {
+	} else if ( auto sue = ast::dyn_cast< ast::StructInstType >( type ) ) {
 		if ( hasPolyParams( sue->params, typeVars, subst ) ) return type;
-	} else if ( auto sue = dynamic_cast< const ast::UnionInstType * >( type ) ) {
+	} else if ( auto sue = ast::dyn_cast< ast::UnionInstType >( type ) ) {
 		if ( hasPolyParams( sue->params, typeVars, subst ) ) return type;
 	}
 	return nullptr;
@@ -188,13 +189,65 @@ ast::Type const * hasPolyBase(
 }
 
 const ast::FunctionType * getFunctionType( const ast::Type * ty ) {
-	if ( auto pty = dynamic_cast< const ast::PointerType * >( ty ) ) {
+	if ( auto pty = ast::dyn_cast< ast::PointerType >( ty ) ) {
 		return pty->base.as< ast::FunctionType >();
 	} else {
-		return dynamic_cast< const ast::FunctionType * >( ty );
+		return ast::dyn_cast< ast::FunctionType >( ty );
 	}
 }
 
+namespace {
+	template<typename inst_t>
+	bool isClosedInst( ast::Type const * type,
+			std::unordered_set<ast::Decl const *> const & decls, bool & closed ) {
+		auto inst = dynamic_cast<inst_t const *>( type );
+		if ( !inst ) return false;
+		closed = decls.count( inst->base.get() );
+		for ( ast::ptr<ast::Expr> const & param : inst->params ) {
+			auto typeExpr = param.as<ast::TypeExpr>();
+			closed = closed && typeExpr && isClosedOver( typeExpr->type, decls );
+		}
+		return true;
+	}
+} // namespace
+
+bool isClosedOver( ast::Type const * type,
+		std::unordered_set<ast::Decl const *> const & decls ) {
+	if ( dynamic_cast<ast::BasicType const *>( type )
+			|| dynamic_cast<ast::VoidType const *>( type )
+			|| dynamic_cast<ast::VarArgsType const *>( type )
+			|| dynamic_cast<ast::ZeroType const *>( type )
+			|| dynamic_cast<ast::OneType const *>( type ) ) {
+		return true;
+	} else if ( auto pointer = dynamic_cast<ast::PointerType const *>( type ) ) {
+		return !pointer->dimension && isClosedOver( pointer->base, decls );
+	} else if ( auto ref = dynamic_cast<ast::ReferenceType const *>( type ) ) {
+		return isClosedOver( ref->base, decls );
+	} else if ( auto func = dynamic_cast<ast::FunctionType const *>( type ) ) {
+		if ( !func->forall.empty() || !func->assertions.empty() ) return false;
+		for ( ast::ptr<ast::Type> const & ret : func->returns ) {
+			if ( !isClosedOver( ret, decls ) ) return false;
+		}
+		for ( ast::ptr<ast::Type> const & param : func->params ) {
+			if ( !isClosedOver( param, decls ) ) return false;
+		}
+		return true;
+	} else if ( auto tuple = dynamic_cast<ast::TupleType const *>( type ) ) {
+		for ( ast::ptr<ast::Type> const & member : tuple->types ) {
+			if ( !isClosedOver( member, decls ) ) return false;
+		}
+		return true;
+	}
+	bool closed = false;
+	if ( isClosedInst<ast::StructInstType>( type, decls, closed )
+			|| isClosedInst<ast::UnionInstType>( type, decls, closed )
+			|| isClosedInst<ast::EnumInstType>( type, decls, closed ) ) {
+		return closed;
+	}
+	// Type variables, arrays and everything else.
+	return false;
+}
+
 namespace {
 	/// Checks if is a pointer to D
 	template<typename D, typename B>
@@ -210,7 +263,8 @@ namespace {
 	}
 
 	/// Flattens a list of types.
-	void flattenList( vector<ast::ptr<ast::Type>> const & src,
+	template<typename TypeList>
+	void flattenList( TypeList const & src,
 			vector<ast::ptr<ast::Type>> & out ) {
 		for ( auto const & type : src ) {
 			ResolvExpr::flatten( type, out );
@@ -218,8 +272,8 @@ namespace {
 	}
 
 	bool paramListsPolyCompatible(
-			std::vector<ast::ptr<ast::Expr>> const & lparams,
-			std::vector<ast::ptr<ast::Expr>> const & rparams ) {
+			ast::vector<ast::Expr> const & lparams,
+			ast::vector<ast::Expr> const & rparams ) {
 		if ( lparams.size() != rparams.size() ) {
 			return false;
 		}
@@ -17,6 +17,7 @@
 
 #include <iostream>               // for ostream
 #include <string>                 // for string, allocator, operator+, basic...
+#include <unordered_set>          // for unordered_set
 
 #include "ErasableScopedMap.hpp"  // for ErasableScopedMap
 #include "AST/Decl.hpp"           // for AggregateDecl
@@ -67,6 +68,11 @@ const ast::FunctionType * getFunctionType( const ast::Type * ty );
 /// Returns true iff types are structurally identical, where TypeInstType's match any type.
 bool typesPolyCompatible( ast::Type const * lhs, ast::Type const * rhs );
 
+/// Returns true if the type has no type variables or array dimensions, and all of its
+/// structure, union and enumeration types are declared by one of `decls`. Such a type means
+/// the same thing wherever those declarations are visible.
+bool isClosedOver( ast::Type const * type, std::unordered_set<ast::Decl const *> const & decls );
+
 /// Returns true if arg requires boxing given typeVars.
 bool needsBoxing( const ast::Type * param, const ast::Type * arg, const TypeVarMap & typeVars, const ast::TypeSubstitution * subst );
 
@@ -17,6 +17,8 @@
 
 #include <cassert>                     // for assertf, assert
 #include <set>                         // for set
+#include <typeinfo>                    // for typeid
+#include <unordered_map>               // for unordered_map
 #include <utility>                     // for move, pair
 #include <vector>                      // for vector
 
@@ -42,6 +44,42 @@ namespace {
 
 using type_vector = ast::vector< ast::TypeExpr >;
 
+/// Hash of the parts of a type that typesPolyCompatible always checks,
+/// equal for any two compatible types. Type variables match anything, so
+/// they have no signature and false is returned.
+bool polySignature( ast::Type const * type, std::size_t & hash ) {
+	if ( dynamic_cast<ast::TypeInstType const *>( type ) ) return false;
+	hash = typeid(*type).hash_code();
+	if ( auto basic = dynamic_cast<ast::BasicType const *>( type ) ) {
+		hash = hash * 31 + static_cast<std::size_t>( basic->kind );
+	} else if ( auto inst = dynamic_cast<ast::BaseInstType const *>( type ) ) {
+		hash = hash * 31 + std::hash<std::string>()( inst->name );
+	}
+	return true;
+}
+
+/// Combined signature of a parameter list, false if any parameter is a
+/// type variable.
+bool polySignature( type_vector const & params, std::size_t & hash ) {
+	hash = params.size();
+	for ( auto const & param : params ) {
+		std::size_t paramHash;
+		if ( !polySignature( param->type, paramHash ) ) return false;
+		hash = hash * 31 + paramHash;
+	}
+	return true;
+}
+
+bool polySignature( ast::vector< ast::Type > const & params, std::size_t & hash ) {
+	hash = params.size();
+	for ( auto const & param : params ) {
+		std::size_t paramHash;
+		if ( !polySignature( param, paramHash ) ) return false;
+		hash = hash * 31 + paramHash;
+	}
+	return true;
+}
+
 /// Abstracts type equality for a list of parameter types.
 struct TypeList {
 	TypeList() : params() {}
@@ -69,14 +107,15 @@ struct TypeList {
 		return *this;
 	}
 
-	bool operator==( TypeList const & that ) const {
-		if ( params.size() != that.params.size() ) {
+	/// Compares against the parameters of a use without copying them.
+	bool operator==( type_vector const & that ) const {
+		if ( params.size() != that.size() ) {
 			return false;
 		}
 
-		for ( auto it = params.begin(), jt = that.params.begin() ;
-				it != params.end() ; ++it, ++jt ) {
-			if ( !typesPolyCompatible( it->get(), jt->get() ) ) {
+		auto jt = that.begin();
+		for ( auto it = params.begin() ; it != params.end() ; ++it, ++jt ) {
+			if ( !typesPolyCompatible( it->get(), (*jt)->type.get() ) ) {
 				return false;
 			}
 		}
@@ -89,14 +128,38 @@ struct TypeList {
 /// Maps a key and a TypeList to a valuue. Also supports scoping.
 class InstantiationMap final {
 	/// Wraps value for a specific (AggregateDecl, TypeList) combination.
-	using Instantiation = std::pair<TypeList, ast::ptr<ast::AggregateDecl>>;
+	struct Instantiation {
+		TypeList params;
+		ast::ptr<ast::AggregateDecl> value;
+		/// Insertion order, later instantiations are preferred.
+		std::size_t order;
+	};
 	/// List of TypeLists paired with the appropriate values.
 	using ValueList = std::vector<Instantiation>;
-	/// Underlying map type; maps keys to a linear list of corresponding
+	/// The instantiations of one declaration in one scope. Those with a
+	/// signature are hashed on it, the rest can match any signature.
+	struct ValueIndex {
+		std::unordered_map<std::size_t, ValueList> bySignature;
+		ValueList open;
+	};
+	/// Underlying map type; maps keys to the index of corresponding
 	/// TypeLists and values.
-	using InnerMap = ScopedMap<ast::ptr<ast::AggregateDecl>, ValueList>;
+	using InnerMap = ScopedMap<ast::ptr<ast::AggregateDecl>, ValueIndex>;
 
 	InnerMap data;
+	std::size_t count = 0;
+
+	/// Updates best with the latest match in the list.
+	static void findIn( ValueList const & list, type_vector const & params,
+			Instantiation const *& best ) {
+		for ( auto inst = list.rbegin() ; inst != list.rend() ; ++inst ) {
+			if ( best && inst->order < best->order ) return;
+			if ( inst->params == params ) {
+				best = &*inst;
+				return;
+			}
+		}
+	}
 public:
 	void beginScope() { data.beginScope(); }
 	void endScope() { data.endScope(); }
@@ -108,17 +171,26 @@ public:
 			type_vector const & params ) const {
 		// This type repackaging is used for the helpers.
 		ast::ptr<ast::AggregateDecl> ptr = key;
-		TypeList typeList( params );
+		std::size_t hash;
+		bool hashed = polySignature( params, hash );
 
 		// Scan scopes for matches to the key.
 		for ( auto insts = data.find( key ) ;
 				insts != data.end() ; insts = data.findNext( insts, ptr )) {
-			for ( auto inst = insts->second.rbegin() ;
-					inst != insts->second.rend() ; ++inst ) {
-				if ( inst->first == typeList ) {
-					return inst->second;
+			ValueIndex const & index = insts->second;
+			Instantiation const * best = nullptr;
+			if ( hashed ) {
+				auto bucket = index.bySignature.find( hash );
+				if ( bucket != index.bySignature.end() ) {
+					findIn( bucket->second, params, best );
+				}
+			} else {
+				for ( auto const & bucket : index.bySignature ) {
+					findIn( bucket.second, params, best );
 				}
 			}
+			findIn( index.open, params, best );
+			if ( best ) return best->value;
 		}
 		return nullptr;
 	}
@@ -128,11 +200,14 @@ public:
 			ast::AggregateDecl const * value ) {
 		auto it = data.findAt( data.currentScope(), key );
 		if ( it == data.end() ) {
-			data.insert( key, ValueList( 1,
-				Instantiation( TypeList( params ), value ) ) );
+			it = data.insert( key, ValueIndex() ).first;
+		}
+		Instantiation inst = { TypeList( params ), value, count++ };
+		std::size_t hash;
+		if ( polySignature( inst.params.params, hash ) ) {
+			it->second.bySignature[ hash ].push_back( std::move( inst ) );
 		} else {
-			it->second.emplace_back(
-				Instantiation( TypeList( params ), value ) );
+			it->second.open.push_back( std::move( inst ) );
 		}
 	}
 };
@@ -152,7 +227,7 @@ GenericType & operator|=( GenericType & gt, const GenericType & ht ) {
 	return gt;
 }
 
-bool isDtypeStatic( ast::vector<ast::TypeDecl> const & baseParams ) {
+bool isDtypeStatic( std::vector<ast::ptr<ast::TypeDecl>> const & baseParams ) {
 	return std::all_of( baseParams.begin(), baseParams.end(),
 		[]( ast::TypeDecl const * td ){ return !td->isComplete(); }
 	);
@@ -164,7 +239,7 @@ bool isDtypeStatic( ast::vector<ast::TypeDecl> const & baseParams ) {
 /// least one parameter type, and dynamic if there is no concrete instantiation.
 GenericType makeSubstitutions(
 		ast::vector<ast::TypeExpr> & out,
-		ast::vector<ast::TypeDecl> const & baseParams,
+		std::vector<ast::ptr<ast::TypeDecl>> const & baseParams,
 		ast::vector<ast::Expr> const & params ) {
 	GenericType gt = GenericType::dtypeStatic;
 
@@ -216,11 +291,11 @@ GenericType makeSubstitutions(
 
 /// Substitutes types of members according to baseParams => typeSubs,
 /// returning the result in a new vector.
-ast::vector<ast::Decl> substituteMembers(
-		ast::vector<ast::Decl> const & members,
-		ast::vector<ast::TypeDecl> const & baseParams,
+std::vector<ast::ptr<ast::Decl>> substituteMembers(
+		std::vector<ast::ptr<ast::Decl>> const & members,
+		std::vector<ast::ptr<ast::TypeDecl>> const & baseParams,
 		ast::vector<ast::TypeExpr> const & typeSubs ) {
-	ast::vector<ast::Decl> out;
+	std::vector<ast::ptr<ast::Decl>> out;
 	ast::TypeSubstitution subs( baseParams, typeSubs );
 	for ( ast::ptr<ast::Decl> const & member : members ) {
 		// Create a manual copy to avoid in-place mutation.
@@ -237,8 +312,8 @@ ast::vector<ast::Decl> substituteMembers(
 /// Substitutes types of members according to baseParams => typeSubs,
 /// modifying them in-place.
 void substituteMembersHere(
-		ast::vector<ast::Decl> & members,
-		ast::vector<ast::TypeDecl> const & baseParams,
+		std::vector<ast::ptr<ast::Decl>> & members,
+		std::vector<ast::ptr<ast::TypeDecl>> const & baseParams,
 		ast::vector<ast::TypeExpr> const & typeSubs ) {
 	ast::TypeSubstitution subs( baseParams, typeSubs );
 	for ( ast::ptr<ast::Decl> & member : members ) {
@@ -287,7 +362,7 @@ private:
 		Aggr const * inst, ast::MemberExpr const * memberExpr );
 
 	ast::Expr const * fixMemberExpr(
-		ast::vector<ast::TypeDecl> const & baseParams,
+		std::vector<ast::ptr<ast::TypeDecl>> const & baseParams,
 		ast::MemberExpr const * memberExpr );
 
 	bool isLValueArg = false;
@@ -349,7 +424,7 @@ ast::Expr const * FixDtypeStatic::fixMemberExpr(
 }
 
 ast::Expr const * FixDtypeStatic::fixMemberExpr(
-		ast::vector<ast::TypeDecl> const & baseParams,
+		std::vector<ast::ptr<ast::TypeDecl>> const & baseParams,
 		ast::MemberExpr const * memberExpr ) {
 	// Need to cast dtype-static member expressions to their actual type
 	// before the actual type type is erased.
@@ -485,7 +560,7 @@ private:
 	/// Strips a dtype-static aggregate decl of its type parameters,
 	/// marks it as stripped.
 	void stripDtypeParams( ast::AggregateDecl * base,
-		ast::vector<ast::TypeDecl> & baseParams,
+		std::vector<ast::ptr<ast::TypeDecl>> & baseParams,
 		ast::vector<ast::TypeExpr> const & typeSubs );
 };
 
@@ -584,7 +659,7 @@ void GenericInstantiator::previsit( ast::MemberExpr const * expr ) {
 		// Find the location of the member:
 		ast::AggregateDecl const * aggr =
 			expr->aggregate->result.strict_as<ast::BaseInstType>()->aggr();
-		ast::vector<ast::Decl> const & members = aggr->members;
+		std::vector<ast::ptr<ast::Decl>> const & members = aggr->members;
 		auto it = std::find( members.begin(), members.end(), expr->member );
 		memberIndex = std::distance( members.begin(), it );
 		assertf( memberIndex < (int)members.size(), "Could not find member %s in generic type %s.", toString( expr->member ).c_str(), toString( expr->aggregate ).c_str() );
@@ -710,7 +785,7 @@ ast::Type const * GenericInstantiator::replaceWithConcrete(
 
 void GenericInstantiator::stripDtypeParams(
 		ast::AggregateDecl * base,
-		ast::vector<ast::TypeDecl> & baseParams,
+		std::vector<ast::ptr<ast::TypeDecl>> & baseParams,
 		ast::vector<ast::TypeExpr> const & typeSubs ) {
 	substituteMembersHere( base->members, baseParams, typeSubs );
 
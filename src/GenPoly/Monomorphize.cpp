@@ -0,0 +1,370 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// Monomorphize.cpp -- Clone polymorphic functions for their concrete uses.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 10:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 10:00:00 2026
+// Update Count     : 0
+//
+
+#include "Monomorphize.hpp"
+
+#include <list>                          // for list
+#include <map>                           // for map
+#include <string>                        // for string, to_string
+#include <unordered_map>                 // for unordered_map
+#include <unordered_set>                 // for unordered_set
+
+#include "AST/Copy.hpp"                  // for deepCopy
+#include "AST/Decl.hpp"                  // for FunctionDecl, TypeDecl, ...
+#include "AST/Expr.hpp"                  // for ApplicationExpr, VariableExpr
+#include "AST/Pass.hpp"                  // for Pass, WithDeclsToAdd, ...
+#include "AST/Stmt.hpp"                  // for CompoundStmt
+#include "AST/TranslationUnit.hpp"       // for TranslationUnit
+#include "AST/TypeSubstitution.hpp"      // for TypeSubstitution
+#include "Common/Stats/Counter.hpp"      // for SimpleCounter
+#include "Common/UniqueName.hpp"         // for UniqueName
+#include "Common/Utility.hpp"            // for erase_if
+#include "GenPoly/GenPoly.hpp"           // for getFunctionType, isClosedOver
+#include "ResolvExpr/Unify.hpp"          // for typesCompatible
+#include "SymTab/Mangler.hpp"            // for mangle, mangleType
+
+namespace GenPoly {
+
+namespace {
+
+auto stats() {
+	using namespace Stats::Counters;
+	static auto group = build<CounterGroup>("Monomorphize");
+	static struct {
+		SimpleCounter * clones;
+		SimpleCounter * calls;
+		SimpleCounter * nodes;
+		SimpleCounter * direct;
+		SimpleCounter * overBudget;
+	} ret = {
+		.clones     = build<SimpleCounter>("Clones", group),
+		.calls      = build<SimpleCounter>("Calls Redirected", group),
+		.nodes      = build<SimpleCounter>("Cloned Nodes", group),
+		.direct     = build<SimpleCounter>("Assertion Calls Made Direct", group),
+		.overBudget = build<SimpleCounter>("Over Budget", group),
+	};
+	return ret;
+}
+
+bool isMonomorphizeAttr( ast::Attribute const * attr ) {
+	return "cfa_monomorphize" == attr->name;
+}
+
+bool isMarked( ast::DeclWithType const * decl ) {
+	for ( ast::ptr<ast::Attribute> const & attr : decl->attributes ) {
+		if ( isMonomorphizeAttr( attr ) ) return true;
+	}
+	return false;
+}
+
+/// Counts the nodes in a tree, the size of a clone.
+struct NodeCounter final {
+	std::size_t count = 0;
+	void previsit( ast::Node const * ) { ++count; }
+	std::size_t result() { return count; }
+};
+
+/// Replaces the type parameters of a function with their arguments and its
+/// assertions with the expressions that satisfy them.
+struct Substituter final : public ast::WithVisitorRef<Substituter> {
+	std::unordered_map<ast::TypeDecl const *, ast::ptr<ast::Type>> types;
+	std::unordered_map<ast::DeclWithType const *, ast::ptr<ast::VariableExpr>> assertions;
+
+	ast::Type const * postvisit( ast::TypeInstType const * inst );
+	ast::Expr const * postvisit( ast::Expr const * expr );
+};
+
+ast::Type const * Substituter::postvisit( ast::TypeInstType const * inst ) {
+	auto found = types.find( inst->base );
+	if ( found == types.end() ) return inst;
+	ast::ptr<ast::Type> newType = found->second;
+	add_qualifiers( newType, inst->qualifiers );
+	return newType.release();
+}
+
+ast::Expr const * Substituter::postvisit( ast::Expr const * expr ) {
+	auto var = dynamic_cast<ast::VariableExpr const *>( expr );
+	auto actual = var ? assertions.find( var->var ) : assertions.end();
+	if ( actual == assertions.end()
+			&& !expr->env && !expr->inferred.hasParams() ) {
+		return expr;
+	}
+
+	ast::Expr * mutExpr = ( actual == assertions.end() )
+		? ast::mutate( expr ) : ast::deepCopy( actual->second.get() );
+	if ( actual != assertions.end() ) {
+		++*stats().direct;
+		mutExpr->env = expr->env;
+	}
+	// The environment and inferred parameters are not children of the
+	// expression, so they are not visited by the pass.
+	if ( mutExpr->env ) {
+		mutExpr->env = mutExpr->env->accept( *visitor );
+	}
+	if ( expr->inferred.hasParams() ) {
+		ast::InferredParams * params =
+			new ast::InferredParams( expr->inferred.inferParams() );
+		for ( auto & entry : *params ) {
+			ast::ParamEntry & param = entry.second;
+			if ( param.actualType ) {
+				param.actualType = param.actualType->accept( *visitor );
+			}
+			if ( param.formalType ) {
+				param.formalType = param.formalType->accept( *visitor );
+			}
+			param.expr = param.expr->accept( *visitor );
+			if ( auto newVar = param.expr.as<ast::VariableExpr>() ) {
+				param.decl = newVar->var->uniqueId;
+				param.declptr = newVar->var;
+			}
+		}
+		mutExpr->inferred.set_inferParams( params );
+	}
+	return mutExpr;
+}
+
+/// Clones polymorphic functions for calls with concrete type arguments and
+/// assertions. The clones are static, shared by the whole translation unit
+/// and go before the first top level declaration using them.
+struct MonomorphizeCore final :
+		public ast::WithConstTypeSubstitution,
+		public ast::WithDeclsToAdd,
+		public ast::WithGuards,
+		public ast::WithVisitorRef<MonomorphizeCore> {
+	MonomorphizeCore( bool all, std::size_t budget ) :
+		all( all ), budget( budget ) {}
+
+	void previsit( ast::Decl const * decl );
+	void postvisit( ast::Decl const * decl );
+	ast::Expr const * postvisit( ast::ApplicationExpr const * expr );
+
+private:
+	void makeClone(
+		ast::FunctionDecl * clone,
+		std::vector<ast::ptr<ast::Type>> const & typeArgs,
+		std::vector<ast::ptr<ast::VariableExpr>> const & actuals );
+
+	bool all;
+	/// Nodes that may still be cloned.
+	std::size_t budget;
+
+	/// The clones, by function and by type arguments and assertions.
+	std::map< std::pair< ast::FunctionDecl const *, std::string >,
+		ast::FunctionDecl const * > clones;
+	/// Clones made in the current top level declaration.
+	std::list< ast::ptr<ast::Decl> > newClones;
+	/// Top level declarations so far, which clones may use.
+	std::unordered_set< ast::Decl const * > globalDecls;
+	/// Top level function definitions so far, by mangled name, so calls
+	/// through an earlier prototype can find the body.
+	std::unordered_map< std::string, ast::FunctionDecl const * > definitions;
+	ast::Decl const * topDecl = nullptr;
+	unsigned declDepth = 0;
+};
+
+void MonomorphizeCore::previsit( ast::Decl const * decl ) {
+	if ( 0 == declDepth ) topDecl = decl;
+	GuardValue( declDepth ) += 1;
+}
+
+void MonomorphizeCore::postvisit( ast::Decl const * decl ) {
+	if ( 1 != declDepth ) return;
+	if ( 1 < newClones.size() ) {
+		// Clones may call each other, so declare them all first.
+		for ( ast::ptr<ast::Decl> const & clone : newClones ) {
+			ast::FunctionDecl * proto =
+				ast::deepCopy( clone.strict_as<ast::FunctionDecl>() );
+			proto->stmts = nullptr;
+			declsToAddBefore.push_back( proto );
+		}
+	}
+	declsToAddBefore.splice( declsToAddBefore.end(), newClones );
+	// Uses refer to the declaration as it was before this pass.
+	globalDecls.insert( topDecl );
+	globalDecls.insert( decl );
+	if ( auto func = dynamic_cast<ast::FunctionDecl const *>( decl ) ) {
+		if ( func->stmts ) definitions[ func->mangleName ] = func;
+	}
+}
+
+ast::Expr const * MonomorphizeCore::postvisit(
+		ast::ApplicationExpr const * expr ) {
+	auto var = expr->func.as<ast::VariableExpr>();
+	if ( !var ) return expr;
+	auto decl = var->var.as<ast::FunctionDecl>();
+	if ( !decl || decl->type_params.empty()
+			|| decl->linkage != ast::Linkage::Cforall ) {
+		return expr;
+	}
+
+	// The body must be complete, so recursive calls are left as they are.
+	ast::FunctionDecl const * def = nullptr;
+	auto found = definitions.find( decl->mangleName );
+	if ( found != definitions.end() ) def = found->second;
+	if ( !def || !( all || isMarked( decl ) || isMarked( def ) ) ) return expr;
+
+	ast::FunctionType const * type = getFunctionType( expr->func->result );
+	if ( !type || !typeSubs
+			|| type->forall.size() != def->type_params.size()
+			|| type->assertions.size() != def->assertions.size() ) {
+		return expr;
+	}
+
+	// Every type argument must be concrete and visible before this declaration.
+	std::string key;
+	std::vector<ast::ptr<ast::Type>> typeArgs;
+	ast::Pass<Substituter> substituter;
+	for ( std::size_t i = 0 ; i < type->forall.size() ; ++i ) {
+		ast::TypeDecl const * param = def->type_params[i];
+		if ( ast::TypeDecl::Ttype == param->kind
+				|| ast::TypeDecl::Dimension == param->kind ) {
+			return expr;
+		}
+		ast::Type const * arg = typeSubs->lookup( type->forall[i] );
+		if ( !arg || !isClosedOver( arg, globalDecls ) ) return expr;
+		typeArgs.emplace_back( arg );
+		substituter.core.types.emplace( param, arg );
+		key += Mangle::mangleType( arg );
+	}
+
+	// Every assertion must be satisfied by a top level declaration of the
+	// same type, which the clone calls directly.
+	std::vector<ast::ptr<ast::VariableExpr>> actuals;
+	if ( !type->assertions.empty() && !expr->inferred.hasParams() ) return expr;
+	for ( std::size_t i = 0 ; i < type->assertions.size() ; ++i ) {
+		auto param = expr->inferred.inferParams().find(
+			type->assertions[i]->var->uniqueId );
+		if ( param == expr->inferred.inferParams().end() ) return expr;
+		auto actual = param->second.expr.as<ast::VariableExpr>();
+		if ( !actual || !globalDecls.count( actual->var.get() ) ) return expr;
+		ast::DeclWithType const * assertion = def->assertions[i];
+		if ( assertion->name != type->assertions[i]->var->name ) return expr;
+		// Copied, the pass would change the nodes of the definition in place.
+		ast::ptr<ast::Type> formal = ast::deepCopy( assertion->get_type() );
+		formal = formal->accept( substituter );
+		// Function assertions are pointers to functions by now.
+		ast::Type const * formalType = getFunctionType( formal );
+		ast::Type const * actualType = getFunctionType( actual->var->get_type() );
+		if ( !formalType || !actualType ) {
+			formalType = formal;
+			actualType = actual->var->get_type();
+		}
+		if ( !ResolvExpr::typesCompatible( formalType, actualType ) ) {
+			return expr;
+		}
+		actuals.emplace_back( actual );
+		key += "|" + std::to_string( actual->var->uniqueId );
+	}
+
+	ast::FunctionDecl const * clone = nullptr;
+	auto cached = clones.find( { def, key } );
+	if ( cached != clones.end() ) {
+		clone = cached->second;
+	} else {
+		std::size_t size = ast::Pass<NodeCounter>::read( def->stmts.get() );
+		if ( budget < size ) {
+			++*stats().overBudget;
+			return expr;
+		}
+		budget -= size;
+		*stats().nodes += size;
+		ast::FunctionDecl * newClone = ast::deepCopy( def );
+		// Calls in the clone use it, recursive calls included.
+		clones.emplace( std::make_pair( def, key ), newClone );
+		makeClone( newClone, typeArgs, actuals );
+		clone = newClone;
+	}
+
+	++*stats().calls;
+	ast::ApplicationExpr * mutExpr = ast::mutate( expr );
+	mutExpr->func = new ast::VariableExpr( expr->location, clone );
+	mutExpr->inferred.set_inferParams( nullptr );
+	return mutExpr;
+}
+
+void MonomorphizeCore::makeClone(
+		ast::FunctionDecl * clone,
+		std::vector<ast::ptr<ast::Type>> const & typeArgs,
+		std::vector<ast::ptr<ast::VariableExpr>> const & actuals ) {
+	static UniqueName monoNamer( "_mono" );
+	++*stats().clones;
+
+	// Held, so the passes change it in place.
+	ast::ptr<ast::FunctionDecl> holder = clone;
+
+	// The parameters are kept alive until nothing refers to them.
+	std::vector<ast::ptr<ast::TypeDecl>> typeParams;
+	std::vector<ast::ptr<ast::DeclWithType>> assertions;
+	typeParams.swap( clone->type_params );
+	assertions.swap( clone->assertions );
+	ast::FunctionType * type = ast::mutate( clone->type.get() );
+	type->forall.clear();
+	type->assertions.clear();
+	clone->type = type;
+
+	ast::Pass<Substituter> substituter;
+	for ( std::size_t i = 0 ; i < typeParams.size() ; ++i ) {
+		substituter.core.types.emplace( typeParams[i], typeArgs[i] );
+	}
+	for ( std::size_t i = 0 ; i < assertions.size() ; ++i ) {
+		substituter.core.assertions.emplace( assertions[i], actuals[i] );
+	}
+	ast::Decl const * substituted = clone->accept( substituter );
+	assert( substituted == clone );
+
+	clone->name = monoNamer.newName();
+	clone->uniqueId = 0;
+	clone->fixUniqueId();
+	clone->storage.is_extern = false;
+	clone->storage.is_static = true;
+	erase_if( clone->attributes, isMonomorphizeAttr );
+	clone->mangleName = Mangle::mangle( clone );
+
+	// Clone the calls in the clone as well, they are now concrete.
+	ast::Decl const * visited = clone->accept( *visitor );
+	assert( visited == clone );
+	newClones.push_back( clone );
+}
+
+} // namespace
+
+void monomorphize( ast::TranslationUnit & translationUnit,
+		bool all, std::size_t budget ) {
+	bool marked = all;
+	for ( ast::ptr<ast::Decl> const & decl : translationUnit.decls ) {
+		auto func = decl.as<ast::FunctionDecl>();
+		marked = marked || ( func && isMarked( func ) );
+	}
+	if ( !marked ) return;
+
+	ast::Pass<MonomorphizeCore>::run( translationUnit, all, budget );
+
+	// The attribute is not passed on to the C compiler.
+	for ( ast::ptr<ast::Decl> & decl : translationUnit.decls ) {
+		auto func = decl.as<ast::FunctionDecl>();
+		if ( !func || !isMarked( func ) ) continue;
+		ast::FunctionDecl * mutFunc = ast::mutate( func );
+		erase_if( mutFunc->attributes, isMonomorphizeAttr );
+		decl = mutFunc;
+	}
+}
+
+} // namespace GenPoly
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
@@ -0,0 +1,40 @@
+//
+// Cforall Version 1.0.0 Copyright (C) 2015 University of Waterloo
+//
+// The contents of this file are covered under the licence agreement in the
+// file "LICENCE" distributed with Cforall.
+//
+// Monomorphize.hpp -- Clone polymorphic functions for their concrete uses.
+//
+// Author           : agent
+// Created On       : Fri Oct 16 10:00:00 2026
+// Last Modified By : agent
+// Last Modified On : Fri Oct 16 10:00:00 2026
+// Update Count     : 0
+//
+
+#pragma once
+
+#include <cstddef>
+
+namespace ast {
+	class TranslationUnit;
+}
+
+namespace GenPoly {
+
+/// Replaces calls to polymorphic functions, where every type argument and
+/// assertion is concrete, with calls to a copy of the function specialized
+/// for those arguments, so the copy passes no layout or assertion parameters.
+/// If `all` is false, only functions with the cfa_monomorphize attribute are
+/// copied. The copies together are at most `budget` AST nodes.
+void monomorphize( ast::TranslationUnit & translationUnit,
+	bool all, std::size_t budget );
+
+} // namespace GenPoly
+
+// Local Variables: //
+// tab-width: 4 //
+// mode: c++ //
+// compile-command: "make install" //
+// End: //
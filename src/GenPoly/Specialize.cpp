@@ -19,6 +19,8 @@
 #include "AST/Inspect.hpp"               // for isIntrinsicCallExpr
 #include "AST/Pass.hpp"                  // for Pass
 #include "AST/TypeEnvironment.hpp"       // for OpenVarSet, AssertionSet
+#include "AST/Vector.hpp"                // for vector
+#include "Common/Stats/Counter.hpp"      // for SimpleCounter
 #include "Common/UniqueName.hpp"         // for UniqueName
 #include "GenPoly/GenPoly.hpp"           // for getFunctionType
 #include "ResolvExpr/FindOpenVars.hpp"   // for findOpenVars
@@ -27,12 +29,40 @@ namespace GenPoly {
 
 namespace {
 
+auto thunkStats() {
+	using namespace Stats::Counters;
+	static auto group = build<CounterGroup>("Thunks");
+	static struct {
+		SimpleCounter * shared;
+		SimpleCounter * reused;
+		SimpleCounter * nested;
+	} ret = {
+		.shared = build<SimpleCounter>("Shared", group),
+		.reused = build<SimpleCounter>("Duplicates Removed", group),
+		.nested = build<SimpleCounter>("Nested", group),
+	};
+	return ret;
+}
+
+/// Thunks that call a top level function and have closed types are shared by
+/// the whole translation unit, the rest are made at each use.
 struct SpecializeCore final :
 		public ast::WithConstTypeSubstitution,
 		public ast::WithDeclsToAdd,
+		public ast::WithGuards,
 		public ast::WithVisitorRef<SpecializeCore> {
 	std::string paramPrefix = "_p";
 
+	/// The shared thunks, by target and by thunk and target types.
+	std::map< std::pair< const ast::DeclWithType *, std::string >,
+		const ast::FunctionDecl * > globalThunks;
+	/// Shared thunks made in the current top level declaration.
+	std::list< ast::ptr<ast::Decl> > newGlobalThunks;
+	/// Top level declarations so far, which shared thunks may use.
+	std::unordered_set< const ast::Decl * > globalDecls;
+	const ast::Decl * topDecl = nullptr;
+	unsigned declDepth = 0;
+
 	ast::ApplicationExpr * handleExplicitParams(
 		const ast::ApplicationExpr * expr );
 	const ast::Expr * createThunkFunction(
@@ -46,6 +76,8 @@ struct SpecializeCore final :
 		const ast::Expr * actual,
 		const ast::InferredParams * inferParams );
 
+	void previsit( const ast::Decl * decl );
+	void postvisit( const ast::Decl * decl );
 	const ast::Expr * postvisit( const ast::ApplicationExpr * expr );
 	const ast::Expr * postvisit( const ast::CastExpr * expr );
 };
@@ -80,7 +112,8 @@ bool isTupleStructureMatching( const ast::Type * t0, const ast::Type * t1 ) {
 }
 
 // The number of elements in a list, if all tuples had been flattened.
-size_t flatTypeListSize( const std::vector<ast::ptr<ast::Type>> & types ) {
+template<typename TypeList>
+size_t flatTypeListSize( const TypeList & types ) {
 	size_t sum = 0;
 	for ( const ast::ptr<ast::Type> & type : types ) {
 		if ( const ast::TupleType * tuple = type.as<ast::TupleType>() ) {
@@ -189,8 +222,8 @@ ast::ApplicationExpr * SpecializeCore::handleExplicitParams(
 
 	ast::ApplicationExpr * mut = ast::mutate( expr );
 
-	std::vector<ast::ptr<ast::Type>>::const_iterator formal;
-	std::vector<ast::ptr<ast::Expr>>::iterator actual;
+	ast::vector<ast::Type>::const_iterator formal;
+	ast::vector<ast::Expr>::iterator actual;
 	for ( formal = func->params.begin(), actual = mut->args.begin() ;
 			formal != func->params.end() && actual != mut->args.end() ;
 			++formal, ++actual ) {
@@ -268,6 +301,32 @@ const ast::Expr * SpecializeCore::createThunkFunction(
 		newType = result.node.release();
 	}
 
+	const ast::FunctionType * actualType = ast::deepCopy( getFunctionType( actual->result ) );
+	if ( typeSubs ) {
+		// Need to apply the environment to the actual function's type,
+		// since it may itself be polymorphic.
+		auto result = typeSubs->apply( actualType );
+		actualType = result.node.release();
+	}
+
+	ast::ptr<ast::FunctionType> actualTypeManager = actualType;
+
+	// The target's type is part of the key, it fixes how the target is called.
+	auto target = dynamic_cast<const ast::VariableExpr *>( actual );
+	bool shareable = target && globalDecls.count( target->var.get() )
+		&& ( !inferParams || inferParams->empty() )
+		&& isClosedOver( newType, globalDecls );
+	std::pair< const ast::DeclWithType *, std::string > key;
+	if ( shareable ) {
+		key = { target->var, Mangle::mangle( newType ) + Mangle::mangle( actualType ) };
+		auto shared = globalThunks.find( key );
+		if ( shared != globalThunks.end() ) {
+			++*thunkStats().reused;
+			return new ast::AddressExpr( location,
+				new ast::VariableExpr( location, shared->second ) );
+		}
+	}
+
 	using DWTVector = std::vector<ast::ptr<ast::DeclWithType>>;
 	using DeclVector = std::vector<ast::ptr<ast::TypeDecl>>;
 
@@ -322,16 +381,6 @@ const ast::Expr * SpecializeCore::createThunkFunction(
 	// naming thunk parameters as we go.
 	ast::ApplicationExpr * app = new ast::ApplicationExpr( location, actual );
 
-	const ast::FunctionType * actualType = ast::deepCopy( getFunctionType( actual->result ) );
-	if ( typeSubs ) {
-		// Need to apply the environment to the actual function's type,
-		// since it may itself be polymorphic.
-		auto result = typeSubs->apply( actualType );
-		actualType = result.node.release();
-	}
-
-	ast::ptr<ast::FunctionType> actualTypeManager = actualType;
-
 	std::vector<ast::ptr<ast::Expr>> args;
 	for ( ast::ptr<ast::DeclWithType> & param : thunkFunc->params ) {
 		// Name each thunk parameter and explode it.
@@ -369,6 +418,7 @@ const ast::Expr * SpecializeCore::createThunkFunction(
 		// Write recursive specializations into the thunk body.
 		for ( const ast::ptr<ast::Decl> & decl : declsToAddBefore ) {
 			thunkBody->push_back( new ast::DeclStmt( decl->location, decl ) );
+			shareable = false;
 		}
 
 		declsToAddBefore = std::move( oldDecls );
@@ -385,7 +435,15 @@ const ast::Expr * SpecializeCore::createThunkFunction(
 	thunkBody->push_back( appStmt );
 
 	// Add the thunk definition:
-	declsToAddBefore.push_back( thunkFunc );
+	if ( shareable ) {
+		++*thunkStats().shared;
+		thunkFunc->storage.is_static = true;
+		globalThunks.emplace( key, thunkFunc );
+		newGlobalThunks.push_back( thunkFunc );
+	} else {
+		++*thunkStats().nested;
+		declsToAddBefore.push_back( thunkFunc );
+	}
 
 	// Return address of thunk function as replacement expression.
 	return new ast::AddressExpr( location,
@@ -419,6 +477,21 @@ const ast::Expr * SpecializeCore::doSpecialization(
 	}
 }
 
+void SpecializeCore::previsit( const ast::Decl * decl ) {
+	if ( 0 == declDepth ) topDecl = decl;
+	GuardValue( declDepth ) += 1;
+}
+
+void SpecializeCore::postvisit( const ast::Decl * decl ) {
+	if ( 1 == declDepth ) {
+		// Shared thunks go before the first top level declaration using them.
+		declsToAddBefore.splice( declsToAddBefore.end(), newGlobalThunks );
+		// Uses refer to the declaration as it was before this pass.
+		globalDecls.insert( topDecl );
+		globalDecls.insert( decl );
+	}
+}
+
 const ast::Expr * SpecializeCore::postvisit(
 		const ast::ApplicationExpr * expr ) {
 	if ( ast::isIntrinsicCallExpr( expr ) ) {
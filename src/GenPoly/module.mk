@@ -29,6 +29,8 @@ SRC += $(SRC_GENPOLY) \
 	GenPoly/InstantiateGeneric.cpp \
 	GenPoly/InstantiateGeneric.hpp \
 	GenPoly/Lvalue.cpp \
+	GenPoly/Monomorphize.cpp \
+	GenPoly/Monomorphize.hpp \
 	GenPoly/ScopedSet.hpp \
 	GenPoly/ScrubTypeVars.cpp \
 	GenPoly/ScrubTypeVars.hpp \
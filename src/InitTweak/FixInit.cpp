@@ -895,6 +895,7 @@ const ast::DeclWithType * FixInit::postvisit( const ast::ObjectDecl *_objDecl )
 				// but there shouldn't be any remaining past this point.
 				static UniqueName staticNamer( "_static_var" );
 				objDecl->name = objDecl->name + staticNamer.newName();
+				objDecl->clearMangleCache();
 				objDecl->mangleName = Mangle::mangle( objDecl );
 				objDecl->init = nullptr;
 
@@ -29,6 +29,7 @@
 #include "AST/Pass.hpp"
 #include "AST/Stmt.hpp"
 #include "AST/Type.hpp"
+#include "AST/Vector.hpp"
 #include "CodeGen/OperatorTable.hpp"  // for isConstructor, isDestructor, isC...
 #include "Common/SemanticError.hpp"   // for SemanticError
 #include "Common/ToString.hpp"        // for toCString
@@ -73,7 +74,7 @@ namespace {
 		int curDepth = 0, maxDepth = 0;
 		InitDepthChecker( const ast::Type * type ) : type( type ) {
 			const ast::Type * t = type;
-			while ( auto at = dynamic_cast< const ast::ArrayType * >( t ) ) {
+			while ( auto at = ast::dyn_cast< ast::ArrayType >( t ) ) {
 				maxDepth++;
 				t = at->base;
 			}
@@ -130,7 +131,7 @@ namespace {
 		const ast::Expr * dimension = indices[idx++];
 
 		if ( idx == indices.size() ) {
-			if ( auto listInit = dynamic_cast< const ast::ListInit * >( init ) ) {
+			if ( auto listInit = ast::dyn_cast< ast::ListInit >( init ) ) {
 				for ( const ast::Init * init : *listInit ) {
 					buildCallExpr( shallowCopy(callExpr), index, dimension, init, out );
 				}
@@ -141,7 +142,7 @@ namespace {
 			const CodeLocation & loc = init->location;
 
 			unsigned long cond = 0;
-			auto listInit = dynamic_cast< const ast::ListInit * >( init );
+			auto listInit = ast::dyn_cast< ast::ListInit >( init );
 			if ( ! listInit ) { SemanticError( loc, "unbalanced list initializers" ); }
 
 			static UniqueName targetLabel( "L__autogen__" );
@@ -258,10 +259,10 @@ namespace {
 			const ast::Expr * arg = addressExpr->arg;
 
 			// Address of a variable or member expression is const-expr.
-			if ( !dynamic_cast< const ast::NameExpr * >( arg )
-				&& !dynamic_cast< const ast::VariableExpr * >( arg )
-				&& !dynamic_cast< const ast::MemberExpr * >( arg )
-				&& !dynamic_cast< const ast::UntypedMemberExpr * >( arg ) ) result = false;
+			if ( !ast::dyn_cast< ast::NameExpr >( arg )
+				&& !ast::dyn_cast< ast::VariableExpr >( arg )
+				&& !ast::dyn_cast< ast::MemberExpr >( arg )
+				&& !ast::dyn_cast< ast::UntypedMemberExpr >( arg ) ) result = false;
 		}
 
 		// These expressions may be const expr, depending on their children.
@@ -322,7 +323,7 @@ bool isCopyFunction( const ast::FunctionDecl * decl ) {
 
 const ast::Type * getTypeofThis( const ast::FunctionType * ftype ) {
 	assertf( ftype, "getTypeofThis: nullptr ftype" );
-	const std::vector<ast::ptr<ast::Type>> & params = ftype->params;
+	const ast::vector<ast::Type> & params = ftype->params;
 	assertf( !params.empty(), "getTypeofThis: ftype with 0 parameters: %s",
 			toCString( ftype ) );
 	const ast::ReferenceType * refType =
@@ -374,7 +375,7 @@ std::vector< ast::ptr< ast::Expr > > makeInitList( const ast::Init * init ) {
 }
 
 bool tryConstruct( const ast::DeclWithType * dwt ) {
-	auto objDecl = dynamic_cast< const ast::ObjectDecl * >( dwt );
+	auto objDecl = ast::dyn_cast< ast::ObjectDecl >( dwt );
 	if ( !objDecl ) return false;
 	return (objDecl->init == nullptr ||
 			( objDecl->init != nullptr && objDecl->init->maybeConstructed ))
@@ -383,8 +384,8 @@ bool tryConstruct( const ast::DeclWithType * dwt ) {
 }
 
 bool isConstructable( const ast::Type * type ) {
-	return !dynamic_cast< const ast::VarArgsType * >( type ) && !dynamic_cast< const ast::ReferenceType * >( type )
-		&& !dynamic_cast< const ast::FunctionType * >( type ) && !Tuples::isTtype( type );
+	return !ast::dyn_cast< ast::VarArgsType >( type ) && !ast::dyn_cast< ast::ReferenceType >( type )
+		&& !ast::dyn_cast< ast::FunctionType >( type ) && !Tuples::isTtype( type );
 }
 
 bool isDesignated( const ast::Init * init ) {
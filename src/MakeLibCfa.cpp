@@ -86,6 +86,7 @@ namespace {
 		// replace zero_t/one_t in function type
 		ast::Pass< ZeroOneReplacer > replacer( finder.core.type );
 		mutDecl->type = mutDecl->type->accept( replacer );
+		mutDecl->clearMangleCache();
 
 		// skip functions already defined
 		if ( mutDecl->has_body() ) return mutDecl;
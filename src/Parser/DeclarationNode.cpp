@@ -880,9 +880,9 @@ void buildList( DeclarationNode * firstNode, std::vector<ast::ptr<ast::DeclWithT
 } // buildList
 
 void buildTypeList( const DeclarationNode * firstNode,
-		std::vector<ast::ptr<ast::Type>> & outputList ) {
+		ast::vector<ast::Type> & outputList ) {
 	SemanticErrorException errors;
-	std::back_insert_iterator<std::vector<ast::ptr<ast::Type>>> out( outputList );
+	std::back_insert_iterator<ast::vector<ast::Type>> out( outputList );
 
 	for ( const DeclarationNode * cur = firstNode ; cur ; cur = cur->next ) {
 		try {
@@ -1022,7 +1022,7 @@ ast::Type * DeclarationNode::buildType() const {
 	default:
 		ast::Type * simpletypes = typebuild( type );
 		// copy because member is const
-		simpletypes->attributes = attributes;
+		simpletypes->attributes.assign( attributes.begin(), attributes.end() );
 		return simpletypes;
 	} // switch
 }
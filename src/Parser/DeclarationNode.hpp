@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include "AST/Vector.hpp"
 #include "ParseNode.hpp"
 
 struct TypeData;
@@ -160,7 +161,7 @@ void buildList( NodeType * firstNode,
 
 void buildList( DeclarationNode * firstNode, std::vector<ast::ptr<ast::Decl>> & outputList );
 void buildList( DeclarationNode * firstNode, std::vector<ast::ptr<ast::DeclWithType>> & outputList );
-void buildTypeList( const DeclarationNode * firstNode, std::vector<ast::ptr<ast::Type>> & outputList );
+void buildTypeList( const DeclarationNode * firstNode, ast::vector<ast::Type> & outputList );
 
 template<typename AstType, typename NodeType,
 		template<typename, typename...> class Container, typename... Args>
@@ -25,6 +25,9 @@ ast::Linkage::Spec linkage = ast::Linkage::Cforall;
 TypedefTable typedefTable;
 DeclarationNode * parseTree = nullptr;
 
+// Declarations from prebuildUnit, waiting for the rest of the unit.
+static std::vector<ast::ptr<ast::Decl>> prebuiltDecls;
+
 void parse( FILE * input, ast::Linkage::Spec linkage, bool alwaysExit ) {
 	extern int yyparse( void );
 	extern FILE * yyin;
@@ -42,8 +45,15 @@ void parse( FILE * input, ast::Linkage::Spec linkage, bool alwaysExit ) {
 	} // if
 } // parse
 
+void prebuildUnit(void) {
+	buildList( parseTree, prebuiltDecls );
+	delete parseTree;
+	parseTree = nullptr;
+}
+
 ast::TranslationUnit buildUnit(void) {
 	std::vector<ast::ptr<ast::Decl>> decls;
+	decls.swap( prebuiltDecls );
 	buildList( parseTree, decls );
 	delete parseTree;
 	parseTree = nullptr;
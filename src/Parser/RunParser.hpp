@@ -30,6 +30,10 @@ namespace ast {
 /// error or if alwaysExit is true.
 void parse( FILE * input, ast::Linkage::Spec linkage, bool alwaysExit = false );
 
+/// Build the code parsed so far ahead of time, draining the accumulator.
+/// The declarations are kept and put first in the next translation unit.
+void prebuildUnit(void);
+
 /// Drain the internal accumulator of parsed code and build a translation
 /// unit from it.
 ast::TranslationUnit buildUnit(void);
@@ -706,9 +706,9 @@ TypeData * makeNewBase( TypeData * type ) {
 
 void buildForall(
 		const DeclarationNode * firstNode,
-		std::vector<ast::ptr<ast::TypeInstType>> &outputList ) {
+		ast::vector<ast::TypeInstType> &outputList ) {
 	{
-		std::vector<ast::ptr<ast::Type>> tmpList;
+		ast::vector<ast::Type> tmpList;
 		buildTypeList( firstNode, tmpList );
 		for ( auto tmp : tmpList ) {
 			outputList.emplace_back(
@@ -1518,7 +1518,7 @@ ast::TypeInstType * buildSymbolicInst( const TypeData * td ) {
 
 ast::TupleType * buildTuple( const TypeData * td ) {
 	assert( td->kind == TypeData::Tuple );
-	std::vector<ast::ptr<ast::Type>> types;
+	ast::vector<ast::Type> types;
 	buildTypeList( td->tuple, types );
 	ast::TupleType * ret = new ast::TupleType(
 		std::move( types ),
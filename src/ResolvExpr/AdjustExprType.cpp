@@ -61,7 +61,7 @@ public:
 				return new ast::PointerType( inst );
 			}
 		} else if ( const ast::NamedTypeDecl * ntDecl = symtab.lookupType( inst->name ) ) {
-			if ( auto tyDecl = dynamic_cast< const ast::TypeDecl * >( ntDecl ) ) {
+			if ( auto tyDecl = ast::dyn_cast< ast::TypeDecl >( ntDecl ) ) {
 				if ( tyDecl->kind == ast::TypeDecl::Ftype ) {
 					return new ast::PointerType( inst );
 				}
@@ -16,12 +16,54 @@
 #include "Candidate.hpp"
 
 #include <iostream>
+#include <new>                          // for operator new, operator delete
 #include <sstream>
 
 #include "AST/Print.hpp"
+#include "Common/BlockPool.hpp"         // for BlockPool
+#include "Common/Stats/Counter.hpp"     // for SimpleCounter
 
 namespace ResolvExpr {
 
+namespace CandidateStorage {
+
+namespace {
+	auto stats() {
+		using namespace Stats::Counters;
+		static auto group = build<CounterGroup>("Candidate Storage");
+		static struct {
+			SimpleCounter * fresh;
+			SimpleCounter * reused;
+		} ret = {
+			.fresh  = build<SimpleCounter>("New Blocks", group),
+			.reused = build<SimpleCounter>("Reused Blocks", group),
+		};
+		return ret;
+	}
+
+	thread_local BlockPool pool;
+} // namespace
+
+void * allocate( std::size_t size ) {
+	if ( ! BlockPool::fits( size ) ) return ::operator new( size );
+	if ( void * block = pool.reuse( size ) ) {
+		++*stats().reused;
+		return block;
+	}
+	++*stats().fresh;
+	return pool.carve( size );
+}
+
+void release( void * block, std::size_t size ) {
+	if ( ! BlockPool::fits( size ) ) {
+		::operator delete( block );
+		return;
+	}
+	pool.release( block, size );
+}
+
+} // namespace CandidateStorage
+
 void print( std::ostream & os, const Candidate & cand, Indenter indent ) {
 	os << "Cost " << cand.cost << ": ";
 	if ( cand.expr ) {
@@ -16,7 +16,9 @@
 #pragma once
 
 #include <iosfwd>
-#include <memory>        // for shared_ptr
+#include <cstddef>       // for size_t
+#include <memory>        // for shared_ptr, allocate_shared
+#include <utility>       // for forward
 #include <vector>
 
 #include "Cost.hpp"
@@ -79,6 +81,40 @@ struct Candidate {
 /// Shared reference to a candidate
 using CandidateRef = std::shared_ptr< Candidate >;
 
+/// Storage for candidates and their reference counts. Nearly all candidates are discarded
+/// soon after they are made, so their storage is recycled for the next ones.
+namespace CandidateStorage {
+	void * allocate( std::size_t size );
+	void release( void * block, std::size_t size );
+}
+
+/// Allocator for CandidateStorage
+template< typename T >
+struct CandidateAllocator {
+	using value_type = T;
+
+	CandidateAllocator() = default;
+	template< typename U >
+	CandidateAllocator( const CandidateAllocator< U > & ) {}
+
+	T * allocate( std::size_t n ) {
+		return static_cast< T * >( CandidateStorage::allocate( n * sizeof(T) ) );
+	}
+	void deallocate( T * p, std::size_t n ) { CandidateStorage::release( p, n * sizeof(T) ); }
+
+	template< typename U >
+	bool operator==( const CandidateAllocator< U > & ) const { return true; }
+	template< typename U >
+	bool operator!=( const CandidateAllocator< U > & ) const { return false; }
+};
+
+/// Makes a candidate with the reference count in the same block of recycled storage
+template< typename... Args >
+CandidateRef makeCandidate( Args &&... args ) {
+	return std::allocate_shared< Candidate >(
+		CandidateAllocator< Candidate >(), std::forward< Args >( args )... );
+}
+
 /// List of candidates
 using CandidateList = std::vector< CandidateRef >;
 
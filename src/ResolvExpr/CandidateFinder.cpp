@@ -15,6 +15,7 @@
 
 #include "CandidateFinder.hpp"
 
+#include <algorithm>                // for sort, stable_sort
 #include <deque>
 #include <iterator>                 // for back_inserter
 #include <sstream>
@@ -117,9 +118,22 @@ namespace {
 		return arg;
 	}
 
-	/// Computes conversion cost for a given candidate
+	/// Is any cost that adds conversion costs to `cost` greater than `bound`? Conversions only
+	/// increase the fields above the specialization cost, so only those are compared.
+	bool alwaysExceeds( const Cost & cost, const Cost & bound ) {
+		if ( bound == Cost::infinity ) return false;
+		if ( cost == Cost::infinity ) return true;
+		auto upper = []( const Cost & c ) {
+			return Cost( c.get_unsafeCost(), c.get_polyCost(), c.get_safeCost(), c.get_signCost(),
+				c.get_implictCost(), c.get_varCost(), 0, 0 );
+		};
+		return upper( bound ) < upper( cost );
+	}
+
+	/// Computes conversion cost for a given candidate, giving up with infinity once the
+	/// candidate's total cost is known to be greater than the bound
 	Cost computeApplicationConversionCost(
-		CandidateRef cand, const ast::SymbolTable & symtab
+		CandidateRef cand, const ast::SymbolTable & symtab, const Cost & bound = Cost::infinity
 	) {
 		auto appExpr = cand->expr.strict_as< ast::ApplicationExpr >();
 		auto pointer = appExpr->func->result.strict_as< ast::PointerType >();
@@ -169,6 +183,7 @@ namespace {
 					args[i], *param, symtab, cand->env, convCost ) );
 			convCost.decSpec( specCost( *param ) );
 			++param;  // can't be in for-loop update because of the continue
+			if ( alwaysExceeds( cand->cost + convCost, bound ) ) return Cost::infinity;
 		}
 
 		if ( param != params.end() ) return Cost::infinity;
@@ -202,7 +217,7 @@ namespace {
 
 	/// Gets a default value from an initializer, nullptr if not present
 	const ast::ConstantExpr * getDefaultValue( const ast::Init * init ) {
-		if ( auto si = dynamic_cast< const ast::SingleInit * >( init ) ) {
+		if ( auto si = ast::dyn_cast< ast::SingleInit >( init ) ) {
 			if ( auto ce = si->value.as< ast::CastExpr >() ) {
 				return ce->arg.as< ast::ConstantExpr >();
 			} else {
@@ -286,7 +301,7 @@ namespace {
 		std::vector< ArgPack > & results, std::size_t & genStart, const ResolveContext & context,
 		unsigned nTuples = 0
 	) {
-		if ( auto tupleType = dynamic_cast< const ast::TupleType * >( paramType ) ) {
+		if ( auto tupleType = ast::dyn_cast< ast::TupleType >( paramType ) ) {
 			// paramType is a TupleType -- group args into a TupleExpr
 			++nTuples;
 			for ( const ast::Type * type : *tupleType ) {
@@ -513,8 +528,8 @@ namespace {
 					// add new result
 					assert( common );
 
-					auto paramAsEnum = dynamic_cast<const ast::EnumInstType *>(paramType);
-					auto argAsEnum =dynamic_cast<const ast::EnumInstType *>(argType);
+					auto paramAsEnum = ast::dyn_cast<ast::EnumInstType>(paramType);
+					auto argAsEnum =ast::dyn_cast<ast::EnumInstType>(argType);
 					if (paramAsEnum && argAsEnum) {
 						if (paramAsEnum->base->name != argAsEnum->base->name) {
 							Cost c = castCost(argType, paramType, expr, context.symtab, env);
@@ -551,7 +566,7 @@ namespace {
 		if (
 			arg->result->size() > 1
 			&& ! toType->isVoid()
-			&& ! dynamic_cast< const ast::ReferenceType * >( toType )
+			&& ! ast::dyn_cast< ast::ReferenceType >( toType )
 		) {
 			// Argument is a tuple and the target type is neither void nor a reference. Cast each
 			// member of the tuple to its corresponding target type, producing the tuple of those
@@ -620,7 +635,7 @@ namespace {
 		/// Convenience to add candidate to list
 		template<typename... Args>
 		void addCandidate( Args &&... args ) {
-			candidates.emplace_back( new Candidate{ std::forward<Args>( args )... } );
+			candidates.emplace_back( makeCandidate( std::forward<Args>( args )... ) );
 			reason.code = NoReason;
 		}
 
@@ -752,7 +767,7 @@ namespace {
 		appExpr->args = std::move( vargs );
 		// build and validate new candidate
 		auto newCand =
-			std::make_shared<Candidate>( appExpr, result.env, result.open, result.need, cost );
+			makeCandidate( appExpr, result.env, result.open, result.need, cost );
 		PRINT(
 			std::cerr << "instantiate function success: " << appExpr << std::endl;
 			std::cerr << "need assertions:" << std::endl;
@@ -949,7 +964,7 @@ namespace {
 	) {
 		for ( const ast::Decl * decl : aggrInst->lookup( name ) ) {
 			auto dwt = strict_dynamic_cast< const ast::DeclWithType * >( decl );
-			CandidateRef newCand = std::make_shared<Candidate>(
+			CandidateRef newCand = makeCandidate(
 				cand, new ast::MemberExpr{ expr->location, dwt, expr }, addedCost );
 			// add anonymous member interpretations whenever an aggregate value type is seen
 			// as a member expression
@@ -963,7 +978,7 @@ namespace {
 		const ast::TupleType * tupleType, const ast::Expr * expr, const Candidate & cand,
 		const Cost & addedCost, const ast::Expr * member
 	) {
-		if ( auto constantExpr = dynamic_cast< const ast::ConstantExpr * >( member ) ) {
+		if ( auto constantExpr = ast::dyn_cast< ast::ConstantExpr >( member ) ) {
 			// get the value of the constant expression as an int, must be between 0 and the
 			// length of the tuple to have meaning
 			long long val = constantExpr->intValue();
@@ -1060,21 +1075,21 @@ namespace {
 
 				// check if the type is a pointer to function
 				const ast::Type * funcResult = func->expr->result->stripReferences();
-				if ( auto pointer = dynamic_cast< const ast::PointerType * >( funcResult ) ) {
+				if ( auto pointer = ast::dyn_cast< ast::PointerType >( funcResult ) ) {
 					if ( auto function = pointer->base.as< ast::FunctionType >() ) {
 						// if (!selfFinder.allowVoid && function->returns.empty()) continue;
-						CandidateRef newFunc{ new Candidate{ *func } };
+						CandidateRef newFunc = makeCandidate( *func );
 						newFunc->expr =
 							referenceToRvalueConversion( newFunc->expr, newFunc->cost );
 						makeFunctionCandidates( untypedExpr->location,
 							newFunc, function, argExpansions, found );
 					}
 				} else if (
-					auto inst = dynamic_cast< const ast::TypeInstType * >( funcResult )
+					auto inst = ast::dyn_cast< ast::TypeInstType >( funcResult )
 				) {
 					if ( const ast::EqvClass * clz = func->env.lookup( *inst ) ) {
 						if ( auto function = clz->bound.as< ast::FunctionType >() ) {
-							CandidateRef newFunc( new Candidate( *func ) );
+							CandidateRef newFunc = makeCandidate( *func );
 							newFunc->expr =
 								referenceToRvalueConversion( newFunc->expr, newFunc->cost );
 							makeFunctionCandidates( untypedExpr->location,
@@ -1099,9 +1114,9 @@ namespace {
 				try {
 					// check if type is pointer-to-function
 					const ast::Type * opResult = op->expr->result->stripReferences();
-					if ( auto pointer = dynamic_cast< const ast::PointerType * >( opResult ) ) {
+					if ( auto pointer = ast::dyn_cast< ast::PointerType >( opResult ) ) {
 						if ( auto function = pointer->base.as< ast::FunctionType >() ) {
-							CandidateRef newOp{ new Candidate{ *op} };
+							CandidateRef newOp = makeCandidate( *op );
 							newOp->expr =
 								referenceToRvalueConversion( newOp->expr, newOp->cost );
 							makeFunctionCandidates( untypedExpr->location,
@@ -1121,9 +1136,12 @@ namespace {
 		Cost intrinsicCost = Cost::infinity;
 		CandidateList intrinsicResult;
 
-		// Compute conversion costs
-		for ( CandidateRef & withFunc : found ) {
-			Cost cvtCost = computeApplicationConversionCost( withFunc, symtab );
+		auto isIntrinsic = []( const CandidateRef & cand ) {
+			auto func = cand->expr.strict_as<ast::ApplicationExpr>()->func.as<ast::VariableExpr>();
+			return func && func->var->linkage == ast::Linkage::Intrinsic;
+		};
+		auto addConversionCost = [&]( CandidateRef & withFunc, const Cost & bound ) {
+			Cost cvtCost = computeApplicationConversionCost( withFunc, symtab, bound );
 
 			if (funcName == "?|?") {
 			PRINT(
@@ -1142,22 +1160,46 @@ namespace {
 				std::cerr << "cost of conversion is:" << cvtCost << std::endl;
 			)
 			}
-			if ( cvtCost != Cost::infinity ) {
-				withFunc->cvtCost = cvtCost;
-				withFunc->cost += cvtCost;
-				auto func = withFunc->expr.strict_as<ast::ApplicationExpr>()->func.as<ast::VariableExpr>();
-				if (func && func->var->linkage == ast::Linkage::Intrinsic) {
-					if (withFunc->cost < intrinsicCost) {
-						intrinsicResult.clear();
-						intrinsicCost = withFunc->cost;
-					}
-					if (withFunc->cost == intrinsicCost) {
-						intrinsicResult.emplace_back(std::move(withFunc));
-					}
-				} else {
-					candidates.emplace_back( std::move( withFunc ) );
-				}
+			if ( cvtCost == Cost::infinity ) return false;
+			withFunc->cvtCost = cvtCost;
+			withFunc->cost += cvtCost;
+			return true;
+		};
+
+		// Compute conversion costs
+		std::vector< std::size_t > intrinsicFound;
+		for ( std::size_t i = 0; i < found.size(); ++i ) {
+			CandidateRef & withFunc = found[i];
+			if ( isIntrinsic( withFunc ) ) {
+				intrinsicFound.emplace_back( i );
+			} else if ( addConversionCost( withFunc, Cost::infinity ) ) {
+				candidates.emplace_back( std::move( withFunc ) );
+			}
+		}
+
+		// Only the cheapest intrinsic candidates are kept, so cost them cheapest first and give
+		// up on each once it is known to cost more than the best so far. The kept candidates are
+		// put back in their original order.
+		std::stable_sort( intrinsicFound.begin(), intrinsicFound.end(),
+			[&found]( std::size_t lhs, std::size_t rhs ) {
+				return found[lhs]->cost < found[rhs]->cost;
+			} );
+		std::vector< std::size_t > intrinsicBest;
+		for ( std::size_t i : intrinsicFound ) {
+			CandidateRef & withFunc = found[i];
+			if ( alwaysExceeds( withFunc->cost, intrinsicCost ) ) break;
+			if ( ! addConversionCost( withFunc, intrinsicCost ) ) continue;
+			if (withFunc->cost < intrinsicCost) {
+				intrinsicBest.clear();
+				intrinsicCost = withFunc->cost;
 			}
+			if (withFunc->cost == intrinsicCost) {
+				intrinsicBest.emplace_back( i );
+			}
+		}
+		std::sort( intrinsicBest.begin(), intrinsicBest.end() );
+		for ( std::size_t i : intrinsicBest ) {
+			intrinsicResult.emplace_back( std::move( found[i] ) );
 		}
 		spliceBegin( candidates, intrinsicResult );
 		found = std::move( candidates );
@@ -1307,7 +1349,7 @@ namespace {
 					matches.clear();
 				}
 				if (cand->cost == minExprCost) {
-					CandidateRef newCand = std::make_shared<Candidate>(
+					CandidateRef newCand = makeCandidate(
 						restructureCast( cand->expr, toType, castExpr->isGenerated ),
 						copy( cand->env ), std::move( open ), std::move( need ), cand->cost);
 					// currently assertions are always resolved immediately so this should have no effect.
@@ -1350,18 +1392,18 @@ namespace {
 			for (auto & cand : found) {
 				const ast::Type * expr = cand->expr->result.get();
 				if (expect_ref) {
-					auto res = dynamic_cast<const ast::ReferenceType*>(expr);
+					auto res = ast::dyn_cast<ast::ReferenceType>(expr);
 					if (!res) { continue; }
 					expr = res->base.get();
 				}
 
-				if (auto insttype = dynamic_cast<const ast::TypeInstType*>(expr)) {
+				if (auto insttype = ast::dyn_cast<ast::TypeInstType>(expr)) {
 					auto td = cand->env.lookup(*insttype);
 					if (!td) { continue; }
 					expr = td->bound.get();
 				}
 
-				if (auto base = dynamic_cast<const ast::StructInstType*>(expr)) {
+				if (auto base = ast::dyn_cast<ast::StructInstType>(expr)) {
 					if (base->base == target) {
 						candidates.push_back( std::move(cand) );
 						reason.code = NoReason;
@@ -1419,61 +1461,58 @@ namespace {
 	}
 
 	void Finder::postvisit( const ast::NameExpr * nameExpr ) {
-		std::vector< ast::SymbolTable::IdData > declList;
+		std::vector< ast::SymbolTable::IdView > views;
 		if (!selfFinder.otypeKeys.empty()) {
 			auto kind = ast::SymbolTable::getSpecialFunctionKind(nameExpr->name);
 			assertf(kind != ast::SymbolTable::SpecialFunctionKind::NUMBER_OF_KINDS, "special lookup with non-special target: %s", nameExpr->name.c_str());
 
 			for (auto & otypeKey: selfFinder.otypeKeys) {
-				auto result = symtab.specialLookupId(kind, otypeKey);
-				declList.insert(declList.end(), std::make_move_iterator(result.begin()), std::make_move_iterator(result.end()));
+				views.push_back( symtab.specialLookupIdView(kind, otypeKey) );
 			}
 		} else {
-			declList = symtab.lookupIdIgnoreHidden( nameExpr->name );
+			views.push_back( symtab.lookupIdView( nameExpr->name ).withoutHidden() );
 		}
 		PRINT( std::cerr << "nameExpr is " << nameExpr->name << std::endl; )
 
-		if ( declList.empty() ) return;
-
-		reason.code = NoMatch;
+		for ( const ast::SymbolTable::IdView & view : views ) {
+			for ( const ast::SymbolTable::IdData & data : view ) {
+				reason.code = NoMatch;
+				Cost cost = Cost::zero;
+				ast::Expr * newExpr = data.combine( nameExpr->location, cost );
+
+				CandidateRef newCand = makeCandidate(
+					newExpr, copy( tenv ), ast::OpenVarSet{}, ast::AssertionSet{}, Cost::zero,
+					cost );
+				if (newCand->expr->env) {
+					newCand->env.add(*newCand->expr->env);
+					auto mutExpr = newCand->expr.get_and_mutate();
+					mutExpr->env  = nullptr;
+					newCand->expr = mutExpr;
+				}
 
-		for ( auto & data : declList ) {
-			Cost cost = Cost::zero;
-			ast::Expr * newExpr = data.combine( nameExpr->location, cost );
-
-			CandidateRef newCand = std::make_shared<Candidate>(
-				newExpr, copy( tenv ), ast::OpenVarSet{}, ast::AssertionSet{}, Cost::zero,
-				cost );
-			if (newCand->expr->env) {
-				newCand->env.add(*newCand->expr->env);
-				auto mutExpr = newCand->expr.get_and_mutate();
-				mutExpr->env  = nullptr;
-				newCand->expr = mutExpr;
+				PRINT(
+					std::cerr << "decl is ";
+					ast::print( std::cerr, data.id );
+					std::cerr << std::endl;
+					std::cerr << "newExpr is ";
+					ast::print( std::cerr, newExpr );
+					std::cerr << std::endl;
+				)
+				newCand->expr = ast::mutate_field(
+					newCand->expr.get(), &ast::Expr::result,
+					renameTyVars( newCand->expr->result ) );
+				// add anonymous member interpretations whenever an aggregate value type is seen
+				// as a name expression
+				addAnonConversions( newCand );
+				candidates.emplace_back( std::move( newCand ) );
 			}
-
-			PRINT(
-				std::cerr << "decl is ";
-				ast::print( std::cerr, data.id );
-				std::cerr << std::endl;
-				std::cerr << "newExpr is ";
-				ast::print( std::cerr, newExpr );
-				std::cerr << std::endl;
-			)
-			newCand->expr = ast::mutate_field(
-				newCand->expr.get(), &ast::Expr::result,
-				renameTyVars( newCand->expr->result ) );
-			// add anonymous member interpretations whenever an aggregate value type is seen
-			// as a name expression
-			addAnonConversions( newCand );
-			candidates.emplace_back( std::move( newCand ) );
 		}
 	}
 
 	void Finder::postvisit(const ast::VariableExpr *variableExpr) {
 		// not sufficient to just pass `variableExpr` here, type might have changed
 
-		auto cand = new Candidate(variableExpr, tenv);
-		candidates.emplace_back(cand);
+		candidates.emplace_back( makeCandidate( variableExpr, tenv ) );
 	}
 
 	void Finder::postvisit( const ast::ConstantExpr * constantExpr ) {
@@ -1635,7 +1674,7 @@ namespace {
 						newExpr->arg3 = computeExpressionConversionCost(
 							newExpr->arg3, newExpr->result, symtab, env, cost );
 						// output candidate
-						CandidateRef newCand = std::make_shared<Candidate>(
+						CandidateRef newCand = makeCandidate(
 							newExpr, std::move( env ), std::move( open ), std::move( need ), cost );
 						inferParameters( newCand, candidates );
 					}
@@ -1703,7 +1742,7 @@ namespace {
 						new ast::RangeExpr{ rangeExpr->location, r1->expr, r2->expr };
 					newExpr->result = common ? common : r1->expr->result;
 					// add candidate
-					CandidateRef newCand = std::make_shared<Candidate>(
+					CandidateRef newCand = makeCandidate(
 						newExpr, std::move( env ), std::move( open ), std::move( need ),
 						r1->cost + r2->cost );
 					inferParameters( newCand, candidates );
@@ -1825,7 +1864,7 @@ namespace {
 						minCastCost = thisCost;
 						matches.clear();
 					}
-					CandidateRef newCand = std::make_shared<Candidate>(
+					CandidateRef newCand = makeCandidate(
 						new ast::InitExpr{
 							initExpr->location,
 							restructureCast( cand->expr, toType ),
@@ -1853,13 +1892,13 @@ namespace {
 		for ( ast::SymbolTable::IdData & data: declList ) {
 			const ast::Type * t = data.id->get_type()->stripReferences();
 			if ( const ast::EnumInstType * enumInstType =
-				dynamic_cast<const ast::EnumInstType *>( t ) ) {
+				ast::dyn_cast<ast::EnumInstType>( t ) ) {
 				if ( (enumInstType->base->name == expr->type_name)
 					|| (expr->type_decl && enumInstType->base->name == expr->type_decl->name) ) {
 					Cost cost = Cost::zero;
 					ast::Expr * newExpr = data.combine( expr->location, cost );
 					CandidateRef newCand =
-						std::make_shared<Candidate>(
+						makeCandidate(
 							newExpr, copy( tenv ), ast::OpenVarSet{},
 							ast::AssertionSet{}, Cost::zero, cost
 						);
@@ -2046,7 +2085,7 @@ void CandidateFinder::find( const ast::Expr * expr, ResolveMode mode ) {
 	*/
 
 	// optimization: don't prune for NameExpr since it never has cost
-	if ( mode.prune && !dynamic_cast<const ast::NameExpr *>(expr) ) {
+	if ( mode.prune && !ast::dyn_cast<ast::NameExpr>(expr) ) {
 		// trim candidates to single best one
 		PRINT(
 			std::cerr << "alternatives before prune:" << std::endl;
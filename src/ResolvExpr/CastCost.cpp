@@ -64,14 +64,14 @@ namespace {
 		}
 
 		void postvisit( const ast::BasicType * basicType ) {
-			auto ptr = dynamic_cast< const ast::PointerType * >( dst );
+			auto ptr = ast::dyn_cast< ast::PointerType >( dst );
 			if ( ptr && basicType->isInteger() ) {
 				// needed for, e.g. unsigned long => void *
 				cost = Cost::unsafe;
 			} else {
 				cost = conversionCost( basicType, dst, srcIsLvalue, symtab, env );
 				if ( Cost::unsafe < cost ) {
-					if ( dynamic_cast<const ast::EnumInstType *>(dst)) {
+					if ( ast::dyn_cast<ast::EnumInstType>(dst)) {
 						cost = Cost::unsafe;
 					}
 				}
@@ -81,7 +81,7 @@ namespace {
 		void postvisit( const ast::ZeroType * zero ) {
 			cost = conversionCost( zero, dst, srcIsLvalue, symtab, env );
 			if ( Cost::unsafe < cost ) {
-				if ( dynamic_cast<const ast::EnumInstType *>(dst)) {
+				if ( ast::dyn_cast<ast::EnumInstType>(dst)) {
 					cost = Cost::unsafe;
 				}
 			}
@@ -90,14 +90,14 @@ namespace {
 		void postvisit( const ast::OneType * one ) {
 			cost = conversionCost( one, dst, srcIsLvalue, symtab, env );
 			if ( Cost::unsafe < cost ) {
-				if ( dynamic_cast<const ast::EnumInstType *>(dst)) {
+				if ( ast::dyn_cast<ast::EnumInstType>(dst)) {
 					cost = Cost::unsafe;
 				}
 			}
 		}
 
 		void postvisit( const ast::PointerType * pointerType ) {
-			if ( auto ptr = dynamic_cast< const ast::PointerType * >( dst ) ) {
+			if ( auto ptr = ast::dyn_cast< ast::PointerType >( dst ) ) {
 				if (
 					pointerType->qualifiers <= ptr->qualifiers
 					&& typesCompatibleIgnoreQualifiers( pointerType->base, ptr->base, env )
@@ -115,7 +115,7 @@ namespace {
 						cost = Cost::infinity;
 					}
 				}
-			} else if ( auto basic = dynamic_cast< const ast::BasicType * >( dst ) ) {
+			} else if ( auto basic = ast::dyn_cast< ast::BasicType >( dst ) ) {
 				if ( basic->isInteger() ) {
 					// necessary for, e.g. void * => unsigned long
 					cost = Cost::unsafe;
@@ -124,13 +124,27 @@ namespace {
 		}
 	};
 
+	Cost uncachedCastCost(
+		const ast::Type * src, const ast::Type * dst, bool srcIsLvalue,
+		const ast::SymbolTable & symtab, const ast::TypeEnvironment & env );
+
 } // anonymous namespace
 
 Cost castCost(
 	const ast::Type * src, const ast::Type * dst, bool srcIsLvalue,
 	const ast::SymbolTable & symtab, const ast::TypeEnvironment & env
 ) {
-	if ( auto typeInst = dynamic_cast< const ast::TypeInstType * >( dst ) ) {
+	static CostCache cache( "Cast Cost Cache", uncachedCastCost );
+	return cache( src, dst, srcIsLvalue, symtab, env );
+}
+
+namespace {
+
+Cost uncachedCastCost(
+	const ast::Type * src, const ast::Type * dst, bool srcIsLvalue,
+	const ast::SymbolTable & symtab, const ast::TypeEnvironment & env
+) {
+	if ( auto typeInst = ast::dyn_cast< ast::TypeInstType >( dst ) ) {
 		if ( const ast::EqvClass * eqvClass = env.lookup( *typeInst ) ) {
 			// check cast cost against bound type, if present
 			if ( eqvClass->bound ) {
@@ -158,13 +172,13 @@ Cost castCost(
 
 	if ( typesCompatibleIgnoreQualifiers( src, dst, env ) ) {
 		PRINT( std::cerr << "compatible!" << std::endl; )
-		if (dynamic_cast<const ast::ZeroType *>(dst) || dynamic_cast<const ast::OneType *>(dst)) {
+		if (ast::dyn_cast<ast::ZeroType>(dst) || ast::dyn_cast<ast::OneType>(dst)) {
 			return Cost::spec;
 		}
 		return Cost::zero;
-	} else if ( dynamic_cast< const ast::VoidType * >( dst ) ) {
+	} else if ( ast::dyn_cast< ast::VoidType >( dst ) ) {
 		return Cost::safe;
-	} else if ( auto refType = dynamic_cast< const ast::ReferenceType * >( dst ) ) {
+	} else if ( auto refType = ast::dyn_cast< ast::ReferenceType >( dst ) ) {
 		PRINT( std::cerr << "conversionCost: dest is reference" << std::endl; )
 		return convertToReferenceCost(
 			src, refType, srcIsLvalue, symtab, env, ptrsCastable );
@@ -176,6 +190,8 @@ Cost castCost(
 	}
 }
 
+} // anonymous namespace
+
 } // namespace ResolvExpr
 
 // Local Variables: //
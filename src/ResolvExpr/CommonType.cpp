@@ -365,7 +365,7 @@ public:
 	void postvisit( const ast::VoidType * ) {}
 
 	void postvisit( const ast::BasicType * basic ) {
-		if ( auto basic2 = dynamic_cast< const ast::BasicType * >( type2 ) ) {
+		if ( auto basic2 = ast::dyn_cast< ast::BasicType >( type2 ) ) {
 			ast::BasicKind kind;
 			if (basic->kind != basic2->kind && !widen.first && !widen.second) return;
 			else if (!widen.first) kind = basic->kind; // widen.second
@@ -377,13 +377,13 @@ public:
 				result = new ast::BasicType{ kind, basic->qualifiers | basic2->qualifiers };
 			}
 		} else if (
-			dynamic_cast< const ast::ZeroType * >( type2 )
-			|| dynamic_cast< const ast::OneType * >( type2 )
+			ast::dyn_cast< ast::ZeroType >( type2 )
+			|| ast::dyn_cast< ast::OneType >( type2 )
 		) {
 			if (widen.second) {
 				result = new ast::BasicType{ basic->kind, basic->qualifiers | type2->qualifiers };
 			}
-		} else if ( const ast::EnumInstType * enumInst = dynamic_cast< const ast::EnumInstType * >( type2 ) ) {
+		} else if ( const ast::EnumInstType * enumInst = ast::dyn_cast< ast::EnumInstType >( type2 ) ) {
 			const ast::EnumDecl* enumDecl = enumInst->base;
 			if ( !enumDecl->isCfa  ) {
 				ast::BasicKind kind = commonTypes[ basic->kind ][ ast::BasicKind::SignedInt ];
@@ -403,7 +403,7 @@ private:
 	template< typename Pointer >
 	void getCommonWithVoidPointer( const Pointer * voidPtr, const Pointer * oPtr ) {
 		const ast::Type * base = oPtr->base;
-		if ( auto var = dynamic_cast< const ast::TypeInstType * >( base ) ) {
+		if ( auto var = ast::dyn_cast< ast::TypeInstType >( base ) ) {
 			auto entry = open.find( *var );
 			if ( entry != open.end() ) {
 				ast::AssertionSet need, have;
@@ -418,7 +418,7 @@ private:
 
 public:
 	void postvisit( const ast::PointerType * pointer ) {
-		if ( auto pointer2 = dynamic_cast< const ast::PointerType * >( type2 ) ) {
+		if ( auto pointer2 = ast::dyn_cast< ast::PointerType >( type2 ) ) {
 			if (
 				widen.first
 				&& pointer2->base.as< ast::VoidType >()
@@ -500,8 +500,8 @@ public:
 						}
 
 						// allow qualifiers of pointer and reference base to become more specific
-						if (auto ref1 = dynamic_cast<const ast::ReferenceType *> (arg1)) {
-							if (auto ref2 = dynamic_cast<const ast::ReferenceType *> (arg2)) {
+						if (auto ref1 = ast::dyn_cast<ast::ReferenceType> (arg1)) {
+							if (auto ref2 = ast::dyn_cast<ast::ReferenceType> (arg2)) {
 								ast::ptr<ast::Type> base1 = ref1->base;
 								ast::ptr<ast::Type> base2 = ref2->base;
 
@@ -520,8 +520,8 @@ public:
 									) return;
 								}
 							} else return;
-						} else if (auto ptr1 = dynamic_cast<const ast::PointerType *> (arg1)) {
-							if (auto ptr2 = dynamic_cast<const ast::PointerType *> (arg2)) {
+						} else if (auto ptr1 = ast::dyn_cast<ast::PointerType> (arg1)) {
+							if (auto ptr2 = ast::dyn_cast<ast::PointerType> (arg2)) {
 								ast::ptr<ast::Type> base1 = ptr1->base;
 								ast::ptr<ast::Type> base2 = ptr2->base;
 
@@ -579,7 +579,7 @@ public:
 					}
 				} // if ftype
 			}
-		} else if ( widen.second && dynamic_cast< const ast::ZeroType * >( type2 ) ) {
+		} else if ( widen.second && ast::dyn_cast< ast::ZeroType >( type2 ) ) {
 			result = pointer;
 			add_qualifiers( result, type2->qualifiers );
 		}
@@ -588,7 +588,7 @@ public:
 	void postvisit( const ast::ArrayType * ) {}
 
 	void postvisit( const ast::ReferenceType * ref ) {
-		if ( auto ref2 = dynamic_cast< const ast::ReferenceType * >( type2 ) ) {
+		if ( auto ref2 = ast::dyn_cast< ast::ReferenceType >( type2 ) ) {
 			if (
 				widen.first && ref2->base.as< ast::VoidType >() && ! ast::isFtype( ref->base )
 			) {
@@ -620,11 +620,11 @@ public:
 					}
 				}
 			}
-		} else if ( widen.second && dynamic_cast< const ast::ZeroType * >( type2 ) ) {
+		} else if ( widen.second && ast::dyn_cast< ast::ZeroType >( type2 ) ) {
 			result = ref;
 			add_qualifiers( result, type2->qualifiers );
 		} else {
-			if (!dynamic_cast<const ast::EnumInstType *>(type2))
+			if (!ast::dyn_cast<ast::EnumInstType>(type2))
 				result = commonType( type2, ref, tenv, need, have, open, widen );
 		}
 	}
@@ -646,7 +646,7 @@ public:
 	}
 
 	void postvisit( const ast::EnumInstType * param ) {
-		auto argAsEnumInst = dynamic_cast<const ast::EnumInstType *>(type2);
+		auto argAsEnumInst = ast::dyn_cast<ast::EnumInstType>(type2);
 		if ( argAsEnumInst ) {
 			const ast::EnumDecl* paramDecl = param->base;
 			const ast::EnumDecl* argDecl = argAsEnumInst->base;
@@ -669,16 +669,16 @@ public:
 
 	void postvisit( const ast::ZeroType * zero ) {
 		if ( !widen.first ) return;
-		if ( dynamic_cast< const ast::BasicType * >( type2 )
-				|| dynamic_cast< const ast::PointerType * >( type2 ) ) {
+		if ( ast::dyn_cast< ast::BasicType >( type2 )
+				|| ast::dyn_cast< ast::PointerType >( type2 ) ) {
 			if ( widen.second || zero->qualifiers <= type2->qualifiers ) {
 				result = type2;
 				add_qualifiers( result, zero->qualifiers );
 			}
-		} else if ( widen.second && dynamic_cast< const ast::OneType * >( type2 ) ) {
+		} else if ( widen.second && ast::dyn_cast< ast::OneType >( type2 ) ) {
 			result = new ast::BasicType{
 				ast::BasicKind::SignedInt, zero->qualifiers | type2->qualifiers };
-		} else if ( const ast::EnumInstType * enumInst = dynamic_cast< const ast::EnumInstType * >( type2 ) ) {
+		} else if ( const ast::EnumInstType * enumInst = ast::dyn_cast< ast::EnumInstType >( type2 ) ) {
 			const ast::EnumDecl * enumDecl = enumInst->base;
 			if ( !enumDecl->base ) {
 				if ( widen.second || zero->qualifiers <= type2->qualifiers ) {
@@ -691,15 +691,15 @@ public:
 
 	void postvisit( const ast::OneType * one ) {
 		if ( !widen.first ) return;
-		if ( dynamic_cast< const ast::BasicType * >( type2 ) ) {
+		if ( ast::dyn_cast< ast::BasicType >( type2 ) ) {
 			if ( widen.second || one->qualifiers <= type2->qualifiers ) {
 				result = type2;
 				add_qualifiers( result, one->qualifiers );
 			}
-		} else if ( widen.second && dynamic_cast< const ast::ZeroType * >( type2 ) ) {
+		} else if ( widen.second && ast::dyn_cast< ast::ZeroType >( type2 ) ) {
 			result = new ast::BasicType{
 				ast::BasicKind::SignedInt, one->qualifiers | type2->qualifiers };
-		} else if ( const ast::EnumInstType * enumInst = dynamic_cast< const ast::EnumInstType * >( type2 ) ) {
+		} else if ( const ast::EnumInstType * enumInst = ast::dyn_cast< ast::EnumInstType >( type2 ) ) {
 			const ast::EnumDecl * enumDecl = enumInst->base;
 			if ( !enumDecl->base ) {
 				if ( widen.second || one->qualifiers <= type2->qualifiers ) {
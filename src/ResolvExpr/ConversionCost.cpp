@@ -15,10 +15,15 @@
 
 #include "ConversionCost.hpp"
 
+#include <algorithm>                     // for find
 #include <cassert>                       // for assert
+#include <functional>                    // for hash
 #include <list>                          // for list, list<>::const_iterator
 #include <string>                        // for operator==, string
+#include <unordered_map>                 // for unordered_multimap
+#include <vector>                        // for vector
 
+#include "AST/Copy.hpp"                  // for shallowCopy
 #include "ResolvExpr/Cost.hpp"           // for Cost
 #include "ResolvExpr/Unify.hpp"          // for typesCompatibleIgnoreQualifiers
 #include "ResolvExpr/PtrsAssignable.hpp" // for ptrsAssignable
@@ -157,13 +162,226 @@ namespace {
 			const ast::SymbolTable &, const ast::TypeEnvironment & env ) {
 		return ptrsAssignable( t1, t2, env );
 	}
+
+	std::vector<CostCache *> & allCostCaches() {
+		static std::vector<CostCache *> caches;
+		return caches;
+	}
+
+	using KeyParts = std::vector<const ast::Type *>;
+
+	/// Collect the types a key type is made of. Returns false if the type
+	/// cannot be a key, either because it is not closed or because it has
+	/// parts other than these types and the scalars compared by sameKeyNode.
+	bool keyParts( const ast::Type * type, KeyParts & out ) {
+		if ( ! type->attributes.empty() ) return false;
+		switch ( type->kind() ) {
+		case ast::NodeKind::BasicType:
+		case ast::NodeKind::VoidType:
+		case ast::NodeKind::ZeroType:
+		case ast::NodeKind::OneType:
+		case ast::NodeKind::VarArgsType:
+			return true;
+		case ast::NodeKind::PointerType: {
+			auto pointer = static_cast< const ast::PointerType * >( type );
+			if ( pointer->dimension ) return false;
+			out.push_back( pointer->base );
+			return true;
+		}
+		case ast::NodeKind::ReferenceType:
+			out.push_back( static_cast< const ast::ReferenceType * >( type )->base );
+			return true;
+		case ast::NodeKind::FunctionType: {
+			auto func = static_cast< const ast::FunctionType * >( type );
+			if ( ! func->forall.empty() || ! func->assertions.empty() ) return false;
+			for ( const ast::ptr<ast::Type> & ret : func->returns ) out.push_back( ret );
+			for ( const ast::ptr<ast::Type> & param : func->params ) out.push_back( param );
+			return true;
+		}
+		case ast::NodeKind::StructInstType:
+		case ast::NodeKind::UnionInstType:
+		case ast::NodeKind::EnumInstType:
+			for ( const ast::ptr<ast::Expr> & param : static_cast< const ast::BaseInstType * >( type )->params ) {
+				auto typeExpr = param.as<ast::TypeExpr>();
+				if ( ! typeExpr ) return false;
+				out.push_back( typeExpr->type );
+			}
+			return true;
+		default:
+			// Type variables and everything else.
+			return false;
+		}
+	}
+
+	const void * instBase( const ast::Type * type ) {
+		if ( auto inst = ast::dyn_cast< ast::StructInstType >( type ) ) return inst->base.get();
+		if ( auto inst = ast::dyn_cast< ast::UnionInstType >( type ) ) return inst->base.get();
+		if ( auto inst = ast::dyn_cast< ast::EnumInstType >( type ) ) return inst->base.get();
+		return nullptr;
+	}
+
+	/// Compare everything but the parts, which are compared by address.
+	bool sameKeyNode( const ast::Type * lhs, const ast::Type * rhs ) {
+		if ( lhs->kind() != rhs->kind() ) return false;
+		if ( lhs->qualifiers.val != rhs->qualifiers.val ) return false;
+		if ( auto basic = ast::dyn_cast< ast::BasicType >( lhs ) ) {
+			return basic->kind == static_cast< const ast::BasicType * >( rhs )->kind;
+		} else if ( auto pointer = ast::dyn_cast< ast::PointerType >( lhs ) ) {
+			auto other = static_cast< const ast::PointerType * >( rhs );
+			return pointer->isVarLen == other->isVarLen && pointer->isStatic == other->isStatic;
+		} else if ( auto func = ast::dyn_cast< ast::FunctionType >( lhs ) ) {
+			auto other = static_cast< const ast::FunctionType * >( rhs );
+			return func->isVarArgs == other->isVarArgs
+				&& func->returns.size() == other->returns.size();
+		} else if ( auto inst = ast::dyn_cast< ast::BaseInstType >( lhs ) ) {
+			auto other = static_cast< const ast::BaseInstType * >( rhs );
+			return inst->name == other->name && inst->hoistType == other->hoistType
+				&& instBase( lhs ) == instBase( rhs );
+		}
+		return true;
+	}
+
+	std::size_t hashKeyNode( const ast::Type * type, const KeyParts & parts ) {
+		std::size_t hash = static_cast< std::size_t >( type->kind() ) ^ ( type->qualifiers.val << 8 );
+		auto combine = [&hash]( std::size_t value ) {
+			hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		};
+		if ( auto basic = ast::dyn_cast< ast::BasicType >( type ) ) {
+			combine( basic->kind );
+		} else if ( auto inst = ast::dyn_cast< ast::BaseInstType >( type ) ) {
+			combine( std::hash<std::string>()( inst->name ) );
+		}
+		for ( const ast::Type * part : parts ) {
+			combine( std::hash<const ast::Type *>()( part ) );
+		}
+		return hash;
+	}
+
+	/// Copy the type with its parts replaced by their keys.
+	const ast::Type * rebuildKey( const ast::Type * type, const KeyParts & parts ) {
+		ast::Type * copy = ast::shallowCopy( type );
+		auto part = parts.begin();
+		if ( auto pointer = dynamic_cast< ast::PointerType * >( copy ) ) {
+			pointer->base = *part;
+		} else if ( auto ref = dynamic_cast< ast::ReferenceType * >( copy ) ) {
+			ref->base = *part;
+		} else if ( auto func = dynamic_cast< ast::FunctionType * >( copy ) ) {
+			for ( ast::ptr<ast::Type> & ret : func->returns ) ret = *part++;
+			for ( ast::ptr<ast::Type> & param : func->params ) param = *part++;
+		} else if ( auto inst = dynamic_cast< ast::BaseInstType * >( copy ) ) {
+			for ( ast::ptr<ast::Expr> & param : inst->params ) {
+				ast::TypeExpr * expr = ast::shallowCopy( param.strict_as<ast::TypeExpr>() );
+				expr->type = *part++;
+				param = expr;
+			}
+		}
+		return copy;
+	}
+
+	/// The key types of the cost caches, by hash. Their parts are keys themselves.
+	std::unordered_multimap<std::size_t, ast::ptr<ast::Type>> keyTypes;
+
+	/// Get the key of a closed type in the cost caches: a type structurally
+	/// equal to it and the same node for every such type. Returns null for
+	/// types with type variables, or with parts that are not compared
+	/// structurally, such as array dimensions and attributes. Key types are
+	/// only used to find cached costs; they are never put in the tree.
+	const ast::Type * costKey( const ast::Type * type ) {
+		KeyParts parts;
+		if ( ! keyParts( type, parts ) ) return nullptr;
+		bool changed = false;
+		for ( const ast::Type *& part : parts ) {
+			const ast::Type * key = costKey( part );
+			if ( ! key ) return nullptr;
+			changed |= key != part;
+			part = key;
+		}
+
+		std::size_t hash = hashKeyNode( type, parts );
+		auto range = keyTypes.equal_range( hash );
+		for ( auto it = range.first ; it != range.second ; ++it ) {
+			const ast::Type * candidate = it->second;
+			if ( candidate == type ) return candidate;
+			if ( ! sameKeyNode( candidate, type ) ) continue;
+			KeyParts others;
+			keyParts( candidate, others );
+			if ( others == parts ) return candidate;
+		}
+
+		// A node nothing holds yet may still be changed in place by its creator.
+		const ast::Type * key = ( changed || ! type->isManaged() ) ? rebuildKey( type, parts ) : type;
+		keyTypes.emplace( hash, key );
+		return key;
+	}
+
+	Cost uncachedConversionCost(
+		const ast::Type * src, const ast::Type * dst, bool srcIsLvalue,
+		const ast::SymbolTable & symtab, const ast::TypeEnvironment & env );
+}
+
+CostCache::CostCache( const char * name, Calculation calc ) : calc( calc ) {
+	using namespace Stats::Counters;
+	auto group = build<CounterGroup>( name );
+	hits = build<SimpleCounter>( "hit", group );
+	misses = build<SimpleCounter>( "miss", group );
+	bypasses = build<SimpleCounter>( "bypass", group );
+	allCostCaches().push_back( this );
+}
+
+CostCache::~CostCache() {
+	auto & caches = allCostCaches();
+	caches.erase( std::find( caches.begin(), caches.end(), this ) );
+}
+
+std::size_t CostCache::KeyHash::operator()( const Key & key ) const {
+	std::size_t hash = std::hash<const ast::Type *>()( key.src.get() );
+	hash ^= std::hash<const ast::Type *>()( key.dst.get() ) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+	return hash * 2 + key.srcIsLvalue;
+}
+
+Cost CostCache::operator()( const ast::Type * src, const ast::Type * dst, bool srcIsLvalue,
+		const ast::SymbolTable & symtab, const ast::TypeEnvironment & env ) {
+	const ast::Type * closedSrc = costKey( src );
+	const ast::Type * closedDst = closedSrc ? costKey( dst ) : nullptr;
+	if ( ! closedDst ) {
+		++*bypasses;
+		return calc( src, dst, srcIsLvalue, symtab, env );
+	}
+	Key key = { closedSrc, closedDst, srcIsLvalue };
+	auto it = table.find( key );
+	if ( it != table.end() ) {
+		++*hits;
+		return it->second;
+	}
+	++*misses;
+	// The calculation may use this cache again, so insert afterwards.
+	Cost cost = calc( src, dst, srcIsLvalue, symtab, env );
+	table.emplace( std::move( key ), cost );
+	return cost;
+}
+
+void CostCache::clearAll() {
+	for ( CostCache * cache : allCostCaches() ) {
+		cache->table.clear();
+	}
+	keyTypes.clear();
 }
 
 Cost conversionCost(
 	const ast::Type * src, const ast::Type * dst, bool srcIsLvalue,
-const ast::SymbolTable & symtab, const ast::TypeEnvironment & env
+	const ast::SymbolTable & symtab, const ast::TypeEnvironment & env
+) {
+	static CostCache cache( "Conversion Cost Cache", uncachedConversionCost );
+	return cache( src, dst, srcIsLvalue, symtab, env );
+}
+
+namespace {
+
+Cost uncachedConversionCost(
+	const ast::Type * src, const ast::Type * dst, bool srcIsLvalue,
+	const ast::SymbolTable & symtab, const ast::TypeEnvironment & env
 ) {
-	if ( const ast::TypeInstType * inst = dynamic_cast< const ast::TypeInstType * >( dst ) ) {
+	if ( const ast::TypeInstType * inst = ast::dyn_cast< ast::TypeInstType >( dst ) ) {
 		if ( const ast::EqvClass * eqv = env.lookup( *inst ) ) {
 			if ( eqv->bound ) {
 				return conversionCost(src, eqv->bound, srcIsLvalue, symtab, env );
@@ -171,7 +389,7 @@ const ast::SymbolTable & symtab, const ast::TypeEnvironment & env
 				return Cost::infinity;
 			}
 		} else if ( const ast::NamedTypeDecl * named = symtab.lookupType( inst->name ) ) {
-			const ast::TypeDecl * type = dynamic_cast< const ast::TypeDecl * >( named );
+			const ast::TypeDecl * type = ast::dyn_cast< ast::TypeDecl >( named );
 			assertf( type, "Unexpected typedef." );
 			if ( type->base ) {
 				return conversionCost( src, type->base, srcIsLvalue, symtab, env ) + Cost::safe;
@@ -180,16 +398,18 @@ const ast::SymbolTable & symtab, const ast::TypeEnvironment & env
 	}
 	if ( typesCompatibleIgnoreQualifiers( src, dst, env ) ) {
 		return Cost::zero;
-	} else if ( dynamic_cast< const ast::VoidType * >( dst ) ) {
+	} else if ( ast::dyn_cast< ast::VoidType >( dst ) ) {
 		return Cost::safe;
 	} else if ( const ast::ReferenceType * refType =
-			 dynamic_cast< const ast::ReferenceType * >( dst ) ) {
+			 ast::dyn_cast< ast::ReferenceType >( dst ) ) {
 		return convertToReferenceCost( src, refType, srcIsLvalue, symtab, env, localPtrsAssignable );
 	} else {
 		return ast::Pass<ConversionCost>::read( src, dst, srcIsLvalue, symtab, env, conversionCost );
 	}
 }
 
+} // namespace
+
 Cost enumCastCost (
 	const ast::EnumInstType * src, const ast::EnumInstType * dst,
 	const ast::SymbolTable & symtab, const ast::TypeEnvironment & env
@@ -211,8 +431,8 @@ static Cost convertToReferenceCost( const ast::Type * src, const ast::Type * dst
 		cost.incReference();
 		return cost;
 	} else if ( 0 == diff ) {
-		const ast::ReferenceType * srcAsRef = dynamic_cast< const ast::ReferenceType * >( src );
-		const ast::ReferenceType * dstAsRef = dynamic_cast< const ast::ReferenceType * >( dst );
+		const ast::ReferenceType * srcAsRef = ast::dyn_cast< ast::ReferenceType >( src );
+		const ast::ReferenceType * dstAsRef = ast::dyn_cast< ast::ReferenceType >( dst );
 		if ( srcAsRef && dstAsRef ) {
 			ast::CV::Qualifiers tq1 = srcAsRef->base->qualifiers;
 			ast::CV::Qualifiers tq2 = dstAsRef->base->qualifiers;
@@ -234,7 +454,7 @@ static Cost convertToReferenceCost( const ast::Type * src, const ast::Type * dst
 		} else {
 			return ast::Pass<ConversionCost>::read( src, dst, srcIsLvalue, symtab, env, conversionCost );
 		}
-		if (const ast::EnumInstType * srcAsInst = dynamic_cast< const ast::EnumInstType * >( src )) {
+		if (const ast::EnumInstType * srcAsInst = ast::dyn_cast< ast::EnumInstType >( src )) {
 			if (srcAsInst->base && !srcAsInst->base->isCfa) {
 				static const ast::BasicType* integer = new ast::BasicType( ast::BasicKind::UnsignedInt );
 				return ast::Pass<ConversionCost>::read( integer, dst, srcIsLvalue, symtab, env, conversionCost );
@@ -242,11 +462,11 @@ static Cost convertToReferenceCost( const ast::Type * src, const ast::Type * dst
 		}
 	} else {
 		assert( -1 == diff );
-		const ast::ReferenceType * dstAsRef = dynamic_cast< const ast::ReferenceType * >( dst );
+		const ast::ReferenceType * dstAsRef = ast::dyn_cast< ast::ReferenceType >( dst );
 		assert( dstAsRef );
 		auto dstBaseType = dstAsRef->base;
 		const ast::Type * newSrc = src;
-		if ( dynamic_cast< const ast::EnumInstType * >( src ) && dstBaseType.as<ast::BasicType>() ) {
+		if ( ast::dyn_cast< ast::EnumInstType >( src ) && dstBaseType.as<ast::BasicType>() ) {
 			newSrc = new ast::BasicType( ast::BasicKind::UnsignedInt );
 		}
 		if (dstAsRef->base->is_const() ) {
@@ -310,9 +530,9 @@ void ConversionCost::conversionCostFromBasicToBasic( const ast::BasicType * src,
 }
 
 void ConversionCost::postvisit( const ast::BasicType * basicType ) {
-	if ( const ast::BasicType * dstAsBasic = dynamic_cast< const ast::BasicType * >( dst ) ) {
+	if ( const ast::BasicType * dstAsBasic = ast::dyn_cast< ast::BasicType >( dst ) ) {
 		conversionCostFromBasicToBasic( basicType, dstAsBasic );
-	} else if ( auto dstAsEnumInst = dynamic_cast< const ast::EnumInstType * >( dst ) ) {
+	} else if ( auto dstAsEnumInst = ast::dyn_cast< ast::EnumInstType >( dst ) ) {
 		if ( dstAsEnumInst->base && !dstAsEnumInst->base->isCfa ) {
 			cost = Cost::safe;
 		}
@@ -320,7 +540,7 @@ void ConversionCost::postvisit( const ast::BasicType * basicType ) {
 }
 
 void ConversionCost::postvisit( const ast::PointerType * pointerType ) {
-	if ( const ast::PointerType * dstAsPtr = dynamic_cast< const ast::PointerType * >( dst ) ) {
+	if ( const ast::PointerType * dstAsPtr = ast::dyn_cast< ast::PointerType >( dst ) ) {
 		ast::CV::Qualifiers tq1 = pointerType->base->qualifiers;
 		ast::CV::Qualifiers tq2 = dstAsPtr->base->qualifiers;
 		if ( tq1 <= tq2 && typesCompatibleIgnoreQualifiers(
@@ -370,7 +590,7 @@ void ConversionCost::postvisit( const ast::ArrayType * arrayType ) {
 }
 
 void ConversionCost::postvisit( const ast::ReferenceType * refType ) {
-	assert( nullptr == dynamic_cast< const ast::ReferenceType * >( dst ) );
+	assert( nullptr == ast::dyn_cast< ast::ReferenceType >( dst ) );
 
 	cost = costCalc( refType->base, dst, srcIsLvalue, symtab, env );
 
@@ -392,7 +612,7 @@ void ConversionCost::postvisit( const ast::FunctionType * functionType ) {
 }
 
 void ConversionCost::postvisit( const ast::EnumInstType * inst ) {
-	if ( auto dstInst = dynamic_cast<const ast::EnumInstType *>( dst ) ) {
+	if ( auto dstInst = ast::dyn_cast<ast::EnumInstType>( dst ) ) {
 		cost = enumCastCost(inst, dstInst, symtab, env);
 	} else if ( !inst->base->isCfa ) {
 		static ast::ptr<ast::BasicType> integer = { new ast::BasicType( ast::BasicKind::SignedInt ) };
@@ -409,12 +629,12 @@ void ConversionCost::postvisit( const ast::TypeInstType * typeInstType ) {
 	if ( const ast::EqvClass * eqv = env.lookup( *typeInstType ) ) {
 		cost = costCalc( eqv->bound, dst, srcIsLvalue, symtab, env );
 	} else if ( const ast::TypeInstType * dstAsInst =
-			dynamic_cast< const ast::TypeInstType * >( dst ) ) {
+			ast::dyn_cast< ast::TypeInstType >( dst ) ) {
 		if ( *typeInstType == *dstAsInst ) {
 			cost = Cost::zero;
 		}
 	} else if ( const ast::NamedTypeDecl * namedType = symtab.lookupType( typeInstType->name ) ) {
-		const ast::TypeDecl * type = dynamic_cast< const ast::TypeDecl * >( namedType );
+		const ast::TypeDecl * type = ast::dyn_cast< ast::TypeDecl >( namedType );
 		assertf( type, "Unexpected typedef.");
 		if ( type->base ) {
 			cost = costCalc( type->base, dst, srcIsLvalue, symtab, env ) + Cost::safe;
@@ -424,7 +644,7 @@ void ConversionCost::postvisit( const ast::TypeInstType * typeInstType ) {
 
 void ConversionCost::postvisit( const ast::TupleType * tupleType ) {
 	Cost c = Cost::zero;
-	if ( const ast::TupleType * dstAsTuple = dynamic_cast< const ast::TupleType * >( dst ) ) {
+	if ( const ast::TupleType * dstAsTuple = ast::dyn_cast< ast::TupleType >( dst ) ) {
 		auto srcIt = tupleType->types.begin();
 		auto dstIt = dstAsTuple->types.begin();
 		auto srcEnd = tupleType->types.end();
@@ -446,17 +666,17 @@ void ConversionCost::postvisit( const ast::TupleType * tupleType ) {
 
 void ConversionCost::postvisit( const ast::VarArgsType * varArgsType ) {
 	(void)varArgsType;
-	if ( dynamic_cast< const ast::VarArgsType * >( dst ) ) {
+	if ( ast::dyn_cast< ast::VarArgsType >( dst ) ) {
 		cost = Cost::zero;
 	}
 }
 
 void ConversionCost::postvisit( const ast::ZeroType * zeroType ) {
 	(void)zeroType;
-	if ( dynamic_cast< const ast::ZeroType * >( dst ) ) {
+	if ( ast::dyn_cast< ast::ZeroType >( dst ) ) {
 		cost = Cost::zero;
 	} else if ( const ast::BasicType * dstAsBasic =
-			dynamic_cast< const ast::BasicType * >( dst ) ) {
+			ast::dyn_cast< ast::BasicType >( dst ) ) {
 		int tableResult = costMatrix[ ast::BasicKind::SignedInt ][ dstAsBasic->kind ];
 		if ( -1 == tableResult ) {
 			cost = Cost::unsafe;
@@ -470,12 +690,12 @@ void ConversionCost::postvisit( const ast::ZeroType * zeroType ) {
 		// bit of coherence with C?
 		// TODO: currently this does not work when no zero/one overloads exist. Find a fix for it.
 		// cost = Cost::zero;
-	} else if ( dynamic_cast< const ast::PointerType * >( dst ) ) {
+	} else if ( ast::dyn_cast< ast::PointerType >( dst ) ) {
 		cost = Cost::zero;
 		// +1 for zero_t ->, +1 for disambiguation
 		cost.incSafe( maxIntCost + 2 );
 		// assuming 0p is supposed to be used for pointers?
-	} else if ( auto dstAsEnumInst = dynamic_cast< const ast::EnumInstType * >( dst ) ) {
+	} else if ( auto dstAsEnumInst = ast::dyn_cast< ast::EnumInstType >( dst ) ) {
 		if ( dstAsEnumInst->base && !dstAsEnumInst->base->isCfa ) {
 			cost = Cost::safe;
 		}
@@ -484,10 +704,10 @@ void ConversionCost::postvisit( const ast::ZeroType * zeroType ) {
 
 void ConversionCost::postvisit( const ast::OneType * oneType ) {
 	(void)oneType;
-	if ( dynamic_cast< const ast::OneType * >( dst ) ) {
+	if ( ast::dyn_cast< ast::OneType >( dst ) ) {
 		cost = Cost::zero;
 	} else if ( const ast::BasicType * dstAsBasic =
-			dynamic_cast< const ast::BasicType * >( dst ) ) {
+			ast::dyn_cast< ast::BasicType >( dst ) ) {
 		int tableResult = costMatrix[ ast::BasicKind::SignedInt ][ dstAsBasic->kind ];
 		if ( -1 == tableResult ) {
 			cost = Cost::unsafe;
@@ -496,7 +716,7 @@ void ConversionCost::postvisit( const ast::OneType * oneType ) {
 			cost.incSafe( tableResult + 1 );
 			cost.incSign( signMatrix[ ast::BasicKind::SignedInt ][ dstAsBasic->kind ] );
 		}
-	} else if ( auto dstAsEnumInst = dynamic_cast< const ast::EnumInstType * >( dst ) ) {
+	} else if ( auto dstAsEnumInst = ast::dyn_cast< ast::EnumInstType >( dst ) ) {
 		if ( dstAsEnumInst->base && !dstAsEnumInst->base->isCfa ) {
 			cost = Cost::safe;
 		}
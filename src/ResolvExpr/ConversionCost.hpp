@@ -16,11 +16,14 @@
 #pragma once
 
 #include <functional>         // for function
+#include <unordered_map>      // for unordered_map
 
 #include "Cost.hpp"           // for Cost
 
 #include "AST/Fwd.hpp"
 #include "AST/Pass.hpp"       // for WithShortCircuiting
+#include "AST/Type.hpp"       // for Type
+#include "Common/Stats/Counter.hpp"
 
 namespace ResolvExpr {
 
@@ -38,6 +41,48 @@ Cost convertToReferenceCost( const ast::Type * src, const ast::ReferenceType * d
 	bool srcIsLvalue, const ast::SymbolTable & indexer, const ast::TypeEnvironment & env,
 	PtrsCalculation func );
 
+/// Memo table for one of the cost calculations. Only pairs of closed types,
+/// those without type variables, are stored; their cost does not depend on
+/// the environment or the symbol table. They are keyed on key types shared
+/// by all structurally equal types, so equal types at different nodes share
+/// entries. Any other pair bypasses the table.
+class CostCache {
+public:
+	using Calculation = Cost (*)( const ast::Type *, const ast::Type *, bool,
+		const ast::SymbolTable &, const ast::TypeEnvironment & );
+
+	CostCache( const char * name, Calculation calc );
+	~CostCache();
+
+	Cost operator()( const ast::Type * src, const ast::Type * dst, bool srcIsLvalue,
+		const ast::SymbolTable & symtab, const ast::TypeEnvironment & env );
+
+	/// Empty all cost caches, releasing the key types.
+	static void clearAll();
+private:
+	/// The key observes its key types, owned by the table of key types,
+	/// so their addresses are not reused while they are cached.
+	struct Key {
+		ast::readonly<ast::Type> src;
+		ast::readonly<ast::Type> dst;
+		bool srcIsLvalue;
+
+		bool operator==( const Key & other ) const {
+			return src.get() == other.src.get() && dst.get() == other.dst.get()
+				&& srcIsLvalue == other.srcIsLvalue;
+		}
+	};
+	struct KeyHash {
+		std::size_t operator()( const Key & key ) const;
+	};
+
+	Calculation calc;
+	std::unordered_map<Key, Cost, KeyHash> table;
+	Stats::Counters::SimpleCounter * hits;
+	Stats::Counters::SimpleCounter * misses;
+	Stats::Counters::SimpleCounter * bypasses;
+};
+
 class ConversionCost : public ast::WithShortCircuiting {
 protected:
 	const ast::Type * dst;
@@ -34,7 +34,7 @@ struct PtrsAssignable : public ast::WithShortCircuiting {
 	void previsit( ast::Type * ) { visit_children = false; }
 
 	void postvisit( const ast::EnumInstType * ) {
-		if ( dynamic_cast< const ast::BasicType * >( dst ) ) {
+		if ( ast::dyn_cast< ast::BasicType >( dst ) ) {
 			// int * = E *, etc. is safe. This isn't technically correct, as each
 			// enum has one basic type that it is compatible with, an that type can
 			// differ from enum to enum. Without replicating GCC's internal logic,
@@ -57,12 +57,12 @@ struct PtrsAssignable : public ast::WithShortCircuiting {
 
 int ptrsAssignable( const ast::Type * src, const ast::Type * dst,
 		const ast::TypeEnvironment & env ) {
-	if ( const ast::TypeInstType * dstAsInst = dynamic_cast< const ast::TypeInstType * >( dst ) ) {
+	if ( const ast::TypeInstType * dstAsInst = ast::dyn_cast< ast::TypeInstType >( dst ) ) {
 		if ( const ast::EqvClass * eqv = env.lookup( *dstAsInst ) ) {
 			return ptrsAssignable( src, eqv->bound, env );
 		}
 	}
-	if ( dynamic_cast< const ast::VoidType * >( dst ) ) {
+	if ( ast::dyn_cast< ast::VoidType >( dst ) ) {
 		return -1;
 	} else {
 		ast::Pass<PtrsAssignable> visitor( dst, env );
@@ -73,7 +73,7 @@ int ptrsAssignable( const ast::Type * src, const ast::Type * dst,
 // see ticket #136 (this should be able to replace the visitor).
 #if 0
 	if ( const ast::TypeInstType * dstAsTypeInst =
-			dynamic_cast< const ast::TypeInstType* >( dst ) ) {
+			ast::dyn_cast< ast::TypeInstType >( dst ) ) {
 		if ( const ast::EqvClass * eqv = env.lookup( dstAsTypeInst->get_name() ) ) {
 			return ptrsAssignable( src, eqv->type, env );
 		} // if
@@ -92,7 +92,7 @@ int ptrsAssignable( const ast::Type * src, const ast::Type * dst,
 			return 1;
 		}
 	} else if ( const ast::TypeInstType * typeInstType =
-			dynamic_cast< const ast::TypeInstType * >( src ) ) {
+			ast::dyn_cast< ast::TypeInstType >( src ) ) {
 		if ( const ast::EqvClass * eqv = env.lookup( typeInstType->name ) ) {
 			if ( eqv->bound ) {
 				// T * = S * for any S depends on the type bound to T
@@ -28,11 +28,11 @@ namespace {
 	int objectCast(
 		const ast::Type * src, const ast::TypeEnvironment & env, const ast::SymbolTable & symtab
 	) {
-		if ( dynamic_cast< const ast::FunctionType * >( src ) ) {
+		if ( ast::dyn_cast< ast::FunctionType >( src ) ) {
 			return -1;
-		} else if ( auto inst = dynamic_cast< const ast::TypeInstType * >( src ) ) {
+		} else if ( auto inst = ast::dyn_cast< ast::TypeInstType >( src ) ) {
 			if ( const ast::NamedTypeDecl * named = symtab.lookupType( inst->name ) ) {
-				if ( auto tyDecl = dynamic_cast< const ast::TypeDecl * >( named ) ) {
+				if ( auto tyDecl = ast::dyn_cast< ast::TypeDecl >( named ) ) {
 					if ( tyDecl->kind == ast::TypeDecl::Ftype ) {
 						return -1;
 					}
@@ -96,9 +96,9 @@ namespace {
 		}
 
 		void postvisit( const ast::EnumInstType * ) {
-			if ( dynamic_cast< const ast::EnumInstType * >( dst ) ) {
+			if ( ast::dyn_cast< ast::EnumInstType >( dst ) ) {
 				result = 1;
-			} else if ( auto bt = dynamic_cast< const ast::BasicType * >( dst ) ) {
+			} else if ( auto bt = ast::dyn_cast< ast::BasicType >( dst ) ) {
 				if ( bt->kind == ast::BasicKind::SignedInt ) {
 					result = 0;
 				} else {
@@ -139,13 +139,13 @@ int ptrsCastable(
 	const ast::Type * src, const ast::Type * dst, const ast::SymbolTable & symtab,
 	const ast::TypeEnvironment & env
 ) {
-	if ( auto inst = dynamic_cast< const ast::TypeInstType * >( dst ) ) {
+	if ( auto inst = ast::dyn_cast< ast::TypeInstType >( dst ) ) {
 		if ( const ast::EqvClass * eqvClass = env.lookup( *inst ) ) {
 			return ptrsAssignable( src, eqvClass->bound, env );
 		}
 	}
 
-	if ( dynamic_cast< const ast::VoidType * >( dst ) ) {
+	if ( ast::dyn_cast< ast::VoidType >( dst ) ) {
 		return objectCast( src, env, symtab );
 	} else {
 		return ast::Pass<PtrsCastable>::read( src, dst, env, symtab );
@@ -128,6 +128,7 @@ const ast::ObjectDecl * fixObjectType( const ast::ObjectDecl * decl , const Reso
 	}
 
 	mutDecl->type = renameTyVars(mutDecl->type, RenameMode::GEN_EXPR_ID);
+	mutDecl->clearMangleCache();
 	mutDecl->isTypeFixed = true;
 
 	auto enumInst = decl->type.as<ast::EnumInstType>();
@@ -168,7 +169,7 @@ const ast::ObjectDecl *fixObjectInit(
 					// assert( candidates.size() == 1 );
 					if ( candidates.size() != 1 ) return decl;
 					auto candidate = candidates.at(0);
-					if ( const ast::EnumInstType * enumInst = dynamic_cast<const ast::EnumInstType *>(candidate.id->get_type())) {
+					if ( const ast::EnumInstType * enumInst = ast::dyn_cast<ast::EnumInstType>(candidate.id->get_type())) {
 						// determine that is an enumInst, swap it with its const value
 						assert( candidates.size() == 1 );
 						const ast::EnumDecl * baseEnum = enumInst->base;
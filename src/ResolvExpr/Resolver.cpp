@@ -20,11 +20,13 @@
 
 #include "Candidate.hpp"
 #include "CandidateFinder.hpp"
+#include "ConversionCost.hpp"            // for CostCache
 #include "CurrentObject.hpp"             // for CurrentObject
 #include "RenameVars.hpp"                // for RenameVars, global_renamer
 #include "Resolver.hpp"
 #include "ResolveTypeof.hpp"
 #include "ResolveMode.hpp"               // for ResolveMode
+#include "SatisfyAssertions.hpp"         // for clearSatisfierCache
 #include "Typeops.hpp"                   // for extractResultType
 #include "Unify.hpp"                     // for unify
 #include "CompilationState.hpp"
@@ -86,10 +88,10 @@ namespace {
 			else if ( ! des->designators.empty() ) {
 				if ( (des->designators.size() == 1) ) {
 					const ast::Expr * designator = des->designators.at(0);
-					if ( const ast::NameExpr * designatorName = dynamic_cast<const ast::NameExpr *>(designator) ) {
+					if ( const ast::NameExpr * designatorName = ast::dyn_cast<ast::NameExpr>(designator) ) {
 						auto candidates = context.symtab.lookupId(designatorName->name);
 						for ( auto candidate : candidates ) {
-							if ( dynamic_cast<const ast::EnumInstType *>(candidate.id->get_type()) ) {
+							if ( ast::dyn_cast<ast::EnumInstType>(candidate.id->get_type()) ) {
 								result = true;
 								break;
 							}
@@ -321,18 +323,18 @@ ast::ptr< ast::Expr > findSingleExpression(
 namespace {
 	bool structOrUnionOrEnum( const Candidate & i ) {
 		const ast::Type * t = i.expr->result->stripReferences();
-		return dynamic_cast< const ast::StructInstType * >( t ) || dynamic_cast< const ast::UnionInstType * >( t ) || dynamic_cast< const ast::EnumInstType * >( t );
+		return ast::dyn_cast< ast::StructInstType >( t ) || ast::dyn_cast< ast::UnionInstType >( t ) || ast::dyn_cast< ast::EnumInstType >( t );
 	}
 	/// Predicate for "Candidate has integral type"
 	bool hasIntegralType( const Candidate & i ) {
 		const ast::Type * type = i.expr->result;
 
-		if ( auto bt = dynamic_cast< const ast::BasicType * >( type ) ) {
+		if ( auto bt = ast::dyn_cast< ast::BasicType >( type ) ) {
 			return bt->isInteger();
 		} else if (
-			dynamic_cast< const ast::EnumInstType * >( type )
-			|| dynamic_cast< const ast::ZeroType * >( type )
-			|| dynamic_cast< const ast::OneType * >( type )
+			ast::dyn_cast< ast::EnumInstType >( type )
+			|| ast::dyn_cast< ast::ZeroType >( type )
+			|| ast::dyn_cast< ast::OneType >( type )
 		) {
 			return true;
 		} else return false;
@@ -355,7 +357,7 @@ namespace {
 
 	/// check if a type is a character type
 	bool isCharType( const ast::Type * t ) {
-		if ( auto bt = dynamic_cast< const ast::BasicType * >( t ) ) {
+		if ( auto bt = ast::dyn_cast< ast::BasicType >( t ) ) {
 			return bt->kind == ast::BasicKind::Char
 				|| bt->kind == ast::BasicKind::SignedChar
 				|| bt->kind == ast::BasicKind::UnsignedChar;
@@ -437,6 +439,9 @@ InitTweak::ManagedTypes Resolver::managedTypes;
 
 void resolve( ast::TranslationUnit& translationUnit ) {
 	ast::Pass< Resolver >::run( translationUnit, translationUnit.global );
+	// Later passes mutate types, which must not be held by the caches.
+	CostCache::clearAll();
+	clearSatisfierCache();
 }
 
 ast::ptr< ast::Init > resolveCtorInit(
@@ -557,6 +562,7 @@ const ast::FunctionDecl * Resolver::previsit( const ast::FunctionDecl * function
 		symtab.leaveScope();
 
 		mutDecl->type = renamedType;
+		mutDecl->clearMangleCache();
 		mutDecl->mangleName = Mangle::mangle(mutDecl);
 		mutDecl->isTypeFixed = true;
 		functionDecl = mutDecl;
@@ -615,11 +621,11 @@ const ast::ObjectDecl * Resolver::previsit( const ast::ObjectDecl * objectDecl )
 	// selecting the RHS.
 	GuardValue( currentObject );
 
-	if ( inEnumDecl && dynamic_cast< const ast::EnumInstType * >( objectDecl->get_type() ) ) {
+	if ( inEnumDecl && ast::dyn_cast< ast::EnumInstType >( objectDecl->get_type() ) ) {
 		// enumerator initializers should not use the enum type to initialize, since the
 		// enum type is still incomplete at this point. Use `int` instead.
 
-		if ( auto enumBase = dynamic_cast< const ast::EnumInstType * >
+		if ( auto enumBase = ast::dyn_cast< ast::EnumInstType >
 			( objectDecl->get_type() )->base->base ) {
 			objectDecl = fixObjectType( objectDecl, context );
 			currentObject = ast::CurrentObject{
@@ -905,7 +911,7 @@ const ast::WaitForStmt * Resolver::previsit( const ast::WaitForStmt * stmt ) {
 		SemanticErrorException errors;
 		for ( CandidateRef & func : funcFinder.candidates ) {
 			try {
-				auto pointerType = dynamic_cast< const ast::PointerType * >(
+				auto pointerType = ast::dyn_cast< ast::PointerType >(
 					func->expr->result->stripReferences() );
 				if ( ! pointerType ) {
 					SemanticError( stmt->location, func->expr->result.get(),
@@ -928,7 +934,7 @@ const ast::WaitForStmt * Resolver::previsit( const ast::WaitForStmt * stmt ) {
 					}
 				}
 
-				CandidateRef func2{ new Candidate{ *func } };
+				CandidateRef func2 = makeCandidate( *func );
 				// strip reference from function
 				func2->expr = referenceToRvalueConversion( func->expr, func2->cost );
 
@@ -1185,7 +1191,7 @@ const ast::SingleInit * Resolver::previsit( const ast::SingleInit * singleInit )
 	removeExtraneousCast( newExpr );
 
 	// check if actual object's type is char[]
-	if ( auto at = dynamic_cast< const ast::ArrayType * >( initContext ) ) {
+	if ( auto at = ast::dyn_cast< ast::ArrayType >( initContext ) ) {
 		if ( isCharType( at->base ) ) {
 			// check if the resolved type is char*
 			if ( auto pt = newExpr->result.as< ast::PointerType >() ) {
@@ -42,6 +42,7 @@
 #include "FindOpenVars.hpp"
 #include "Common/FilterCombos.hpp"
 #include "Common/Indenter.hpp"
+#include "Common/Stats/Counter.hpp"
 #include "GenPoly/GenPoly.hpp"
 #include "SymTab/Mangler.hpp"
 
@@ -145,6 +146,119 @@ namespace {
 
 	enum AssertionResult {Fail, Skip, Success} ;
 
+	/// Finds type variables, which a type cannot be used as a cache key with.
+	struct TypeVarFinder : public ast::WithShortCircuiting {
+		bool result = false;
+
+		void previsit( const ast::TypeInstType * ) { result = true; visit_children = false; }
+	};
+
+	/// Replaces the type variables of an assertion type with their equivalence classes, numbered
+	/// in order of appearance. Fails on variables that are closed, unbound or bound to a type with
+	/// variables, as unifying with those depends on more of the environment.
+	struct ClassNumberer {
+		const ast::TypeEnvironment & env;
+		const ast::OpenVarSet & open;
+		std::vector< const ast::EqvClass * > classes;
+		bool failed = false;
+
+		ClassNumberer( const ast::TypeEnvironment & env, const ast::OpenVarSet & open )
+		: env( env ), open( open ) {}
+
+		const ast::Type * postvisit( const ast::TypeInstType * inst ) {
+			auto var = open.find( *inst );
+			const ast::EqvClass * cls = env.lookup( *inst );
+			if ( var == open.end() || ! cls || ! cls->bound
+					|| ast::Pass<TypeVarFinder>::read( cls->bound.get() ) ) {
+				failed = true;
+				return inst;
+			}
+			auto it = std::find( classes.begin(), classes.end(), cls );
+			std::string name = std::to_string( it - classes.begin() ) + '_'
+				+ std::to_string( var->second.kind ) + ( var->second.isComplete ? "c" : "" );
+			if ( it == classes.end() ) classes.emplace_back( cls );
+			return new ast::TypeInstType( name, inst->kind, inst->qualifiers );
+		}
+	};
+
+	/// Gets a key for an assertion type under an environment that determines which declarations
+	/// unify with it: the type with numbered classes in place of its variables, then the bound and
+	/// widening of each class. Returns an empty key if there is none.
+	std::string boundKey(
+			const ast::Type * type, const ast::TypeEnvironment & env, const ast::OpenVarSet & open ) {
+		ast::Pass<ClassNumberer> numberer( env, open );
+		ast::ptr< ast::Type > numbered = type->accept( numberer );
+		if ( numberer.core.failed ) return "";
+		std::string key = Mangle::mangleType( numbered );
+		for ( const ast::EqvClass * cls : numberer.core.classes ) {
+			key += '|' + Mangle::mangleType( cls->bound ) + ( cls->allowWidening ? "w" : "" )
+				+ std::to_string( cls->data.kind ) + ( cls->data.isComplete ? "c" : "" );
+		}
+		return key;
+	}
+
+	/// The declarations satisfying an assertion, as found by the first unification with them.
+	struct Satisfiers {
+		/// The satisfying declarations, in lookup order
+		std::vector< ast::SymbolTable::IdData > decls;
+		/// Set if the one satisfying declaration has exactly the bound assertion type, so binding
+		/// it leaves the environment as it was. The inferred parameter then needs no unification.
+		ast::ptr< ast::Type > boundType;
+	};
+
+	/// Satisfying declarations shared by all assertions resolved during resolve(), keyed on the
+	/// identifier tables looked in and the bound assertion type. The views are held so that their
+	/// tables, and so their keys, stay unique while the cache is in use.
+	class SatisfierCache {
+		struct Entry {
+			ast::SymbolTable::IdView view;
+			std::unordered_map< std::string, Satisfiers > byType;
+		};
+		std::unordered_map< const void *, Entry > entries;
+		Stats::Counters::SimpleCounter * hits;
+		Stats::Counters::SimpleCounter * bound;
+		Stats::Counters::SimpleCounter * misses;
+		Stats::Counters::SimpleCounter * unkeyed;
+	public:
+		SatisfierCache() {
+			using namespace Stats::Counters;
+			auto group = build<CounterGroup>( "Assertion Satisfier Cache" );
+			hits = build<SimpleCounter>( "hit", group );
+			bound = build<SimpleCounter>( "hit, no unification", group );
+			misses = build<SimpleCounter>( "miss", group );
+			unkeyed = build<SimpleCounter>( "unkeyed", group );
+		}
+
+		/// Gets the cached satisfiers of an assertion type in the declarations of a view, or
+		/// null. A null key is never cached.
+		const Satisfiers * lookup( const ast::SymbolTable::IdView & view, const std::string & key ) {
+			if ( key.empty() ) {
+				++*unkeyed;
+				return nullptr;
+			}
+			auto entry = entries.find( view.key() );
+			if ( entry != entries.end() ) {
+				auto it = entry->second.byType.find( key );
+				if ( it != entry->second.byType.end() ) {
+					++*( it->second.boundType ? bound : hits );
+					return &it->second;
+				}
+			}
+			++*misses;
+			return nullptr;
+		}
+
+		void insert( const ast::SymbolTable::IdView & view, std::string && key, Satisfiers && sats ) {
+			Entry & entry = entries[ view.key() ];
+			if ( ! entry.view.key() ) entry.view = view;
+			entry.byType.emplace( std::move( key ), std::move( sats ) );
+		}
+
+		void clear() { entries.clear(); }
+	};
+
+	SatisfierCache satisfierCache;
+
 	/// Binds a single assertion, updating satisfaction state
 	void bindAssertion(
 		const ast::VariableExpr * expr, const ast::AssertionSetValue & info, CandidateRef & cand,
@@ -174,8 +288,8 @@ namespace {
 		// find candidates that unify with the desired type
 		AssnCandidateList matches, inexactMatches;
 
-		std::vector<ast::SymbolTable::IdData> candidates;
 		auto kind = ast::SymbolTable::getSpecialFunctionKind(assn.first->var->name);
+		std::string lookupKey = assn.first->var->name;
 		if (kind != ast::SymbolTable::SpecialFunctionKind::NUMBER_OF_KINDS) {
 			// prefilter special decls by argument type, if already known
 			ast::ptr<ast::Type> thisArgType = assn.first->result.strict_as<ast::PointerType>()->base
@@ -193,12 +307,22 @@ namespace {
 			else if (!isUnboundType(thisArgType)) otypeKey = Mangle::mangle(thisArgType, Mangle::Type | Mangle::NoGenericParams);
 			else if (skipUnbound) return AssertionResult::Skip;
 
-			candidates = sat.symtab.specialLookupId(kind, otypeKey);
+			lookupKey = otypeKey;
 		}
-		else {
-			candidates = sat.symtab.lookupId(assn.first->var->name);
+		ast::SymbolTable::IdView candidates = ( kind == ast::SymbolTable::NUMBER_OF_KINDS )
+			? sat.symtab.lookupIdView( lookupKey ) : sat.symtab.specialLookupIdView( kind, lookupKey );
+		ast::ptr< ast::Type > toType = assn.first->result;
+
+		// reuse the satisfying declarations found for the same bound type, if any
+		std::string satKey = candidates.key()
+			? boundKey( toType, sat.cand->env, sat.cand->open ) : "";
+		const Satisfiers * cached = satisfierCache.lookup( candidates, satKey );
+		if ( cached && cached->boundType ) {
+			matches.emplace_back(
+				cached->decls.front(), cached->boundType, ast::TypeEnvironment{ sat.cand->env },
+				ast::AssertionSet{}, ast::AssertionSet{}, ast::OpenVarSet{ sat.cand->open }, 0 );
 		}
-		for ( const ast::SymbolTable::IdData & cdata : candidates ) {
+		auto tryCandidate = [&]( const ast::SymbolTable::IdData & cdata ) {
 			const ast::DeclWithType * candidate = cdata.id;
 
 			// ignore deleted candidates.
@@ -206,13 +330,12 @@ namespace {
 			// further investigations might be needed to determine
 			// if we should implement the same rule here
 			// (i.e. error if unique best match is deleted)
-			if (candidate->isDeleted && candidate->linkage == ast::Linkage::AutoGen) continue;
+			if (candidate->isDeleted && candidate->linkage == ast::Linkage::AutoGen) return;
 
 			// build independent unification context for candidate
 			ast::AssertionSet have, newNeed;
 			ast::TypeEnvironment newEnv{ sat.cand->env };
 			ast::OpenVarSet newOpen{ sat.cand->open };
-			ast::ptr< ast::Type > toType = assn.first->result;
 			ast::ptr< ast::Type > adjType =
 				renameTyVars( adjustExprType( candidate->get_type(), newEnv, sat.symtab ), GEN_USAGE, false );
 
@@ -252,10 +375,31 @@ namespace {
 						std::move( newOpen ), crntResnSlot );
 				}
 			}
+		};
+		if ( ! cached ) {
+			for ( const ast::SymbolTable::IdData & cdata : candidates ) tryCandidate( cdata );
+		} else if ( ! cached->boundType ) {
+			for ( const ast::SymbolTable::IdData & cdata : cached->decls ) tryCandidate( cdata );
 		}
 
 		// break if no satisfying match
+		bool exact = ! matches.empty();
 		if ( matches.empty() ) matches = std::move(inexactMatches);
+
+		if ( ! cached && ! satKey.empty() ) {
+			Satisfiers sats;
+			for ( const AssnCandidate & match : matches ) sats.decls.emplace_back( match.cdata );
+			if ( exact && 1 == matches.size() && matches.front().need.empty()
+					&& matches.front().have.empty()
+					&& ! ast::Pass<TypeVarFinder>::read( matches.front().adjType.get() ) ) {
+				ast::ptr< ast::Type > boundType = toType;
+				sat.cand->env.apply( boundType );
+				if ( Mangle::mangleType( boundType ) == Mangle::mangleType( matches.front().adjType ) ) {
+					sats.boundType = matches.front().adjType;
+				}
+			}
+			satisfierCache.insert( candidates, std::move( satKey ), std::move( sats ) );
+		}
 		if ( matches.empty() ) return AssertionResult::Fail;
 
 		// defer if too many satisfying matches
@@ -426,6 +570,10 @@ namespace {
 	static const int deferLimit = 10;
 } // anonymous namespace
 
+void clearSatisfierCache() {
+	satisfierCache.clear();
+}
+
 void satisfyAssertions(
 	CandidateRef & cand, const ast::SymbolTable & symtab, CandidateList & out,
 	std::vector<std::string> & errors
@@ -530,7 +678,7 @@ void satisfyAssertions(
 				// process mutually-compatible combinations
 				for ( auto & compat : compatible ) {
 					// set up next satisfaction state
-					CandidateRef nextCand = std::make_shared<Candidate>(
+					CandidateRef nextCand = makeCandidate(
 						sat.cand->expr, std::move( compat.env ), std::move( compat.open ),
 						ast::AssertionSet{} /* need moved into satisfaction state */,
 						sat.cand->cost );
@@ -32,6 +32,10 @@ void satisfyAssertions(
 	CandidateRef & cand, const ast::SymbolTable & symtab, CandidateList & out,
 	std::vector<std::string> & errors );
 
+/// Drops the satisfying declarations cached across assertions, which refer to the declarations
+/// and types of the translation unit being resolved
+void clearSatisfierCache();
+
 } // namespace ResolvExpr
 
 // Local Variables: //
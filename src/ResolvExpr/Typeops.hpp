@@ -54,7 +54,7 @@ void combos( InputIterator begin, InputIterator end, OutputIterator out ) {
 inline void flatten(
 	const ast::Type * type, std::vector< ast::ptr< ast::Type > > & out
 ) {
-	if ( auto tupleType = dynamic_cast< const ast::TupleType * >( type ) ) {
+	if ( auto tupleType = ast::dyn_cast< ast::TupleType >( type ) ) {
 		for ( const ast::Type * t : tupleType->types ) {
 			flatten( t, out );
 		}
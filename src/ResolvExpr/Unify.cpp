@@ -108,10 +108,10 @@ namespace {
 	};
 }
 
-std::vector< ast::ptr< ast::Type > > flattenList(
-	const std::vector< ast::ptr< ast::Type > > & src, ast::TypeEnvironment & env
+ast::vector< ast::Type > flattenList(
+	const ast::vector< ast::Type > & src, ast::TypeEnvironment & env
 ) {
-	std::vector< ast::ptr< ast::Type > > dst;
+	ast::vector< ast::Type > dst;
 	dst.reserve( src.size() );
 	for ( const auto & d : src ) {
 		ast::Pass<TtypeExpander> expander( env );
@@ -189,7 +189,7 @@ public:
 			assert( visit_children == true );
 			visit_children = false;
 
-			auto e2c = dynamic_cast< const ast::CastExpr * >( e2 );
+			auto e2c = ast::dyn_cast< ast::CastExpr >( e2 );
 			if ( !e2c ) return;
 
 			// inspect casts' target types
@@ -210,7 +210,7 @@ public:
 			assert( visit_children == true );
 			visit_children = false;
 
-			auto e2v = dynamic_cast< const ast::VariableExpr * >( e2 );
+			auto e2v = ast::dyn_cast< ast::VariableExpr >( e2 );
 			if ( !e2v ) return;
 
 			assert(e1->var);
@@ -230,7 +230,7 @@ public:
 			assert( visit_children == true );
 			visit_children = false;
 
-			auto e2so = dynamic_cast< const ast::SizeofExpr * >( e2 );
+			auto e2so = ast::dyn_cast< ast::SizeofExpr >( e2 );
 			if ( !e2so ) return;
 
 			// expression unification calls type unification (mutual recursion)
@@ -270,17 +270,17 @@ public:
 	void previsit( const ast::Node * ) { visit_children = false; }
 
 	void postvisit( const ast::VoidType * ) {
-		result = dynamic_cast< const ast::VoidType * >( type2 );
+		result = ast::dyn_cast< ast::VoidType >( type2 );
 	}
 
 	void postvisit( const ast::BasicType * basic ) {
-		if ( auto basic2 = dynamic_cast< const ast::BasicType * >( type2 ) ) {
+		if ( auto basic2 = ast::dyn_cast< ast::BasicType >( type2 ) ) {
 			result = basic->kind == basic2->kind;
 		}
 	}
 
 	void postvisit( const ast::PointerType * pointer ) {
-		if ( auto pointer2 = dynamic_cast< const ast::PointerType * >( type2 ) ) {
+		if ( auto pointer2 = ast::dyn_cast< ast::PointerType >( type2 ) ) {
 			result = unifyExact(
 				pointer->base, pointer2->base, tenv, need, have, open,
 				noWiden());
@@ -288,7 +288,7 @@ public:
 	}
 
 	void postvisit( const ast::ArrayType * array ) {
-		auto array2 = dynamic_cast< const ast::ArrayType * >( type2 );
+		auto array2 = ast::dyn_cast< ast::ArrayType >( type2 );
 		if ( !array2 ) return;
 
 		if ( array->isVarLen != array2->isVarLen ) return;
@@ -306,7 +306,7 @@ public:
 	}
 
 	void postvisit( const ast::ReferenceType * ref ) {
-		if ( auto ref2 = dynamic_cast< const ast::ReferenceType * >( type2 ) ) {
+		if ( auto ref2 = ast::dyn_cast< ast::ReferenceType >( type2 ) ) {
 			result = unifyExact(
 				ref->base, ref2->base, tenv, need, have, open, noWiden());
 		}
@@ -367,8 +367,8 @@ private:
 	}
 
 	static bool unifyTypeList(
-		const std::vector< ast::ptr< ast::Type > > & list1,
-		const std::vector< ast::ptr< ast::Type > > & list2,
+		const ast::vector< ast::Type > & list1,
+		const ast::vector< ast::Type > & list2,
 		ast::TypeEnvironment & env, ast::AssertionSet & need, ast::AssertionSet & have,
 		const ast::OpenVarSet & open
 	) {
@@ -396,7 +396,7 @@ private:
 
 public:
 	void postvisit( const ast::FunctionType * func ) {
-		auto func2 = dynamic_cast< const ast::FunctionType * >( type2 );
+		auto func2 = ast::dyn_cast< ast::FunctionType >( type2 );
 		if ( !func2 ) return;
 
 		if ( func->isVarArgs != func2->isVarArgs ) return;
@@ -461,8 +461,8 @@ private:
 		if ( !this->result ) return;
 
 		// check that parameters of types unify, if any
-		const std::vector< ast::ptr< ast::Expr > > & params = inst->params;
-		const std::vector< ast::ptr< ast::Expr > > & params2 = otherInst->params;
+		const ast::vector< ast::Expr > & params = inst->params;
+		const ast::vector< ast::Expr > & params2 = otherInst->params;
 
 		auto it = params.begin();
 		auto jt = params2.begin();
@@ -519,7 +519,7 @@ public:
 
 	void postvisit( const ast::TypeInstType * typeInst ) {
 		// assert( open.find( *typeInst ) == open.end() );
-		auto otherInst = dynamic_cast< const ast::TypeInstType * >( type2 );
+		auto otherInst = ast::dyn_cast< ast::TypeInstType >( type2 );
 		if ( otherInst && typeInst->name == otherInst->name ) {
 			this->result = otherInst;
 		}
@@ -585,7 +585,7 @@ private:
 
 public:
 	void postvisit( const ast::TupleType * tuple ) {
-		auto tuple2 = dynamic_cast< const ast::TupleType * >( type2 );
+		auto tuple2 = ast::dyn_cast< ast::TupleType >( type2 );
 		if ( ! tuple2 ) return;
 
 		ast::Pass<TtypeExpander> expander{ tenv };
@@ -600,15 +600,15 @@ public:
 	}
 
 	void postvisit( const ast::VarArgsType * ) {
-		result = dynamic_cast< const ast::VarArgsType * >( type2 );
+		result = ast::dyn_cast< ast::VarArgsType >( type2 );
 	}
 
 	void postvisit( const ast::ZeroType * ) {
-		result = dynamic_cast< const ast::ZeroType * >( type2 );
+		result = ast::dyn_cast< ast::ZeroType >( type2 );
 	}
 
 	void postvisit( const ast::OneType * ) {
-		result = dynamic_cast< const ast::OneType * >( type2 );
+		result = ast::dyn_cast< ast::OneType >( type2 );
 	}
 };
 
@@ -642,8 +642,8 @@ bool unifyExact(
 ) {
 	if ( type1->qualifiers != type2->qualifiers ) return false;
 
-	auto var1 = dynamic_cast< const ast::TypeInstType * >( type1 );
-	auto var2 = dynamic_cast< const ast::TypeInstType * >( type2 );
+	auto var1 = ast::dyn_cast< ast::TypeInstType >( type1 );
+	auto var2 = ast::dyn_cast< ast::TypeInstType >( type2 );
 	bool isopen1 = var1 && env.lookup(*var1);
 	bool isopen2 = var2 && env.lookup(*var2);
 
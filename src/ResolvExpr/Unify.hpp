@@ -17,6 +17,7 @@
 
 #include "AST/Node.hpp"             // for ptr
 #include "AST/TypeEnvironment.hpp"  // for TypeEnvironment, AssertionSet, OpenVarSet
+#include "AST/Vector.hpp"           // for vector
 #include "WidenMode.hpp"            // for WidenMode
 
 namespace ast {
@@ -58,8 +59,8 @@ bool typesCompatibleIgnoreQualifiers(
 /// Creates or extracts the type represented by returns in a `FunctionType`.
 ast::ptr<ast::Type> extractResultType( const ast::FunctionType * func );
 
-std::vector<ast::ptr<ast::Type>> flattenList(
-	const std::vector<ast::ptr<ast::Type>> & src, ast::TypeEnvironment & env
+ast::vector<ast::Type> flattenList(
+	const ast::vector<ast::Type> & src, ast::TypeEnvironment & env
 );
 
 } // namespace ResolvExpr
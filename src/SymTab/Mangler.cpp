@@ -23,6 +23,7 @@
 
 #include "AST/Pass.hpp"
 #include "CodeGen/OperatorTable.hpp"     // for OperatorInfo, operatorLookup
+#include "Common/Stats/Counter.hpp"      // for SimpleCounter
 #include "Common/ToString.hpp"           // for toCString
 #include "Common/SemanticError.hpp"      // for SemanticError
 
@@ -346,6 +347,37 @@ std::string mangle( const ast::Node * decl, Mangle::Mode mode ) {
 	return ast::Pass<Mangler>::read( decl, mode );
 }
 
+namespace {
+	auto cacheStats() {
+		using namespace Stats::Counters;
+		static auto group = build<CounterGroup>("Mangle Cache");
+		static struct {
+			SimpleCounter * computed;
+			SimpleCounter * saved;
+		} ret = {
+			.computed = build<SimpleCounter>("Mangled", group),
+			.saved    = build<SimpleCounter>("Mangles Saved", group),
+		};
+		return ret;
+	}
+} // namespace
+
+const Symbol & mangleCached( const ast::DeclWithType * decl, Mangle::Mode mode ) {
+	assert( mode == Mangle::Mode{} || mode == Mangle::Mode{ NoOverrideable } );
+	ast::DeclWithType::MangleCache & cache = decl->mangleCache;
+	bool noOverrideable = mode.no_overrideable;
+	bool & has = noOverrideable ? cache.hasNoOverrideable : cache.hasFull;
+	Symbol & name = noOverrideable ? cache.noOverrideable : cache.full;
+	if ( has ) {
+		++*cacheStats().saved;
+	} else {
+		++*cacheStats().computed;
+		name = mangle( decl, mode );
+		has = true;
+	}
+	return name;
+}
+
 } // namespace Mangle
 
 // Local Variables: //
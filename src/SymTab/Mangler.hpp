@@ -21,6 +21,7 @@
 #include <utility>            // for pair
 
 #include "AST/Bitfield.hpp"
+#include "Common/Symbol.hpp"
 
 // https://itanium-cxx-abi.github.io/cxx-abi/abi.html#mangling
 // The CFA name mangling scheme is based closely on the itanium C++ name mangling scheme, with the following key differences:
@@ -30,6 +31,7 @@
 // * Currently name compression is not implemented.
 
 namespace ast {
+	class DeclWithType;
 	class Node;
 }
 
@@ -61,6 +63,10 @@ using Mode = bitfield<mangle_flags>;
 /// Mangle declaration name.
 std::string mangle( const ast::Node * decl, Mode mode = {} );
 
+/// Mangle declaration name in the default or NoOverrideable mode, as the symbol table does. The
+/// result is kept on the declaration and reused until it is mutated or its cache is cleared.
+const Symbol & mangleCached( const ast::DeclWithType * decl, Mode mode = {} );
+
 /// Most common mangle configuration for types.
 static inline std::string mangleType( const ast::Node * type ) {
 	return mangle( type, { NoOverrideable | Type } );
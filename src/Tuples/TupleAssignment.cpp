@@ -369,7 +369,7 @@ void TupleAssignSpotter::match( TupleAssignSpotter::Matcher & matcher ) {
 		matcher.combineState( *cand );
 	}
 
-	crntFinder.candidates.emplace_back( std::make_shared< ResolvExpr::Candidate >(
+	crntFinder.candidates.emplace_back( ResolvExpr::makeCandidate(
 		new ast::TupleAssignExpr(
 			matcher.location, std::move( solved ), std::move( matcher.tmpDecls ) ),
 		std::move( matcher.env ), std::move( matcher.open ), std::move( matcher.need ),
@@ -25,69 +25,66 @@ namespace Validate {
 
 namespace {
 
-/// Check for dynamic (sized polymorphic) variadic assertions.
-struct VariadicAssertionCore final {
-	void checkAssertion( GenPoly::TypeVarMap const & typeVars,
-			ast::FunctionDecl const * assert ) {
-		if ( ast::FixedArgs != assert->type->isVarArgs
-				&& needsAdapter( assert->type, typeVars ) ) {
-			SemanticError( assert,
-				"Cannot assert a function that both has by-value polymorphic "
-				"parameters or return values, and also takes variadic (...) "
-				"parameters. Consider using a va_list parameter instead.\n" );
-		}
+void checkAssertion( GenPoly::TypeVarMap const & typeVars,
+		ast::FunctionDecl const * assert ) {
+	if ( ast::FixedArgs != assert->type->isVarArgs
+			&& needsAdapter( assert->type, typeVars ) ) {
+		SemanticError( assert,
+			"Cannot assert a function that both has by-value polymorphic "
+			"parameters or return values, and also takes variadic (...) "
+			"parameters. Consider using a va_list parameter instead.\n" );
 	}
+}
 
-	template<typename T>
-	void checkList(
-			GenPoly::TypeVarMap const & typeVars,
-			SemanticErrorException & errors,
-			std::vector<ast::ptr<T>> const & members ) {
-		for ( const ast::ptr<T> & member : members ) {
-			try {
-				if ( auto func = member.template as<ast::FunctionDecl>() ) {
-					checkAssertion( typeVars, func );
-				}
-			} catch ( SemanticErrorException & error ) {
-				errors.append( error );
+template<typename T>
+void checkList(
+		GenPoly::TypeVarMap const & typeVars,
+		SemanticErrorException & errors,
+		std::vector<ast::ptr<T>> const & members ) {
+	for ( const ast::ptr<T> & member : members ) {
+		try {
+			if ( auto func = member.template as<ast::FunctionDecl>() ) {
+				checkAssertion( typeVars, func );
 			}
+		} catch ( SemanticErrorException & error ) {
+			errors.append( error );
 		}
 	}
+}
 
-	void postvisit( ast::FunctionDecl const * decl ) {
-		GenPoly::TypeVarMap typeVars;
-		SemanticErrorException errors;
-		makeTypeVarMap( decl, typeVars );
-		checkList( typeVars, errors, decl->assertions );
-		errors.throwIfNonEmpty();
+void checkAggr( bool checkMembers,
+		ast::AggregateDecl const * decl ) {
+	SemanticErrorException errors;
+	GenPoly::TypeVarMap typeVars;
+	for ( auto & param : decl->params ) {
+		addToTypeVarMap( param, typeVars );
+		checkList( typeVars, errors, param->assertions );
 	}
+	if ( checkMembers ) checkList( typeVars, errors, decl->members );
+	errors.throwIfNonEmpty();
+}
 
-	void checkAggr( bool checkMembers,
-			ast::AggregateDecl const * decl ) {
-		SemanticErrorException errors;
-		GenPoly::TypeVarMap typeVars;
-		for ( auto & param : decl->params ) {
-			addToTypeVarMap( param, typeVars );
-			checkList( typeVars, errors, param->assertions );
-		}
-		if ( checkMembers ) checkList( typeVars, errors, decl->members );
-		errors.throwIfNonEmpty();
-	}
+} // namespace
 
-	void postvisit( ast::StructDecl const * decl ) {
-	checkAggr( false, decl );
-	}
+void VariadicAssertionCore::postvisit( ast::FunctionDecl const * decl ) {
+	GenPoly::TypeVarMap typeVars;
+	SemanticErrorException errors;
+	makeTypeVarMap( decl, typeVars );
+	checkList( typeVars, errors, decl->assertions );
+	errors.throwIfNonEmpty();
+}
 
-	void postvisit( ast::UnionDecl const * decl ) {
-		checkAggr( false, decl );
-	}
+void VariadicAssertionCore::postvisit( ast::StructDecl const * decl ) {
+	checkAggr( false, decl );
+}
 
-	void postvisit( ast::TraitDecl const * decl ) {
-		checkAggr( true, decl );
-	}
-};
+void VariadicAssertionCore::postvisit( ast::UnionDecl const * decl ) {
+	checkAggr( false, decl );
+}
 
-} // namespace
+void VariadicAssertionCore::postvisit( ast::TraitDecl const * decl ) {
+	checkAggr( true, decl );
+}
 
 void checkAssertions( ast::TranslationUnit & transUnit ) {
 	ast::Pass<VariadicAssertionCore>::run( transUnit );
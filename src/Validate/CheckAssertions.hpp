@@ -16,7 +16,11 @@
 #pragma once
 
 namespace ast {
+	class FunctionDecl;
+	class StructDecl;
+	class TraitDecl;
 	class TranslationUnit;
+	class UnionDecl;
 }
 
 namespace Validate {
@@ -24,4 +28,13 @@ namespace Validate {
 /// Checks for problems in an assertion list.
 void checkAssertions( ast::TranslationUnit & transUnit );
 
+/// Check for dynamic (sized polymorphic) variadic assertions.
+/// This only reads the tree, so it can be fused with most passes.
+struct VariadicAssertionCore final {
+	void postvisit( ast::FunctionDecl const * decl );
+	void postvisit( ast::StructDecl const * decl );
+	void postvisit( ast::UnionDecl const * decl );
+	void postvisit( ast::TraitDecl const * decl );
+};
+
 }
@@ -75,11 +75,11 @@ ast::EnumDecl const * EnumAndPointerDecayCore::previsit(
 	return mut;
 }
 
-template<typename Member>
+template<typename List>
 void fixFunctionList( CodeLocation const & location, bool isVarArgs,
-		std::vector<ast::ptr<Member>> & list ) {
+		List & list ) {
 	bool hasVoid = false;
-	for ( ast::ptr<Member> & member : list ) {
+	for ( auto & member : list ) {
 		member = SymTab::fixFunction( member, hasVoid );
 	}
 
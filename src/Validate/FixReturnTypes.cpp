@@ -23,13 +23,6 @@
 
 namespace Validate {
 
-namespace {
-
-struct ReturnTypeFixer final {
-	ast::FunctionDecl const * postvisit( ast::FunctionDecl const * decl );
-	ast::FunctionType const * postvisit( ast::FunctionType const * type );
-};
-
 ast::FunctionDecl const * ReturnTypeFixer::postvisit(
 		ast::FunctionDecl const * decl ) {
 	// TODO: It does not handle return values. This information needs to be
@@ -82,8 +75,6 @@ ast::FunctionType const * ReturnTypeFixer::postvisit(
 	return type;
 }
 
-} // namespace
-
 void fixReturnTypes( ast::TranslationUnit & translationUnit ) {
 	ast::Pass<ReturnTypeFixer>::run( translationUnit );
 }
@@ -16,6 +16,8 @@
 #pragma once
 
 namespace ast {
+    class FunctionDecl;
+    class FunctionType;
     class TranslationUnit;
 }
 
@@ -26,6 +28,12 @@ namespace Validate {
 /// Must happen before auto-gen.
 void fixReturnTypes( ast::TranslationUnit & translationUnit );
 
+/// The pass core, so the pipeline can fuse it with others (see ast::Fused).
+struct ReturnTypeFixer final {
+	ast::FunctionDecl const * postvisit( ast::FunctionDecl const * decl );
+	ast::FunctionType const * postvisit( ast::FunctionType const * type );
+};
+
 }
 
 // Local Variables: //
@@ -232,8 +232,10 @@ struct UniqueFixCore final {
 
 void decayForallPointers( ast::TranslationUnit & transUnit ) {
 	ast::Pass<TraitExpander>::run( transUnit );
-	ast::Pass<AssertionFunctionFixer>::run( transUnit );
-	ast::Pass<OperatorChecker>::run( transUnit );
+	// The fixer works on the assertions the expander produces, so they
+	// cannot share a walk, but the operator check reads nothing either
+	// of them changes.
+	ast::Pass<ast::Fused<AssertionFunctionFixer, OperatorChecker>>::run( transUnit );
 }
 
 void fixUniqueIds( ast::TranslationUnit & transUnit ) {
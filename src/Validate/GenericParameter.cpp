@@ -21,6 +21,7 @@
 #include "AST/Pass.hpp"
 #include "AST/TranslationUnit.hpp"
 #include "AST/Type.hpp"
+#include "AST/Vector.hpp"
 #include "Validate/NoIdSymbolTable.hpp"
 
 namespace Validate {
@@ -62,7 +63,7 @@ const InstType * validateGeneric(
 	// the substuition.
 
 	auto mutType = ast::mutate( type );
-	std::vector<ast::ptr<ast::Expr>> & args = mutType->params;
+	ast::vector<ast::Expr> & args = mutType->params;
 
 	// Quick check before we get into the real work.
 	if ( params.size() < args.size() ) {
@@ -125,40 +126,40 @@ bool isSizedPolymorphic( const ast::AggregateDecl * decl ) {
 	return false;
 }
 
-struct ValidateGenericParamsCore :
-		public ast::WithCodeLocation, public ast::WithGuards {
-	// Generic parameter filling and checks:
-	const ast::StructInstType * previsit( const ast::StructInstType * type ) {
-		assert( location );
-		return validateGeneric( *location, type );
-	}
+} // namespace
 
-	const ast::UnionInstType * previsit( const ast::UnionInstType * type ) {
-		assert( location );
-		return validateGeneric( *location, type );
-	}
+const ast::StructInstType * ValidateGenericParamsCore::previsit(
+		const ast::StructInstType * type ) {
+	assert( location );
+	return validateGeneric( *location, type );
+}
 
-	// Check parameter and bitfield combinations:
-	bool insideSized = false;
-	void previsit( const ast::StructDecl * decl ) {
-		if ( isSizedPolymorphic( decl ) && !insideSized ) {
-			GuardValue( insideSized ) = true;
-		}
+const ast::UnionInstType * ValidateGenericParamsCore::previsit(
+		const ast::UnionInstType * type ) {
+	assert( location );
+	return validateGeneric( *location, type );
+}
+
+void ValidateGenericParamsCore::previsit( const ast::StructDecl * decl ) {
+	if ( isSizedPolymorphic( decl ) && !insideSized ) {
+		GuardValue( insideSized ) = true;
 	}
+}
 
-	void previsit( const ast::UnionDecl * decl ) {
-		if ( isSizedPolymorphic( decl ) && !insideSized ) {
-			GuardValue( insideSized ) = true;
-		}
+void ValidateGenericParamsCore::previsit( const ast::UnionDecl * decl ) {
+	if ( isSizedPolymorphic( decl ) && !insideSized ) {
+		GuardValue( insideSized ) = true;
 	}
+}
 
-	void previsit( const ast::ObjectDecl * decl ) {
-		if ( insideSized && decl->bitfieldWidth ) {
-			SemanticError( decl->location, decl,
-				"Cannot have bitfields inside a sized polymorphic structure." );
-		}
+void ValidateGenericParamsCore::previsit( const ast::ObjectDecl * decl ) {
+	if ( insideSized && decl->bitfieldWidth ) {
+		SemanticError( decl->location, decl,
+			"Cannot have bitfields inside a sized polymorphic structure." );
 	}
-};
+}
+
+namespace {
 
 // --------------------------------------------------------------------------
 
@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include "AST/Pass.hpp"
+
 namespace ast {
 	class TranslationUnit;
 }
@@ -26,6 +28,21 @@ namespace Validate {
 /// Types and observed failing when attempted before eliminate typedef.
 void fillGenericParameters( ast::TranslationUnit & translationUnit );
 
+/// The core of fillGenericParameters, exposed so it can share a traversal
+/// with other passes.
+struct ValidateGenericParamsCore :
+		public ast::WithCodeLocation, public ast::WithGuards {
+	// Generic parameter filling and checks:
+	const ast::StructInstType * previsit( const ast::StructInstType * type );
+	const ast::UnionInstType * previsit( const ast::UnionInstType * type );
+
+	// Check parameter and bitfield combinations:
+	bool insideSized = false;
+	void previsit( const ast::StructDecl * decl );
+	void previsit( const ast::UnionDecl * decl );
+	void previsit( const ast::ObjectDecl * decl );
+};
+
 /// Replace dimension generic parameters with a fixed type of that size.
 void translateDimensionParameters( ast::TranslationUnit & translationUnit );
 
@@ -100,12 +100,12 @@ std::string qualifiedName( ast::AggregateDecl const * decl ) {
 	return ss.str();
 }
 
-void extendParams( ast::vector<ast::TypeDecl> & dstParams,
-		ast::vector<ast::TypeDecl> const & srcParams ) {
+void extendParams( std::vector<ast::ptr<ast::TypeDecl>> & dstParams,
+		std::vector<ast::ptr<ast::TypeDecl>> const & srcParams ) {
 	if ( srcParams.empty() ) return;
 
 	ast::DeclReplacer::TypeMap newToOld;
-	ast::vector<ast::TypeDecl> params;
+	std::vector<ast::ptr<ast::TypeDecl>> params;
 	for ( ast::ptr<ast::TypeDecl> const & srcParam : srcParams ) {
 		ast::TypeDecl * dstParam = ast::deepCopy( srcParam.get() );
 		dstParam->init = nullptr;
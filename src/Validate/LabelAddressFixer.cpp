@@ -36,7 +36,7 @@ struct LabelFinder {
 	}
 };
 
-struct LabelAddressFixer : public ast::WithGuards {
+struct LabelAddressFixer : public ast::WithGuards, public ast::SkipFrozenDecls {
 	std::set<ast::Label> labels;
 	void previsit( const ast::FunctionDecl * decl );
 	const ast::Expr * postvisit( const ast::AddressExpr * expr );
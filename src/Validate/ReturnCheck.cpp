@@ -24,7 +24,7 @@ namespace Validate {
 
 namespace {
 
-struct ReturnCore : public ast::WithGuards {
+struct ReturnCore : public ast::WithGuards, public ast::SkipFrozenDecls {
 	bool inVoidFunction = false;
 
 	void previsit( const ast::FunctionDecl * decl ) {
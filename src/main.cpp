@@ -21,20 +21,23 @@
 #include <cstdlib>                          // for exit, free, abort, EXIT_F...
 #include <csignal>                          // for signal, SIGABRT, SIGSEGV
 #include <cstring>                          // for index
-#include <fstream>                          // for ofstream
+#include <unistd.h>                         // for STDOUT_FILENO
 #include <iostream>                         // for operator<<, basic_ostream
 #include <iomanip>
 #include <iterator>                         // for back_inserter
 #include <list>                             // for list
 #include <string>                           // for char_traits, operator<<
 
+#include "AST/NodeArena.hpp"                // for enable, enabled
 #include "AST/Pass.hpp"                     // for pass_visitor_stats
 #include "AST/Print.hpp"                    // for printAll
 #include "AST/TranslationUnit.hpp"          // for TranslationUnit
 #include "AST/Util.hpp"                     // for checkInvariants
+#include "CompilationServer.hpp"           // for serve
 #include "CompilationState.hpp"
 #include "../config.h"                      // for CFA_LIBDIR
 #include "CodeGen/FixMain.hpp"              // for FixMain
+#include "CodeGen/FdStream.hpp"             // for FdStream
 #include "CodeGen/FixNames.hpp"             // for fixNames
 #include "CodeGen/Generate.hpp"             // for generate
 #include "CodeGen/LinkOnce.hpp"             // for translateLinkOnce
@@ -52,10 +55,11 @@
 #include "ControlStruct/ExceptTranslate.hpp"// for translateThrows, translat...
 #include "ControlStruct/FixLabels.hpp"      // for fixLabels
 #include "ControlStruct/HoistControlDecls.hpp" //  hoistControlDecls
-#include "ControlStruct/TranslateEnumRange.hpp" // translateEnumRange
+#include "ControlStruct/TranslateEnumRange.hpp" // TranslateEnumRangeCore
 #include "GenPoly/Box.hpp"                  // for box
 #include "GenPoly/InstantiateGeneric.hpp"   // for instantiateGeneric
 #include "GenPoly/Lvalue.hpp"               // for convertLvalue
+#include "GenPoly/Monomorphize.hpp"         // for monomorphize
 #include "GenPoly/Specialize.hpp"           // for convertSpecializations
 #include "InitTweak/FixInit.hpp"            // for fix
 #include "InitTweak/GenInit.hpp"            // for genInit
@@ -66,15 +70,15 @@
 #include "ResolvExpr/Resolver.hpp"          // for resolve
 #include "Tuples/Tuples.hpp"                // for expandMemberTuples, expan...
 #include "Validate/Autogen.hpp"             // for autogenerateRoutines
-#include "Validate/CheckAssertions.hpp"     // for checkAssertions
+#include "Validate/CheckAssertions.hpp"     // for VariadicAssertionCore
 #include "Validate/CompoundLiteral.hpp"     // for handleCompoundLiterals
 #include "Validate/EliminateTypedef.hpp"    // for eliminateTypedef
 #include "Validate/EnumAndPointerDecay.hpp" // for decayEnumsAndPointers
 #include "Validate/FindSpecialDecls.hpp"    // for findGlobalDecls
 #include "Validate/FixQualifiedTypes.hpp"   // for fixQualifiedTypes
-#include "Validate/FixReturnTypes.hpp"      // for fixReturnTypes
+#include "Validate/FixReturnTypes.hpp"      // for ReturnTypeFixer
 #include "Validate/ForallPointerDecay.hpp"  // for decayForallPointers
-#include "Validate/GenericParameter.hpp"    // for fillGenericParameters, tr...
+#include "Validate/GenericParameter.hpp"    // for ValidateGenericParamsCore...
 #include "Validate/HoistStruct.hpp"         // for hoistStruct
 #include "Validate/HoistTypeDecls.hpp"      // for hoistTypeDecls
 #include "Validate/ImplementEnumFunc.hpp"   // for implementEnumFunc
@@ -111,6 +115,12 @@ static void NewPass( const char * const name ) {
 		ast::checkInvariants(unit);         \
 	}
 
+// Passes that share a single traversal, see ast::Fused.
+using FixReturnTypesCheckAssertions = ast::Pass<ast::Fused<
+	Validate::ReturnTypeFixer, Validate::VariadicAssertionCore>>;
+using GenericParamsEnumRange = ast::Pass<ast::Fused<
+	Validate::ValidateGenericParamsCore, ControlStruct::TranslateEnumRangeCore>>;
+
 #define DUMP( cond, unit )                  \
 	if ( cond ) {                           \
 		dump( std::move( unit ) );          \
@@ -120,18 +130,53 @@ static void NewPass( const char * const name ) {
 static bool waiting_for_gdb = false;					// flag to set cfa-cpp to wait for gdb on start
 
 static string PreludeDirector = "";
+static const char * serverSocket = nullptr;				// serve translation requests on this socket
+static bool preludeLoaded = false;						// prelude already parsed by the server
+static bool translationOptions = false;					// options other than the prelude ones given
+static bool nodeArena = false;							// allocate AST nodes from an arena
+static bool monomorphizeAll = false;					// clone every polymorphic function for concrete calls
+static size_t monomorphizeBudget = 20000;				// AST nodes the clones may add
+static unsigned codegenJobs = 1;						// processes rendering the generated code
 
 static void parse_cmdline( int argc, char * argv[] );
+static bool acceptRequest( int argc, char * argv[] );
+static int translate( int argc, char * argv[] );
 static void dump( ast::TranslationUnit && transUnit, ostream & out = cout );
 
 static void backtrace( int start );
 static void initSignals();
 
-int main( int argc, char * argv[] ) {
-	FILE * input;										// use FILE rather than istream because yyin is FILE
-	ostream * output = & cout;
-	ast::TranslationUnit transUnit;
+static void loadPrelude() {
+	if ( ! nopreludep ) {								// include gcc builtins
+		// -l is for initial build ONLY and builtins.cf is not in the lib directory so access it here.
+
+		assertf( !PreludeDirector.empty(), "Can't find prelude without option --prelude-dir must be used." );
+
+		// Read to gcc builtins, if not generating the cfa library
+		FILE * gcc_builtins = fopen( (PreludeDirector + "/gcc-builtins.cfa").c_str(), "r" );
+		assertf( gcc_builtins, "cannot open gcc-builtins.cfa\n" );
+		parse( gcc_builtins, ast::Linkage::Compiler );
+
+		// read the extra prelude in, if not generating the cfa library
+		FILE * extras = fopen( (PreludeDirector + "/extras.cfa").c_str(), "r" );
+		assertf( extras, "cannot open extras.cfa\n" );
+		parse( extras, ast::Linkage::BuiltinC );
+		if ( ! libcfap ) {
+			// read the prelude in, if not generating the cfa library
+			FILE * prelude = fopen( (PreludeDirector + "/prelude.cfa").c_str(), "r" );
+			assertf( prelude, "cannot open prelude.cfa\n" );
+			parse( prelude, ast::Linkage::Intrinsic );
+
+			// Read to cfa builtins, if not generating the cfa library
+			FILE * builtins = fopen( (PreludeDirector + "/builtins.cfa").c_str(), "r" );
+			assertf( builtins, "cannot open builtins.cfa\n" );
+			parse( builtins, ast::Linkage::BuiltinCFA );
+		} // if
+	} // if
+	preludeLoaded = true;
+} // loadPrelude
 
+int main( int argc, char * argv[] ) {
 	initSignals();
 
 	// cout << "main" << endl;
@@ -148,6 +193,43 @@ int main( int argc, char * argv[] ) {
 		raise(SIGSTOP);
 	} // if
 
+	if ( nodeArena ) ast::NodeArena::enable();			// before any node is allocated
+
+	if ( serverSocket ) {
+		// Requests are parsed over the server's options, so it may only have the ones fixed for all requests.
+		if ( translationOptions || optind < argc ) {
+			cerr << "cfa-cpp --server takes only the prelude options --prelude-dir, -l, -n and --node-arena" << endl;
+			return EXIT_FAILURE;
+		} // if
+		// The prelude is parsed and built once, and each request is translated in a fork of this process.
+		loadPrelude();
+		prebuildUnit();
+		CompilationServer::serve( serverSocket, acceptRequest, translate ); // no return
+	} // if
+
+	return translate( argc, argv );
+} // main
+
+// Check a request to the server is compatible with the prelude it has parsed. The server is started with the prelude
+// options, the rest of the options are given with each request.
+static bool acceptRequest( int argc, char * argv[] ) {
+	const string serverPrelude = PreludeDirector;
+	const int serverNoPrelude = nopreludep, serverLibCfa = libcfap;
+	const bool serverNodeArena = nodeArena;
+
+	serverSocket = nullptr;
+	waiting_for_gdb = false;
+	optind = 0;											// (global) rescan from the start of the new command line
+	parse_cmdline( argc, argv );
+	return PreludeDirector == serverPrelude && nopreludep == serverNoPrelude && libcfap == serverLibCfa
+		&& nodeArena == serverNodeArena && ! serverSocket && ! waiting_for_gdb;
+} // acceptRequest
+
+static int translate( int argc, char * argv[] ) {
+	FILE * input;										// use FILE rather than istream because yyin is FILE
+	ostream * output = & cout;
+	ast::TranslationUnit transUnit;
+
 	try {
 		// choose to read the program from a file or stdin
 		if ( optind < argc ) {							// any commands after the flags ? => input file name
@@ -163,32 +245,7 @@ int main( int argc, char * argv[] ) {
 		Stats::Time::StartBlock("Parse");
 
 		// read in the builtins, extras, and the prelude
-		if ( ! nopreludep ) {							// include gcc builtins
-			// -l is for initial build ONLY and builtins.cf is not in the lib directory so access it here.
-
-			assertf( !PreludeDirector.empty(), "Can't find prelude without option --prelude-dir must be used." );
-
-			// Read to gcc builtins, if not generating the cfa library
-			FILE * gcc_builtins = fopen( (PreludeDirector + "/gcc-builtins.cfa").c_str(), "r" );
-			assertf( gcc_builtins, "cannot open gcc-builtins.cfa\n" );
-			parse( gcc_builtins, ast::Linkage::Compiler );
-
-			// read the extra prelude in, if not generating the cfa library
-			FILE * extras = fopen( (PreludeDirector + "/extras.cfa").c_str(), "r" );
-			assertf( extras, "cannot open extras.cfa\n" );
-			parse( extras, ast::Linkage::BuiltinC );
-			if ( ! libcfap ) {
-				// read the prelude in, if not generating the cfa library
-				FILE * prelude = fopen( (PreludeDirector + "/prelude.cfa").c_str(), "r" );
-				assertf( prelude, "cannot open prelude.cfa\n" );
-				parse( prelude, ast::Linkage::Intrinsic );
-
-				// Read to cfa builtins, if not generating the cfa library
-				FILE * builtins = fopen( (PreludeDirector + "/builtins.cfa").c_str(), "r" );
-				assertf( builtins, "cannot open builtins.cfa\n" );
-				parse( builtins, ast::Linkage::BuiltinCFA );
-			} // if
-		} // if
+		if ( ! preludeLoaded ) loadPrelude();
 
 		parse( input, libcfap ? ast::Linkage::Intrinsic : ast::Linkage::Cforall, yydebug );
 
@@ -204,8 +261,7 @@ int main( int argc, char * argv[] ) {
 		DUMP( exdeclp, transUnit );
 		PASS( "Verify Ctor, Dtor & Assign", Validate::verifyCtorDtorAssign, transUnit );
 		PASS( "Replace Typedefs", Validate::replaceTypedef, transUnit );
-		PASS( "Fix Return Types", Validate::fixReturnTypes, transUnit );
-		PASS( "Check Assertions", Validate::checkAssertions, transUnit );
+		PASS( "Fix Return Types, Check Assertions", FixReturnTypesCheckAssertions::run, transUnit );
 		PASS( "Enum and Pointer Decay", Validate::decayEnumsAndPointers, transUnit );
 
 		PASS( "Link Instance Types", Validate::linkInstanceTypes, transUnit );
@@ -214,8 +270,7 @@ int main( int argc, char * argv[] ) {
 		PASS( "Fix Qualified Types", Validate::fixQualifiedTypes, transUnit );
 		PASS( "Eliminate Typedef", Validate::eliminateTypedef, transUnit );
 		PASS( "Hoist Struct", Validate::hoistStruct, transUnit );
-		PASS( "Validate Generic Parameters", Validate::fillGenericParameters, transUnit );
-		PASS( "Translate Enum Range Expression", ControlStruct::translateEnumRange, transUnit );
+		PASS( "Validate Generic Parameters, Translate Enum Range Expression", GenericParamsEnumRange::run, transUnit );
 		PASS( "Translate Dimensions", Validate::translateDimensionParameters, transUnit );
 		PASS( "Generate Enum Attributes Functions", Validate::implementEnumFunc, transUnit );
 		PASS( "Check Function Returns", Validate::checkReturnStatements, transUnit );
@@ -286,6 +341,9 @@ int main( int argc, char * argv[] ) {
 		PASS( "Gen Waitfor", Concurrency::generateWaitFor, transUnit );
 		PASS( "Fix Main Linkage", CodeGen::fixMainLinkage, transUnit, !nomainp );
 
+		// Needs the inferred parameters before they are specialized.
+		PASS( "Monomorphize", GenPoly::monomorphize, transUnit, monomorphizeAll, monomorphizeBudget );
+
 		// Needs to happen before tuple types are expanded.
 		PASS( "Convert Specializations",  GenPoly::convertSpecializations, transUnit );
 
@@ -308,10 +366,13 @@ int main( int argc, char * argv[] ) {
 		DUMP( bcodegenp, transUnit );
 
 		if ( optind < argc ) {							// any commands after the flags and input file ? => output file name
-			output = new ofstream( argv[ optind ] );
+			output = new CodeGen::FdStream( argv[ optind ] );
+		} else {
+			cout.flush();
+			output = new CodeGen::FdStream( STDOUT_FILENO );
 		} // if
 
-		PASS( "Code Gen", CodeGen::generate, transUnit, *output, !genproto, prettycodegenp, true, linemarks, false );
+		PASS( "Code Gen", CodeGen::generate, transUnit, *output, !genproto, prettycodegenp, true, linemarks, false, codegenJobs );
 		CodeGen::fixMainInvoke( transUnit, *output, (PreludeDirector + "/bootloader.c").c_str() );
 
 		if ( output != &cout ) {
@@ -349,18 +410,23 @@ int main( int argc, char * argv[] ) {
 	// This pseudo-pass is used to get more accurate heap statistics.
 	NewPass("Clean-up");
 	Stats::Time::StartBlock("Clean-Up");
-	transUnit.global = ast::TranslationGlobal();
-	transUnit.decls.clear();
+	if ( ast::NodeArena::enabled() ) {
+		// The arena is released with the process, so the nodes are not destroyed one by one.
+		new ast::TranslationUnit( std::move( transUnit ) );
+	} else {
+		transUnit.global = ast::TranslationGlobal();
+		transUnit.decls.clear();
+	} // if
 	Stats::Time::StopBlock();
 
 	Stats::print();
 	return EXIT_SUCCESS;
-} // main
+} // translate
 
 
 static const char optstring[] = ":c:ghilLmNnpdP:S:twW:D:";
 
-enum { PreludeDir = 128 };
+enum { PreludeDir = 128, Server, NodeArena, Monomorphize, CodegenJobs };
 static struct option long_opts[] = {
 	{ "colors", required_argument, nullptr, 'c' },
 	{ "gdb", no_argument, nullptr, 'g' },
@@ -375,6 +441,10 @@ static struct option long_opts[] = {
 	{ "deterministic-out", no_argument, nullptr, 'd' },
 	{ "print", required_argument, nullptr, 'P' },
 	{ "prelude-dir", required_argument, nullptr, PreludeDir },
+	{ "server", required_argument, nullptr, Server },
+	{ "node-arena", no_argument, nullptr, NodeArena },
+	{ "monomorphize", optional_argument, nullptr, Monomorphize },
+	{ "codegen-jobs", required_argument, nullptr, CodegenJobs },
 	{ "statistics", required_argument, nullptr, 'S' },
 	{ "tree", no_argument, nullptr, 't' },
 	{ "", no_argument, nullptr, 0 },					// -w
@@ -397,6 +467,10 @@ static const char * description[] = {
 	"only print deterministic output",                  // -d
 	"print",											// -P
 	"<directory> prelude directory for debug/nodebug",	// no flag
+	"<socket> serve translation requests, parsing prelude once", // no flag
+	"allocate AST nodes from an arena, freed at exit",	// no flag
+	"[=<budget>] clone polymorphic functions for concrete calls, up to budget AST nodes", // no flag
+	"<jobs> render generated code in jobs processes",	// no flag
 	"<option-list> enable profiling information: counters, heap, time, all, none", // -S
 	"building cfa standard lib",						// -t
 	"",													// -w
@@ -440,7 +514,7 @@ static void usage( char * argv[] ) {
 	int i = 0, j = 1;									// j skips starting colon
 	for ( ; long_opts[i].name != 0 && optstring[j] != '\0'; i += 1, j += 1 ) {
 		if ( long_opts[i].name[0] != '\0' ) {			// hidden option, internal usage only
-			if ( strcmp( long_opts[i].name, "prelude-dir" ) != 0 ) { // flag
+			if ( long_opts[i].val < PreludeDir ) {		// flag
 				cout << "  -" << optstring[j] << ",";
 			} else {									// no flag
 				j -= 1;									// compensate
@@ -468,6 +542,9 @@ static void parse_cmdline( int argc, char * argv[] ) {
 	bool Wsuppress = false, Werror = false;
 	int c;
 	while ( (c = getopt_long( argc, argv, optstring, long_opts, nullptr )) != -1 ) {
+		if ( c != PreludeDir && c != Server && c != NodeArena && c != 'l' && c != 'n' && c != 'g' ) {
+			translationOptions = true;
+		} // if
 		switch ( c ) {
 		  case 'c':										// diagnostic colors
 			if ( strcmp( optarg, "always" ) == 0 ) {
@@ -520,6 +597,33 @@ static void parse_cmdline( int argc, char * argv[] ) {
 		  case PreludeDir:								// prelude directory for debug/nodebug, hidden
 			PreludeDirector = optarg;
 			break;
+		  case Server:									// serve translation requests
+			serverSocket = optarg;
+			break;
+		  case NodeArena:								// allocate AST nodes from an arena
+			nodeArena = true;
+			break;
+		  case Monomorphize:							// clone polymorphic functions for concrete calls
+			monomorphizeAll = true;
+			if ( optarg ) {
+				char * end;
+				monomorphizeBudget = strtoul( optarg, &end, 10 );
+				if ( *optarg == '\0' || *end != '\0' ) {
+					cout << "Invalid budget for --monomorphize " << optarg << endl;
+					goto Default;
+				} // if
+			} // if
+			break;
+		  case CodegenJobs:								// render generated code in several processes
+			{
+				char * end;
+				codegenJobs = strtoul( optarg, &end, 10 );
+				if ( *optarg == '\0' || *end != '\0' || 0 == codegenJobs ) {
+					cout << "Invalid number of jobs for --codegen-jobs " << optarg << endl;
+					goto Default;
+				} // if
+			}
+			break;
 		  case 'S':										// enable profiling information, argument comma separated list of names
 			Stats::parse_params( optarg );
 			break;
@@ -597,7 +701,7 @@ static void dump( ast::TranslationUnit && unit, std::ostream & out ) {
 
 	// May print as full dump or as code generation.
 	if ( codegenp ) {
-		CodeGen::generate( unit, out, !genproto, prettycodegenp, false, false, false );
+		CodeGen::generate( unit, out, !genproto, prettycodegenp, false, false, false, 1 );
 	} else {
 		ast::printAll( out, unit.decls );
 	}